@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+# Run all examples plus the load components for a fixed time, record a
+# performance report and, given a baseline, fail on regressions
+# (see docs/Segar_Benchmark.md section 24)
+# Usage: ./scripts/perf_check.sh [duration_s] [report.json] [baseline.json]
+# e.g. record a baseline, bump segar in depend_libs.txt, rebuild, then
+#   ./scripts/perf_check.sh 120 candidate.json baseline.json
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+DURATION="${1:-60}"
+REPORT="${2:-$SCRIPT_DIR/perf_report.json}"
+BASELINE="${3:-}"
+
+# Same lookup as start_all.sh
+if [ -z "${OUTPUT_DIR:-}" ]; then
+  if [ -d "$SCRIPT_DIR/topic_example" ]; then
+    OUTPUT_DIR="$SCRIPT_DIR"
+  elif [ -d "$SCRIPT_DIR/../topic_example" ]; then
+    OUTPUT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+  else
+    OUTPUT_DIR="$SCRIPT_DIR/../build_x86/output"
+  fi
+fi
+export OUTPUT_DIR
+
+stop_load() {
+  pkill -INT -f "mainboard.*load_(generator|sink).dag" 2>/dev/null || true
+  for _ in $(seq 1 50); do
+    pgrep -f "mainboard.*load_(generator|sink).dag" >/dev/null || return 0
+    sleep 0.1
+  done
+}
+stop_everything() {
+  "$SCRIPT_DIR/stop_all.sh" >/dev/null 2>&1 || true
+  stop_load
+}
+trap stop_everything EXIT
+
+"$SCRIPT_DIR/start_all.sh" "$OUTPUT_DIR"
+LOG_DIR="$(ls -d "$SCRIPT_DIR"/logs/run_* | sort | tail -n 1)"
+
+LOAD_DIR="$OUTPUT_DIR/component_example/load_component"
+if [ -f "$LOAD_DIR/scripts/launch.sh" ]; then
+  for role in sink generator; do
+    (cd "$LOAD_DIR" && exec ./scripts/launch.sh "$role") \
+      > "$LOG_DIR/run_all_load_${role}.log" 2>&1 &
+    sleep 0.3
+  done
+else
+  echo "Skip (not found): component_example/load_component"
+fi
+
+"$SCRIPT_DIR/perf_compare.py" record --duration "$DURATION" \
+  --logs "$LOG_DIR" -o "$REPORT"
+stop_everything
+echo "Report: $REPORT"
+
+if [ -n "$BASELINE" ]; then
+  "$SCRIPT_DIR/perf_compare.py" compare "$BASELINE" "$REPORT" \
+    -o "${REPORT%.json}_diff.json"
+fi
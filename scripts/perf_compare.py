@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+# Record the performance of the running examples into a JSON report and
+# compare two reports for regressions (see docs/Segar_Benchmark.md).
+#
+# Usage:
+#   ./scripts/perf_compare.py record --duration 60 --logs LOG_DIR \
+#       [--process name | --process name=pattern ...] -o report.json
+#   ./scripts/perf_compare.py compare baseline.json candidate.json \
+#       [--alpha 0.01] [--tolerance 5] [-o diff.json]
+#
+# record samples cpu and rss of every process each --interval and reads the
+# latency_budget and load_sink summaries the processes log meanwhile. Every
+# metric is a list of samples, so compare can run a Mann-Whitney U test per
+# metric and exits with 1 when a metric got significantly worse.
+
+import argparse
+import glob
+import json
+import math
+import os
+import platform
+import re
+import subprocess
+import sys
+import time
+
+# Processes of start_all.sh and the load components; names over 15
+# characters and mainboard DAGs are found by their command line.
+DEFAULT_PROCESSES = [
+    "topic_talker", "topic_listener", "service_server",
+    "service_client_sync", "service_client_async", "param_server",
+    "param_client", "action_server", "action_client_sync",
+    "action_client_async", "tasker",
+    "timer_component=mainboard.*timer.dag",
+    "common_component=mainboard.*common.dag",
+    "load_generator=mainboard.*load_generator.dag",
+    "load_sink=mainboard.*load_sink.dag",
+]
+
+
+def read_file(path, default=""):
+    try:
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return default
+
+
+# --- record -----------------------------------------------------------------
+
+def find_pids(pattern, exact):
+    cmd = ["pgrep", "-x" if exact else "-f", pattern]
+    out = subprocess.run(cmd, capture_output=True, text=True).stdout.split()
+    # -f also matches this script and the shell that started it.
+    return [int(p) for p in out
+            if int(p) not in (os.getpid(), os.getppid())]
+
+
+def process_sample(pids):
+    """(cpu ticks, rss kB) summed over the pids."""
+    ticks = rss = 0
+    for pid in pids:
+        line = read_file("/proc/%d/stat" % pid)
+        if not line:
+            continue
+        fields = line[line.rfind(")") + 2:].split()
+        # utime and stime, fields 14 and 15 of proc(5).
+        ticks += int(fields[11]) + int(fields[12])
+        for status in read_file("/proc/%d/status" % pid).splitlines():
+            if status.startswith("VmRSS:"):
+                rss += int(status.split()[1])
+    return ticks, rss
+
+
+# GLOG_colorlogtostderr colors warnings in the captured stderr.
+ANSI_COLOR = re.compile(r"\x1b\[[\d;]*m")
+GLOG_TIME = re.compile(r"^[IWEF]\d{4} (\d+):(\d+):([\d.]+)")
+LATENCY = re.compile(
+    r"latency_budget: stage=(\S+) .*latency_ms\{n=(\d+)[^}]*"
+    r"p50=([\d.]+)[^}]*p99=([\d.]+)")
+LOAD_SINK = re.compile(
+    r"load_sink: (\S+) (\S+) writer=(\d+) received=(\d+) lost=(\d+)")
+
+
+def log_offsets(logs):
+    return {path: os.path.getsize(path)
+            for path in glob.glob(os.path.join(logs, "*.log"))}
+
+
+def read_logs(logs, offsets, metrics):
+    """Latency windows and load_sink rates logged since `offsets`."""
+    received = {}
+    for path in glob.glob(os.path.join(logs, "*.log")):
+        with open(path, errors="replace") as f:
+            f.seek(offsets.get(path, 0))
+            for line in f:
+                line = ANSI_COLOR.sub("", line)
+                match = LATENCY.search(line)
+                if match and int(match.group(2)) > 0:
+                    stage = match.group(1)
+                    add(metrics, "latency.%s.p50_ms" % stage, "lower",
+                        float(match.group(3)))
+                    add(metrics, "latency.%s.p99_ms" % stage, "lower",
+                        float(match.group(4)))
+                    continue
+                match = LOAD_SINK.search(line)
+                stamp = GLOG_TIME.match(line)
+                if match and stamp:
+                    h, m, s = stamp.groups()
+                    seconds = int(h) * 3600 + int(m) * 60 + float(s)
+                    key = "%s.%s" % (match.group(1), match.group(2))
+                    writer = match.group(3)
+                    received.setdefault(key, {}).setdefault(
+                        writer, []).append(
+                            (seconds, int(match.group(4)),
+                             int(match.group(5))))
+    for key, writers in received.items():
+        lost = 0
+        for reports in writers.values():
+            for (t0, n0, _), (t1, n1, _) in zip(reports, reports[1:]):
+                if t1 > t0:
+                    add(metrics, "load.%s.rate_hz" % key, "higher",
+                        (n1 - n0) / (t1 - t0))
+            lost += reports[-1][2] - reports[0][2]
+        add(metrics, "load.%s.lost" % key, "lower", lost)
+
+
+def add(metrics, name, better, value):
+    metric = metrics.setdefault(name, {"better": better, "samples": []})
+    metric["samples"].append(round(value, 3))
+
+
+def segar_version():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+    for line in read_file(os.path.join(root, "depend_libs.txt")).splitlines():
+        name, _, version = line.partition(" ")
+        if name == "segar":
+            return version.strip()
+    return "unknown"
+
+
+def record(args):
+    processes = []
+    for item in args.process or DEFAULT_PROCESSES:
+        name, _, pattern = item.partition("=")
+        processes.append((name, pattern or name, not pattern))
+    hz = os.sysconf("SC_CLK_TCK")
+    metrics = {}
+    time.sleep(args.warmup)
+    offsets = log_offsets(args.logs) if args.logs else {}
+    pids = {name: find_pids(pattern, exact and len(pattern) <= 15)
+            for name, pattern, exact in processes}
+    missing = [name for name, found in pids.items() if not found]
+    if missing:
+        print("warning: not running: %s" % ", ".join(missing),
+              file=sys.stderr)
+    last = {name: process_sample(p) for name, p in pids.items()}
+    start = last_time = time.monotonic()
+    while time.monotonic() - start < args.duration:
+        time.sleep(args.interval)
+        now = time.monotonic()
+        for name, p in pids.items():
+            if not p:
+                continue
+            ticks, rss = process_sample(p)
+            cpu = 100.0 * (ticks - last[name][0]) / hz / (now - last_time)
+            add(metrics, "process.%s.cpu_pct" % name, "lower", cpu)
+            add(metrics, "process.%s.rss_kb" % name, "lower", rss)
+            last[name] = (ticks, rss)
+        last_time = now
+    if args.logs:
+        read_logs(args.logs, offsets, metrics)
+    report = {
+        "meta": {
+            "date": time.strftime("%Y-%m-%d %H:%M:%S"),
+            "host": platform.node(),
+            "machine": platform.machine(),
+            "segar": segar_version(),
+            "duration_s": args.duration,
+            "interval_s": args.interval,
+            "not_running": missing,
+        },
+        "metrics": metrics,
+    }
+    with (open(args.output, "w") if args.output else sys.stdout) as out:
+        json.dump(report, out, indent=2, sort_keys=True)
+        out.write("\n")
+
+
+# --- compare ----------------------------------------------------------------
+
+def median(values):
+    ordered = sorted(values)
+    n = len(ordered)
+    mid = n // 2
+    return ordered[mid] if n % 2 else (ordered[mid - 1] + ordered[mid]) / 2
+
+
+def mann_whitney(a, b):
+    """Two-sided p value of the Mann-Whitney U test, normal approximation
+    with tie and continuity correction."""
+    n1, n2 = len(a), len(b)
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(values)
+    ties = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    r1 = sum(r for r, (_, group) in zip(ranks, values) if group == 0)
+    u = r1 - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    sigma = math.sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))))
+    if sigma == 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2.0) - 0.5) / sigma
+    return math.erfc(max(z, 0.0) / math.sqrt(2))
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.candidate) as f:
+        candidate = json.load(f)
+    rows = []
+    regressions = 0
+    names = sorted(set(baseline["metrics"]) | set(candidate["metrics"]))
+    for name in names:
+        b = baseline["metrics"].get(name)
+        c = candidate["metrics"].get(name)
+        if b is None or c is None:
+            rows.append({"metric": name, "verdict": "missing in " +
+                         ("baseline" if b is None else "candidate")})
+            continue
+        mb, mc = median(b["samples"]), median(c["samples"])
+        change = 100.0 * (mc - mb) / mb if mb else (0.0 if mc == mb else
+                                                   math.inf)
+        worse = change > 0 if b["better"] == "lower" else change < 0
+        enough = min(len(b["samples"]),
+                     len(c["samples"])) >= args.min_samples
+        p = mann_whitney(b["samples"], c["samples"]) if enough else None
+        if abs(change) <= args.tolerance:
+            verdict = "same"
+        elif p is not None and p >= args.alpha:
+            verdict = "not significant"
+        elif p is None:
+            # Too few samples for the test, e.g. the lost counts.
+            verdict = "worse (untested)" if worse else "better (untested)"
+        else:
+            verdict = "worse" if worse else "better"
+        if verdict.startswith("worse") and (p is not None or
+                                            args.fail_untested):
+            regressions += 1
+        rows.append({"metric": name, "baseline": mb, "candidate": mc,
+                     "change_pct": (round(change, 1)
+                                    if math.isfinite(change) else None),
+                     "p": p,
+                     "verdict": verdict})
+    print("baseline: segar %s, %s" % (baseline["meta"]["segar"],
+                                      baseline["meta"]["date"]))
+    print("candidate: segar %s, %s" % (candidate["meta"]["segar"],
+                                       candidate["meta"]["date"]))
+    print("| metric | baseline | candidate | change | p | verdict |")
+    print("|---|---|---|---|---|---|")
+    for row in rows:
+        if "baseline" not in row:
+            print("| %s | - | - | - | - | %s |" % (row["metric"],
+                                                  row["verdict"]))
+            continue
+        print("| %s | %.2f | %.2f | %s | %s | %s |" % (
+            row["metric"], row["baseline"], row["candidate"],
+            "new" if row["change_pct"] is None else
+            "%+.1f%%" % row["change_pct"],
+            "-" if row["p"] is None else "%.4f" % row["p"], row["verdict"]))
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump({"alpha": args.alpha, "tolerance_pct": args.tolerance,
+                       "regressions": regressions, "metrics": rows},
+                      out, indent=2)
+            out.write("\n")
+    print("%d regression(s)" % regressions)
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Record and compare example performance reports.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("record", help="sample the running examples")
+    p.add_argument("--process", action="append",
+                   help="name, or name=pgrep -f pattern; repeat; default "
+                        "the processes of start_all.sh and load_component")
+    p.add_argument("--logs", help="directory of the *.log files to read")
+    p.add_argument("--warmup", type=float, default=5.0)
+    p.add_argument("--duration", type=float, default=60.0)
+    p.add_argument("--interval", type=float, default=1.0)
+    p.add_argument("-o", "--output")
+
+    p = sub.add_parser("compare", help="diff two reports")
+    p.add_argument("baseline")
+    p.add_argument("candidate")
+    p.add_argument("--alpha", type=float, default=0.01,
+                   help="significance level of the Mann-Whitney U test")
+    p.add_argument("--tolerance", type=float, default=5.0,
+                   help="median changes up to this percent are the same")
+    p.add_argument("--min-samples", type=int, default=5,
+                   help="fewer samples on a side skip the test")
+    p.add_argument("--fail-untested", action="store_true",
+                   help="also fail on untested metrics that got worse")
+    p.add_argument("-o", "--output")
+
+    args = parser.parse_args()
+    if args.command == "record":
+        record(args)
+        return 0
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,484 @@
+#!/usr/bin/env python3
+# Derive scheduler configurations (classic_conf groups, cpusets, real-time
+# threads) from the measured load of a set of DAG processes
+# (see docs/Segar_Benchmark.md).
+#
+# Usage:
+#   ./scripts/plan_affinity.py topology > topology.json
+#   ./scripts/plan_affinity.py profile --dag a.dag --dag b.dag \
+#       [--launch] [--duration 30] [--writes comp=/topic] -o profile.json
+#   ./scripts/plan_affinity.py plan profile.json [--topology topology.json] \
+#       [--cpuset 0-7] [--headroom 1.5] --output-dir sched/
+#   ./scripts/plan_affinity.py compare baseline.log candidate.log
+#
+# topology reads the cpu and cache layout of this machine, so a plan for an
+# Orin can be made on an x86 host from a topology.json taken on the Orin.
+
+import argparse
+import glob
+import json
+import math
+import os
+import re
+import signal
+import subprocess
+import sys
+import time
+
+SCHED_POLICIES = {0: "SCHED_OTHER", 1: "SCHED_FIFO", 2: "SCHED_RR",
+                  3: "SCHED_BATCH", 5: "SCHED_IDLE"}
+
+
+def parse_cpuset(text):
+    """'0-3,8' -> [0, 1, 2, 3, 8], the scheduler_conf cpuset syntax."""
+    cpus = []
+    for item in text.strip().split(","):
+        if not item:
+            continue
+        first, _, last = item.partition("-")
+        cpus.extend(range(int(first), int(last or first) + 1))
+    return cpus
+
+
+def format_cpuset(cpus):
+    """[0, 1, 2, 3, 8] -> '0-3,8'."""
+    ranges = []
+    for cpu in sorted(set(cpus)):
+        if ranges and ranges[-1][1] == cpu - 1:
+            ranges[-1][1] = cpu
+        else:
+            ranges.append([cpu, cpu])
+    return ",".join(str(a) if a == b else "%d-%d" % (a, b) for a, b in ranges)
+
+
+def read_file(path, default=""):
+    try:
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return default
+
+
+# --- topology ---------------------------------------------------------------
+
+def read_topology(root="/sys/devices/system/cpu"):
+    """Cpus with their SMT siblings, package and last level cache."""
+    online = parse_cpuset(read_file(root + "/online", "0"))
+    cpus = {}
+    for cpu in online:
+        base = "%s/cpu%d" % (root, cpu)
+        siblings = read_file(base + "/topology/thread_siblings_list")
+        llc_level = -1
+        llc = [cpu]
+        for index in glob.glob(base + "/cache/index*"):
+            if read_file(index + "/type") not in ("Unified", "Data"):
+                continue
+            level = int(read_file(index + "/level", "0"))
+            shared = read_file(index + "/shared_cpu_list")
+            if shared and level > llc_level:
+                llc_level = level
+                llc = parse_cpuset(shared)
+        cpus[cpu] = {
+            "siblings": parse_cpuset(siblings) if siblings else [cpu],
+            "package": int(read_file(
+                base + "/topology/physical_package_id", "0")),
+            "llc": llc,
+            "llc_level": llc_level,
+        }
+    return {"cpus": cpus}
+
+
+def cache_domains(topology, allowed):
+    """Lists of physical cores (lists of sibling cpus) per cache domain."""
+    cpus = {int(k): v for k, v in topology["cpus"].items()}
+    domains = {}
+    for cpu in sorted(cpus):
+        if cpu not in allowed:
+            continue
+        info = cpus[cpu]
+        key = (info["package"], tuple(info["llc"]))
+        core = [c for c in info["siblings"] if c in allowed]
+        cores = domains.setdefault(key, [])
+        if core not in cores:
+            cores.append(core)
+    return [domains[key] for key in sorted(domains)]
+
+
+# --- profile ----------------------------------------------------------------
+
+def parse_dag(path):
+    """Components of a DAG file: name, class and reader topics."""
+    with open(path) as f:
+        text = f.read()
+    components = []
+    for match in re.finditer(r"(timer_)?components\s*\{", text):
+        # The block ends at the matching brace.
+        depth = 0
+        for end in range(match.end() - 1, len(text)):
+            depth += {"{": 1, "}": -1}.get(text[end], 0)
+            if depth == 0:
+                break
+        block = text[match.end():end]
+        cls = re.search(r'component_class_name\s*:\s*"([^"]+)"', block)
+        name = re.search(r'inner_node_name\s*:\s*"([^"]+)"', block)
+        components.append({
+            "name": name.group(1) if name else (cls.group(1) if cls else
+                                                 "component%d" % len(
+                                                     components)),
+            "class": cls.group(1) if cls else "",
+            "reads": re.findall(
+                r'readers\s*\{[^}]*topic\s*:\s*"([^"]+)"', block),
+            "writes": [],
+        })
+    return components
+
+
+def thread_samples(pid):
+    """{tid: (name, cpu ticks, policy, rt priority)} of a process."""
+    samples = {}
+    for stat in glob.glob("/proc/%d/task/*/stat" % pid):
+        line = read_file(stat)
+        if not line:
+            continue
+        name = line[line.find("(") + 1:line.rfind(")")]
+        fields = line[line.rfind(")") + 2:].split()
+        # Fields 14, 15, 40 and 41 of proc(5), counted from field 3 here.
+        samples[int(stat.split("/")[4])] = (
+            name, int(fields[11]) + int(fields[12]),
+            SCHED_POLICIES.get(int(fields[38]), fields[38]), int(fields[37]))
+    return samples
+
+
+def find_process(dag):
+    out = subprocess.run(["pgrep", "-f",
+                          "mainboard.*" + re.escape(os.path.basename(dag))],
+                         capture_output=True, text=True).stdout.split()
+    pids = [int(p) for p in out if int(p) != os.getpid()]
+    return pids[0] if pids else None
+
+
+def profile(args):
+    writes = {}
+    for item in args.writes:
+        component, _, topics = item.partition("=")
+        writes.setdefault(component, []).extend(
+            t for t in topics.split(",") if t)
+    launched = []
+    processes = []
+    for dag in args.dag:
+        if args.launch:
+            proc = subprocess.Popen(["mainboard", "-d", dag],
+                                    stdout=subprocess.DEVNULL,
+                                    stderr=subprocess.DEVNULL)
+            launched.append(proc)
+            pid = proc.pid
+        else:
+            pid = find_process(dag)
+        if pid is None:
+            sys.exit("no process runs %s, start it or pass --launch" % dag)
+        processes.append({"dag": dag, "pid": pid,
+                          "name": os.path.splitext(os.path.basename(dag))[0],
+                          "components": parse_dag(dag)})
+    try:
+        time.sleep(args.warmup)
+        hz = os.sysconf("SC_CLK_TCK")
+        before = {p["pid"]: thread_samples(p["pid"]) for p in processes}
+        time.sleep(args.duration)
+        after = {p["pid"]: thread_samples(p["pid"]) for p in processes}
+    finally:
+        for proc in launched:
+            proc.send_signal(signal.SIGINT)
+        for proc in launched:
+            try:
+                proc.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+    for p in processes:
+        threads = []
+        for tid, (name, ticks, policy, prio) in after[p["pid"]].items():
+            old = before[p["pid"]].get(tid)
+            cpu = 100.0 * (ticks - (old[1] if old else 0)) / hz / args.duration
+            threads.append({"name": name, "tid": tid, "cpu_pct": round(cpu, 1),
+                            "policy": policy, "prio": prio})
+        p["threads"] = threads
+        p["cpu_pct"] = round(sum(t["cpu_pct"] for t in threads), 1)
+        # /proc has no per-coroutine time: the process load is split evenly
+        # unless --component-cpu says otherwise.
+        for c in p["components"]:
+            c["cpu_pct"] = round(p["cpu_pct"] / len(p["components"]), 1)
+            c["writes"] = writes.get(c["name"], [])
+    for item in args.component_cpu:
+        name, _, pct = item.partition("=")
+        for p in processes:
+            for c in p["components"]:
+                if c["name"] == name:
+                    c["cpu_pct"] = float(pct)
+    weights = dict(item.split("=") for item in args.topic_weight)
+    result = {"duration_s": args.duration, "processes": processes,
+              "topic_weights": {k: float(v) for k, v in weights.items()}}
+    with (open(args.output, "w") if args.output else sys.stdout) as out:
+        json.dump(result, out, indent=2)
+        out.write("\n")
+
+
+# --- plan -------------------------------------------------------------------
+
+def edges(processes, topic_weights):
+    """{(a, b): weight} between components joined by a topic."""
+    writers = {}
+    readers = {}
+    for p in processes:
+        for c in p["components"]:
+            for t in c.get("writes", []):
+                writers.setdefault(t, []).append(c["name"])
+            for t in c["reads"]:
+                readers.setdefault(t, []).append(c["name"])
+    result = {}
+    for topic, names in writers.items():
+        for a in names:
+            for b in readers.get(topic, []):
+                if a != b:
+                    key = tuple(sorted((a, b)))
+                    result[key] = result.get(key, 0.0) + \
+                        topic_weights.get(topic, 1.0)
+    return result
+
+
+def plan(args):
+    with open(args.profile) as f:
+        prof = json.load(f)
+    if args.topology:
+        with open(args.topology) as f:
+            topology = json.load(f)
+    else:
+        topology = read_topology()
+    all_cpus = sorted(int(c) for c in topology["cpus"])
+    allowed = set(parse_cpuset(args.cpuset) if args.cpuset else all_cpus)
+    domains = cache_domains(topology, allowed)
+
+    # Real-time threads first: each gets a physical core of its own, taken
+    # from the end so that the groups keep the low, contiguous cores. The
+    # SMT sibling stays idle so it cannot steal cycles from the thread.
+    rt_threads = []
+    for p in prof["processes"]:
+        seen = set()
+        for t in p["threads"]:
+            if t["policy"] in ("SCHED_FIFO", "SCHED_RR") and \
+                    t["name"] not in seen:
+                seen.add(t["name"])
+                rt_threads.append((p, t))
+    rt_cpu = {}
+    isolated = set()
+    for p, t in rt_threads:
+        domain = max((d for d in domains if d), key=len, default=None)
+        if domain is None or sum(len(c) for d in domains for c in d) <= 1:
+            print("warning: no core left to isolate %s of %s" %
+                  (t["name"], p["name"]), file=sys.stderr)
+            continue
+        core = domain.pop()
+        rt_cpu[(p["name"], t["name"])] = core[0]
+        isolated.update(core)
+
+    # Components joined by the heaviest topics share a group as long as the
+    # group fits one cache domain.
+    demand = {}
+    owner = {}
+    for p in prof["processes"]:
+        for c in p["components"]:
+            demand[c["name"]] = max(
+                1, math.ceil(c["cpu_pct"] / 100.0 * args.headroom))
+            owner[c["name"]] = p["name"]
+    capacity = max((sum(len(c) for c in d) for d in domains), default=0)
+    cluster = {name: [name] for name in demand}
+    for (a, b), _ in sorted(edges(prof["processes"],
+                                  prof.get("topic_weights", {})).items(),
+                            key=lambda item: -item[1]):
+        ca, cb = cluster[a], cluster[b]
+        if ca is cb or owner[a] != owner[b]:
+            # Groups belong to one process; the cpus of groups in different
+            # processes are still placed next to each other below.
+            continue
+        if sum(demand[n] for n in ca + cb) <= capacity:
+            ca.extend(cb)
+            for n in cb:
+                cluster[n] = ca
+    groups = []
+    for members in cluster.values():
+        if members not in groups:
+            groups.append(members)
+
+    # Order the groups so that communicating ones are adjacent, then fill
+    # the cache domains core by core.
+    links = edges(prof["processes"], prof.get("topic_weights", {}))
+
+    def affinity(g, h):
+        return sum(links.get(tuple(sorted((a, b))), 0.0)
+                   for a in g for b in h)
+    ordered = [max(groups, key=lambda g: sum(demand[n] for n in g))]
+    rest = [g for g in groups if g is not ordered[0]]
+    while rest:
+        nxt = max(rest, key=lambda g: (affinity(ordered[-1], g),
+                                       sum(demand[n] for n in g)))
+        ordered.append(nxt)
+        rest.remove(nxt)
+    cores = [core for d in domains for core in d]
+    placed = []
+    for g in ordered:
+        need = sum(demand[n] for n in g)
+        cpus = []
+        while cores and len(cpus) < need:
+            cpus.extend(cores.pop(0))
+        if len(cpus) < need:
+            print("warning: group of %s needs %d cpus, only %d left" %
+                  (",".join(g), need, len(cpus)), file=sys.stderr)
+            if not cpus:
+                cpus = sorted(allowed - isolated)
+        placed.append((g, cpus))
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    shared = sorted(allowed - isolated)
+    for p in prof["processes"]:
+        path = os.path.join(args.output_dir, p["name"] + "_sched.conf")
+        with open(path, "w") as out:
+            out.write(render(p, [(g, c) for g, c in placed
+                                 if owner[g[0]] == p["name"]],
+                             rt_cpu, shared, args))
+        print("%s: %s" % (p["name"], path))
+
+
+def render(process, groups, rt_cpu, shared, args):
+    lines = [
+        "# Generated by scripts/plan_affinity.py from %s" % args.profile,
+        "scheduler_conf {",
+        '    policy: "classic"',
+        '    process_level_cpuset: "%s"' % format_cpuset(shared),
+    ]
+    # The conf matches threads by name, so same-named tids such as the
+    # shm_disp threads get one entry, the one the placement used.
+    threads = []
+    for t in process["threads"]:
+        if (process["name"], t["name"]) in rt_cpu and \
+                t["name"] not in (u["name"] for u in threads):
+            threads.append(t)
+    if threads:
+        lines.append("    threads: [")
+        entries = []
+        for t in threads:
+            entries.append(
+                "{\n"
+                '            name: "%s"\n'
+                '            cpuset: "%d"\n'
+                '            policy: "%s"\n'
+                "            prio: %d\n"
+                "        }" % (t["name"], rt_cpu[(process["name"], t["name"])],
+                              t["policy"], t["prio"]))
+        lines.append("        " + ", ".join(entries))
+        lines.append("    ]")
+    lines.append("    classic_conf {")
+    lines.append("        groups: [")
+    entries = []
+    for index, (members, cpus) in enumerate(groups):
+        tasks = ", ".join(
+            '{\n                    name: "%s"\n'
+            "                    prio: 0\n                }" % name
+            for name in members)
+        entries.append(
+            "{\n"
+            '                name: "%s_group%d"\n'
+            "                processor_num: %d\n"
+            '                affinity: "range"\n'
+            '                cpuset: "%s"\n'
+            '                processor_policy: "SCHED_OTHER"\n'
+            "                processor_prio: 0\n"
+            "                tasks: [%s]\n"
+            "            }" % (process["name"], index + 1, len(cpus),
+                              format_cpuset(cpus), tasks))
+    lines.append("            " + ", ".join(entries))
+    lines.append("        ]")
+    lines.append("    }")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+# --- compare ----------------------------------------------------------------
+
+P99 = re.compile(
+    r"latency_budget: stage=(\S+) .*latency_ms\{[^}]*p99=([\d.]+)")
+
+
+def read_p99(path):
+    """Worst p99 per stage from the latency_budget summaries of a log."""
+    worst = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            match = P99.search(line)
+            if match:
+                stage, p99 = match.group(1), float(match.group(2))
+                worst[stage] = max(worst.get(stage, 0.0), p99)
+    return worst
+
+
+def compare(args):
+    baseline = read_p99(args.baseline)
+    candidate = read_p99(args.candidate)
+    print("| stage | baseline p99 ms | planned p99 ms | change |")
+    print("|---|---|---|---|")
+    for stage in sorted(set(baseline) | set(candidate)):
+        b = baseline.get(stage)
+        c = candidate.get(stage)
+        change = "%+.1f%%" % (100.0 * (c - b) / b) if b and c else "-"
+        print("| %s | %s | %s | %s |" % (
+            stage, "-" if b is None else "%.2f" % b,
+            "-" if c is None else "%.2f" % c, change))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Derive scheduler configs from measured load.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("topology", help="dump the cpu and cache layout")
+    p.add_argument("--sysfs", default="/sys/devices/system/cpu")
+
+    p = sub.add_parser("profile", help="measure a set of DAG processes")
+    p.add_argument("--dag", action="append", required=True,
+                   help="DAG file, one process each; repeat")
+    p.add_argument("--launch", action="store_true",
+                   help="start each DAG with mainboard -d instead of "
+                        "attaching to the running process")
+    p.add_argument("--warmup", type=float, default=5.0)
+    p.add_argument("--duration", type=float, default=30.0)
+    p.add_argument("--writes", action="append", default=[],
+                   help="component=topic[,topic]: topics a component writes")
+    p.add_argument("--topic-weight", action="append", default=[],
+                   help="topic=weight, e.g. MB/s; default 1")
+    p.add_argument("--component-cpu", action="append", default=[],
+                   help="component=percent, overrides the even split")
+    p.add_argument("-o", "--output")
+
+    p = sub.add_parser("plan", help="emit scheduler configs from a profile")
+    p.add_argument("profile")
+    p.add_argument("--topology", help="topology.json of the target machine")
+    p.add_argument("--cpuset", help="cpus the plan may use, default all")
+    p.add_argument("--headroom", type=float, default=1.5,
+                   help="cpus per measured cpu a group gets")
+    p.add_argument("--output-dir", default=".")
+
+    p = sub.add_parser("compare", help="p99 per stage of two runs")
+    p.add_argument("baseline", help="log of the run with the old config")
+    p.add_argument("candidate", help="log of the run with the plan")
+
+    args = parser.parse_args()
+    if args.command == "topology":
+        json.dump(read_topology(args.sysfs), sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    elif args.command == "profile":
+        profile(args)
+    elif args.command == "plan":
+        plan(args)
+    else:
+        compare(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env bash
+# Top-like view of the threads of a Segar process: CPU usage, last cpu,
+# cpu migrations and context switches per thread, plus the per-routine table
+# the process dumps through example::common::TaskStats (see
+# docs/Segar_Benchmark.md).
+# Usage: ./scripts/sched_top.sh <pid|process name> [interval_s] [count]
+#   count 0 (default) refreshes until interrupted
+
+set -e
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <pid|process name> [interval_s] [count]"
+  exit 1
+fi
+TARGET=$1
+INTERVAL=${2:-2}
+COUNT=${3:-0}
+
+if [[ "$TARGET" =~ ^[0-9]+$ ]]; then
+  PID=$TARGET
+elif [ ${#TARGET} -gt 15 ]; then
+  # Linux comm is limited to 15 chars; use `pgrep -f` for longer names
+  PID=$(pgrep -f "$TARGET" | head -n 1 || true)
+else
+  PID=$(pgrep -x "$TARGET" | head -n 1 || true)
+fi
+if [ -z "$PID" ] || [ ! -d "/proc/$PID" ]; then
+  echo "No process $TARGET"
+  exit 1
+fi
+HZ=$(getconf CLK_TCK)
+
+# tid name ticks last_cpu migrations vcsw nvcsw, one line per thread
+sample() {
+  local task tid line name rest ticks cpu migr vcsw nvcsw
+  for task in /proc/$PID/task/*; do
+    tid=${task##*/}
+    line=$(cat "$task/stat" 2>/dev/null) || continue
+    # The name may contain spaces; fields follow the last ')'
+    name=${line#*(}
+    name=${name%)*}
+    rest=${line##*) }
+    read -r ticks cpu <<<"$(echo "$rest" |
+      awk '{ print $12 + $13, $37 }')"
+    migr=$(awk -F: '/^se.nr_migrations/ { print $2 + 0 }' \
+      "$task/sched" 2>/dev/null || true)
+    vcsw=$(awk '/^voluntary_ctxt_switches/ { print $2 }' "$task/status" \
+      2>/dev/null || echo 0)
+    nvcsw=$(awk '/^nonvoluntary_ctxt_switches/ { print $2 }' \
+      "$task/status" 2>/dev/null || echo 0)
+    echo "$tid ${name// /_} $ticks $cpu ${migr:--1} ${vcsw:-0} ${nvcsw:-0}"
+  done
+}
+
+iteration=0
+before=$(sample)
+while [ -d "/proc/$PID" ]; do
+  sleep "$INTERVAL"
+  [ -d "/proc/$PID" ] || break
+  after=$(sample)
+  [ -t 1 ] && clear
+  echo "pid $PID ($(cat /proc/$PID/comm 2>/dev/null)) every ${INTERVAL}s," \
+    "$(date +%H:%M:%S)"
+  # Join the two samples on tid and print the deltas, busiest first
+  awk -v hz="$HZ" -v interval="$INTERVAL" '
+    NR == FNR { ticks[$1] = $3; migr[$1] = $5; vcsw[$1] = $6;
+                nvcsw[$1] = $7; next }
+    {
+      cpu = ($1 in ticks) ? 100.0 * ($3 - ticks[$1]) / hz / interval : 0
+      m = ($5 < 0) ? "-" : $5 - (($1 in migr) ? migr[$1] : 0)
+      printf "%-16s %7d %6.1f %8d %5s %6d %6d\n", $2, $1, cpu, $4, m,
+             $6 - vcsw[$1], $7 - nvcsw[$1]
+    }' <(echo "$before") <(echo "$after") |
+    sort -k3 -n -r |
+    { printf "%-16s %7s %6s %8s %5s %6s %6s\n" THREAD TID CPU% LAST_CPU \
+        MIGR VCSW NVCSW; cat; }
+  stats="/tmp/segar_task_stats.$PID"
+  if [ -f "$stats" ]; then
+    echo ""
+    echo "routines ($(stat -c %y "$stats" | cut -d. -f1)):"
+    sed -n '/^ROUTINE/,/^THREAD/p' "$stats" | sed '$d'
+  fi
+  before=$after
+  iteration=$((iteration + 1))
+  if [ "$COUNT" -gt 0 ] && [ "$iteration" -ge "$COUNT" ]; then
+    break
+  fi
+done
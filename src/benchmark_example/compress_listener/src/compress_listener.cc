@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Remote side of the compression benchmark: subscribes to the compressed
+// copy published by compress_talker, decompresses and decodes it and reports
+// the effective (uncompressed) throughput, the wire throughput and the
+// latency from publishing to decoded message.
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/compression.h"
+#include "common/example_pod_layouts.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Compressed.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/sensor", "topic of compress_talker");
+DEFINE_string(message, "payload", "type sent: payload, string, camera_info");
+DEFINE_string(label, "", "run description written to the report");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+DEFINE_string(output, "",
+              "markdown table the results are appended to on shutdown");
+
+namespace {
+
+struct Stats {
+  example::common::LatencyHistogram latency;
+  uint64_t messages = 0;
+  uint64_t lost = 0;
+  uint64_t corrupted = 0;
+  uint64_t raw_bytes = 0;
+  uint64_t wire_bytes = 0;
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  uint32_t next_seq = 0;
+
+  double Seconds() const { return (last_ns - first_ns) / 1e9; }
+  double RawMBps() const {
+    return Seconds() > 0 ? raw_bytes / (1024.0 * 1024.0) / Seconds() : 0.0;
+  }
+  double WireMBps() const {
+    return Seconds() > 0 ? wire_bytes / (1024.0 * 1024.0) / Seconds() : 0.0;
+  }
+  double Ratio() const {
+    return raw_bytes > 0 ? static_cast<double>(wire_bytes) / raw_bytes : 1.0;
+  }
+};
+
+template <typename T>
+bool DecodeAs(const std::vector<uint8_t>& raw) {
+  T msg;
+  return example::common::PodDecode(raw.data(), raw.size(), &msg) ==
+         raw.size();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0, EXIT_FAILURE);
+  bool (*decode)(const std::vector<uint8_t>&) = nullptr;
+  if (FLAGS_message == "payload") {
+    decode = DecodeAs<example::msg::Payload>;
+  } else if (FLAGS_message == "string") {
+    decode = DecodeAs<example::msg::String>;
+  } else if (FLAGS_message == "camera_info") {
+    decode = DecodeAs<example::msg::CameraInfo>;
+  }
+  RETURN_VAL_IF(decode == nullptr, EXIT_FAILURE);
+
+  std::mutex mutex;
+  Stats stats;
+  auto node = rti::segar::CreateNode("compress_listener");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto reader = node->CreateReader<example::msg::Compressed>(
+      FLAGS_topic + "/compressed",
+      [&](const std::shared_ptr<example::msg::Compressed>& msg) {
+        thread_local std::vector<uint8_t> raw;
+        const bool ok = example::common::Decompress(*msg, &raw) && decode(raw);
+        const uint64_t now = example::common::MonotonicNs();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok) {
+          ++stats.corrupted;
+          return;
+        }
+        if (stats.messages == 0) {
+          stats.first_ns = now;
+        } else if (msg->sequence_number() > stats.next_seq) {
+          stats.lost += msg->sequence_number() - stats.next_seq;
+        }
+        stats.next_seq = msg->sequence_number() + 1;
+        ++stats.messages;
+        stats.raw_bytes += msg->raw_size();
+        stats.wire_bytes += msg->data().size();
+        stats.last_ns = now;
+        stats.latency.Record(now - msg->timestamp());
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  auto report = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    AINFO << "compress_listener: messages=" << stats.messages
+          << " lost=" << stats.lost << " corrupted=" << stats.corrupted
+          << " effective_MB/s=" << stats.RawMBps()
+          << " wire_MB/s=" << stats.WireMBps() << " ratio=" << stats.Ratio()
+          << " latency_ms{" << stats.latency.Summary(1e6) << "}";
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  report();
+
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    std::ofstream output(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| run | messages | lost | effective MB/s | wire MB/s "
+                "| ratio | p50 ms | p99 ms | max ms |\n"
+             << "|---|---|---|---|---|---|---|---|---|\n";
+    }
+    output.setf(std::ios::fixed);
+    output.precision(2);
+    std::lock_guard<std::mutex> lock(mutex);
+    output << "| " << FLAGS_label << " | " << stats.messages << " | "
+           << stats.lost << " | " << stats.RawMBps() << " | "
+           << stats.WireMBps() << " | " << stats.Ratio() << " | "
+           << stats.latency.Percentile(50) / 1e6 << " | "
+           << stats.latency.Percentile(99) / 1e6 << " | "
+           << stats.latency.max() / 1e6 << " |\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Run the compression benchmark with compression off, on and adaptive for
+# the example message types
+# Usage: ./scripts/run_matrix.sh [bandwidth_mbps] [seconds_per_run]
+# The results are collected in compress_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+LISTENER_LAUNCH="$SCRIPT_DIR/../../compress_listener/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../compress_report.md"
+BANDWIDTH_MBPS="${1:-100}"
+SECONDS_PER_RUN="${2:-20}"
+
+if [ ! -f "$LISTENER_LAUNCH" ]; then
+  echo "Error: compress_listener not found: $LISTENER_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+# The listener writes its row when it shuts down
+stop_listener() {
+  pkill -INT -x compress_listener 2>/dev/null || true
+  while pgrep -x compress_listener > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_listener EXIT
+
+# message:content:bytes
+for workload in payload:depth:1048576 payload:random:1048576 \
+                string:text:65536 camera_info:text:4096; do
+  IFS=: read -r message content bytes <<< "$workload"
+  for compression in off on adaptive; do
+    label="$message $content ${bytes}B $compression ${BANDWIDTH_MBPS}MB/s"
+    echo "--- $label"
+    bash "$LISTENER_LAUNCH" --message=$message --label="$label" \
+      --output="$REPORT" > /dev/null 2>&1 &
+    timeout -s INT "$SECONDS_PER_RUN" bash "$SCRIPT_DIR/launch.sh" \
+      --message=$message --content=$content --bytes=$bytes \
+      --compression=$compression --bandwidth_mbps=$BANDWIDTH_MBPS || true
+    stop_listener
+  done
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
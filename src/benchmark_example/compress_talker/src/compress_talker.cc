@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Publisher of the compression benchmark: writes an example message type
+// through CompressingWriter and sends the compressed copy over an emulated
+// link with a bandwidth cap, as a remote subscriber would receive it.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/compression.h"
+#include "common/example_pod_layouts.h"
+#include "common/proc_stats.h"
+#include "common/token_bucket.h"
+#include "example/msg/Compressed.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/sensor",
+              "local topic, the link publishes on <topic>/compressed");
+DEFINE_string(message, "payload", "type sent: payload, string, camera_info");
+DEFINE_string(content, "depth",
+              "payload data: depth (16-bit depth image), text or random");
+DEFINE_uint32(bytes, 1048576, "message size");
+DEFINE_uint32(rate_hz, 30, "publish rate, at most 1000");
+DEFINE_string(compression, "adaptive", "off, on or adaptive");
+DEFINE_uint32(threshold_bytes, 4096, "smaller messages are not compressed");
+DEFINE_double(max_ratio, 0.9, "adaptive: worst ratio still compressed");
+DEFINE_uint32(probe_interval, 32,
+              "adaptive: messages sent uncompressed after a poor ratio");
+DEFINE_uint32(compress_queue, 8,
+              "messages waiting for compression before dropping the oldest");
+DEFINE_uint32(bandwidth_mbps, 100, "emulated link rate in MB/s, 0 unlimited");
+DEFINE_uint32(link_queue, 8, "messages queued on the link before dropping");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+
+namespace {
+
+// Link between the writer and the remote readers: a bounded queue drained
+// at the token bucket rate, dropping the oldest message when full.
+class LinkEmulator {
+ public:
+  LinkEmulator(std::shared_ptr<rti::segar::Writer<example::msg::Compressed>>
+                   writer,
+               uint64_t bytes_per_s, size_t queue_limit)
+      : writer_(std::move(writer)),
+        bucket_(bytes_per_s, 64 * 1024),
+        queue_limit_(queue_limit),
+        thread_([this]() { Run(); }) {}
+
+  ~LinkEmulator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  bool Push(const std::shared_ptr<example::msg::Compressed>& msg) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.size() >= queue_limit_) {
+        queue_.pop_front();
+        ++dropped_;
+      }
+      queue_.push_back(msg);
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+  uint64_t dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+  uint64_t wire_bytes() const { return wire_bytes_.load(); }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::shared_ptr<example::msg::Compressed> msg;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) {
+          return;
+        }
+        msg = queue_.front();
+        queue_.pop_front();
+      }
+      bucket_.Acquire(msg->data().size());
+      wire_bytes_.fetch_add(msg->data().size());
+      writer_->Write(msg);
+    }
+  }
+
+  std::shared_ptr<rti::segar::Writer<example::msg::Compressed>> writer_;
+  example::common::TokenBucket bucket_;
+  const size_t queue_limit_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<example::msg::Compressed>> queue_;
+  uint64_t dropped_ = 0;
+  bool stop_ = false;
+  std::atomic<uint64_t> wire_bytes_{0};
+  std::thread thread_;
+};
+
+std::string MakeText(size_t size, std::mt19937* rng) {
+  static const char* const kWords[] = {"camera", "lidar", "frame", "ok",
+                                       "timeout", "sync",  "drop",  "0.25"};
+  std::string text;
+  text.reserve(size + 16);
+  while (text.size() < size) {
+    text += kWords[(*rng)() % 8];
+    text += (*rng)() % 8 == 0 ? '\n' : ' ';
+  }
+  text.resize(size);
+  return text;
+}
+
+void FillData(const std::string& content, size_t size, std::mt19937* rng,
+              std::vector<uint8_t>* data) {
+  data->resize(size);
+  if (content == "text") {
+    const std::string text = MakeText(size, rng);
+    data->assign(text.begin(), text.end());
+  } else if (content == "random") {
+    for (auto& byte : *data) {
+      byte = static_cast<uint8_t>((*rng)());
+    }
+  } else {
+    // Depth image: smooth 16-bit surfaces with sensor noise in the low bits.
+    for (size_t i = 0; i + 1 < size; i += 2) {
+      const size_t x = (i / 2) % 640;
+      const size_t y = (i / 2) / 640;
+      const auto depth =
+          static_cast<uint16_t>(1000 + x / 4 + y / 8 + (*rng)() % 4);
+      (*data)[i] = static_cast<uint8_t>(depth);
+      (*data)[i + 1] = static_cast<uint8_t>(depth >> 8);
+    }
+  }
+}
+
+template <typename T>
+int Run(const std::shared_ptr<rti::segar::Node>& node,
+        const example::common::CompressionConfig& config,
+        std::function<std::shared_ptr<T>()> make_msg) {
+  auto link_writer = node->CreateWriter<example::msg::Compressed>(
+      FLAGS_topic + "/compressed");
+  RETURN_VAL_IF(!link_writer, EXIT_FAILURE);
+  // Shared with the compression tasks, which may still run at shutdown.
+  auto link = std::make_shared<LinkEmulator>(
+      link_writer, static_cast<uint64_t>(FLAGS_bandwidth_mbps) * 1024 * 1024,
+      FLAGS_link_queue);
+  example::common::CompressingWriter<T> writer(
+      node, FLAGS_topic, config,
+      [link](const std::shared_ptr<example::msg::Compressed>& msg) {
+        return link->Push(msg);
+      });
+  RETURN_VAL_IF(!writer.IsValid(), EXIT_FAILURE);
+
+  uint32_t seq = 0;
+  const uint32_t report_every =
+      std::max<uint32_t>(1, FLAGS_report_interval_s * FLAGS_rate_hz);
+  auto callback = [&]() {
+    auto msg = make_msg();
+    writer.Write(msg, example::common::MonotonicNs(), seq++);
+    if (seq % report_every == 0) {
+      AINFO << "compress_talker: sent=" << seq
+            << " wire_MB=" << link->wire_bytes() / (1024.0 * 1024.0)
+            << " link_dropped=" << link->dropped() << " " << writer.Stats();
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(1000 / FLAGS_rate_hz,
+                                                   callback, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  timer->Stop();
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rate_hz == 0 || FLAGS_rate_hz > 1000, EXIT_FAILURE);
+
+  example::common::CompressionConfig config;
+  config.threshold_bytes = FLAGS_threshold_bytes;
+  config.probe_interval = FLAGS_probe_interval;
+  config.max_queued = FLAGS_compress_queue;
+  if (FLAGS_compression == "off") {
+    config.codec = example::common::Codec::kNone;
+  } else if (FLAGS_compression == "on") {
+    config.max_ratio = 1.0;
+  } else if (FLAGS_compression == "adaptive") {
+    config.max_ratio = FLAGS_max_ratio;
+  } else {
+    AERROR << "unknown --compression: " << FLAGS_compression;
+    return EXIT_FAILURE;
+  }
+
+  auto node = rti::segar::CreateNode("compress_talker");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  std::mt19937 rng(1);
+  if (FLAGS_message == "payload") {
+    return Run<example::msg::Payload>(node, config, [&rng]() {
+      auto msg = std::make_shared<example::msg::Payload>();
+      FillData(FLAGS_content, FLAGS_bytes, &rng, &msg->data());
+      msg->data_size(FLAGS_bytes);
+      return msg;
+    });
+  }
+  if (FLAGS_message == "string") {
+    return Run<example::msg::String>(node, config, [&rng]() {
+      auto msg = std::make_shared<example::msg::String>();
+      msg->data(MakeText(FLAGS_bytes, &rng));
+      return msg;
+    });
+  }
+  if (FLAGS_message == "camera_info") {
+    return Run<example::msg::CameraInfo>(node, config, [&rng]() {
+      auto msg = std::make_shared<example::msg::CameraInfo>();
+      msg->camera_name(MakeText(FLAGS_bytes, &rng));
+      msg->width(1920);
+      return msg;
+    });
+  }
+  AERROR << "unknown --message: " << FLAGS_message;
+  return EXIT_FAILURE;
+}
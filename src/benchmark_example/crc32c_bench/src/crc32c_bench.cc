@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// CRC32C microbenchmark: every kernel of common/crc32c.h the CPU supports,
+// per message size, plus sealing and verifying a Payload the way the
+// integrity check of common/payload_integrity.h does. Reports ns/msg, GB/s
+// and us per MB, checks that all kernels agree and whether the fastest one
+// stays within --budget_us for a --budget_bytes message. Built by both
+// build_x86.sh and build_orin.sh; the report names the architecture and
+// the compiler.
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/crc32c.h"
+#include "common/payload_integrity.h"
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+
+DEFINE_string(sizes, "64,1024,16384,65536,1048576,4194304",
+              "comma separated message sizes in bytes");
+DEFINE_uint32(target_mb, 256, "data checksummed per round and case");
+DEFINE_uint32(rounds, 5, "rounds per case, the fastest one is reported");
+DEFINE_uint32(budget_bytes, 1048576, "message size of the budget check");
+DEFINE_double(budget_us, 50.0, "time allowed per --budget_bytes message");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+using example::common::Crc32cKernel;
+
+#if defined(__x86_64__)
+constexpr char kArch[] = "x86_64";
+#elif defined(__aarch64__)
+constexpr char kArch[] = "aarch64";
+#else
+constexpr char kArch[] = "other";
+#endif
+
+#if defined(__clang__)
+constexpr char kCompiler[] = "clang " __clang_version__;
+#else
+constexpr char kCompiler[] = "gcc " __VERSION__;
+#endif
+
+// Fastest of --rounds rounds, the one least disturbed by the rest of the
+// system.
+template <typename Fn>
+double BestNsPerCall(uint32_t iterations, Fn&& fn) {
+  double best = 0.0;
+  for (uint32_t round = 0; round < FLAGS_rounds; ++round) {
+    const uint64_t start = example::common::MonotonicNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+      fn();
+    }
+    const double ns =
+        static_cast<double>(example::common::MonotonicNs() - start) /
+        iterations;
+    best = round == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+class Report {
+ public:
+  Report() {
+    if (FLAGS_output.empty()) {
+      return;
+    }
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output_.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output_ << "| arch | compiler | case | bytes | ns/msg | GB/s "
+                 "| us per MB |\n"
+              << "|---|---|---|---|---|---|---|\n";
+    }
+    output_.setf(std::ios::fixed);
+    output_.precision(2);
+  }
+
+  void Add(const std::string& name, size_t bytes, double ns) {
+    const double gbps = bytes / ns;
+    const double us_per_mb = ns / bytes * 1048576 / 1000;
+    AINFO << "crc32c_bench: " << name << " bytes=" << bytes
+          << " ns/msg=" << ns << " GB/s=" << gbps
+          << " us_per_MB=" << us_per_mb;
+    if (output_.is_open()) {
+      output_ << "| " << kArch << " | " << kCompiler << " | " << name
+              << " | " << bytes << " | " << ns << " | " << gbps << " | "
+              << us_per_mb << " |\n";
+    }
+  }
+
+ private:
+  std::ofstream output_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rounds == 0, EXIT_FAILURE);
+
+  std::vector<Crc32cKernel> kernels;
+  for (auto kernel : {Crc32cKernel::kSoftware, Crc32cKernel::kCrc,
+                      Crc32cKernel::kCrcFold}) {
+    if (example::common::Crc32cSupported(kernel)) {
+      kernels.push_back(kernel);
+    }
+  }
+  const Crc32cKernel best = example::common::Crc32cBestKernel();
+  AINFO << "crc32c_bench: arch=" << kArch << " compiler=" << kCompiler
+        << " best=" << ToString(best);
+
+  Report report;
+  bool ok = true;
+  bool budget_checked = false;
+  std::istringstream sizes(FLAGS_sizes);
+  std::string item;
+  while (std::getline(sizes, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    const size_t bytes = std::stoul(item);
+    // Not constant, so no kernel can be folded away.
+    std::vector<uint8_t> data(bytes);
+    for (size_t i = 0; i < bytes; ++i) {
+      data[i] = static_cast<uint8_t>(i * 131 + (i >> 8));
+    }
+    const uint32_t iterations = static_cast<uint32_t>(std::max<uint64_t>(
+        10, FLAGS_target_mb * 1048576ULL / std::max<size_t>(bytes, 1)));
+
+    uint32_t expected = 0;
+    for (auto kernel : kernels) {
+      uint32_t crc = 0;
+      const double ns = BestNsPerCall(iterations, [&]() {
+        crc = example::common::Crc32cExtend(kernel, crc, data.data(), bytes);
+      });
+      // Each call chains the last result, so all kernels end up equal.
+      if (kernel == kernels.front()) {
+        expected = crc;
+      } else if (crc != expected) {
+        AERROR << "crc32c_bench: " << ToString(kernel) << " differs at "
+               << bytes << " bytes";
+        ok = false;
+      }
+      report.Add(ToString(kernel), bytes, ns);
+      if (kernel == best && bytes == FLAGS_budget_bytes) {
+        const double us = ns / 1000;
+        budget_checked = true;
+        if (us > FLAGS_budget_us) {
+          AWARN << "crc32c_bench: " << ToString(best) << " takes " << us
+                << " us for " << bytes << " bytes, over the budget of "
+                << FLAGS_budget_us << " us";
+          ok = false;
+        } else {
+          AINFO << "crc32c_bench: " << ToString(best) << " takes " << us
+                << " us for " << bytes << " bytes, within the budget of "
+                << FLAGS_budget_us << " us";
+        }
+      }
+    }
+
+    example::msg::Payload payload;
+    payload.topic_id(1);
+    payload.data_size(static_cast<uint32_t>(bytes));
+    payload.data() = data;
+    uint32_t seq = 0;
+    report.Add("Payload seal", bytes, BestNsPerCall(iterations, [&]() {
+                 payload.sequence_number(++seq);
+                 example::common::SealPayload(&payload);
+               }));
+    bool intact = true;
+    report.Add("Payload verify", bytes, BestNsPerCall(iterations, [&]() {
+                 intact = example::common::VerifyPayload(payload) && intact;
+               }));
+    if (bytes > 0) {
+      payload.data()[bytes / 2] ^= 1;
+      intact = intact && !example::common::VerifyPayload(payload);
+    }
+    if (!intact) {
+      AERROR << "crc32c_bench: Payload check wrong at " << bytes << " bytes";
+      ok = false;
+    }
+  }
+  if (!budget_checked) {
+    AWARN << "crc32c_bench: --sizes has no " << FLAGS_budget_bytes
+          << " bytes case, budget not checked";
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
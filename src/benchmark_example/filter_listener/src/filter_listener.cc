@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Subscriber of the downsampling benchmark. Either subscribes to the full
+// rate topic and drops samples in the callback (--max_hz, --keep_every_n),
+// or subscribes to a view published by filter_talker. Reports the received
+// and kept rates, bandwidth and CPU usage of the process.
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+#include "common/sample_filter.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/camera",
+              "topic to subscribe, e.g. /bench/camera/preview");
+DEFINE_double(max_hz, 0.0, "rate kept by the callback, 0 keeps all");
+DEFINE_uint32(keep_every_n, 1, "callback keeps every n-th message");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0, EXIT_FAILURE);
+
+  using Payload = example::msg::Payload;
+  example::common::SampleFilter<Payload>::Options options;
+  options.max_hz = FLAGS_max_hz;
+  options.keep_every_n = FLAGS_keep_every_n;
+  example::common::SampleFilter<Payload> filter(options);
+  std::mutex filter_mutex;
+  std::atomic<uint64_t> received{0};
+  std::atomic<uint64_t> kept{0};
+  std::atomic<uint64_t> bytes{0};
+
+  auto node = rti::segar::CreateNode("filter_listener");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto reader = node->CreateReader<Payload>(
+      FLAGS_topic, [&](const std::shared_ptr<Payload>& msg) {
+        received.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(msg->data().size(), std::memory_order_relaxed);
+        {
+          std::lock_guard<std::mutex> lock(filter_mutex);
+          if (!filter.Accept(*msg, example::common::MonotonicNs())) {
+            return;
+          }
+        }
+        kept.fetch_add(1, std::memory_order_relaxed);
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  auto last_stats = example::common::ReadProcessStats();
+  uint64_t last_ns = example::common::MonotonicNs();
+  uint64_t last_received = 0;
+  uint64_t last_kept = 0;
+  uint64_t last_bytes = 0;
+  auto report = [&]() {
+    const auto stats = example::common::ReadProcessStats();
+    const uint64_t now = example::common::MonotonicNs();
+    const double elapsed_s = (now - last_ns) / 1e9;
+    const uint64_t total_received = received.load();
+    const uint64_t total_kept = kept.load();
+    const uint64_t total_bytes = bytes.load();
+    AINFO << "filter_listener: topic=" << FLAGS_topic
+          << " received/s=" << (total_received - last_received) / elapsed_s
+          << " kept/s=" << (total_kept - last_kept) / elapsed_s << " MB/s="
+          << (total_bytes - last_bytes) / (1024.0 * 1024.0) / elapsed_s
+          << " cpu=" << 100.0 * (stats.CpuSeconds() - last_stats.CpuSeconds()) /
+                            elapsed_s
+          << "% rss_kb=" << stats.rss_kb;
+    last_stats = stats;
+    last_ns = now;
+    last_received = total_received;
+    last_kept = total_kept;
+    last_bytes = total_bytes;
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Publishes a full rate stream of large Payloads and, through FilteredWriter,
+// downsampled views of it, so that filter_listener can compare filtering in
+// the callback with subscribing to a view.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+#include "common/sample_filter.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/camera", "full rate topic");
+DEFINE_uint32(rate_hz, 100, "publish rate, at most 1000");
+DEFINE_uint32(bytes, 1048576, "payload size");
+DEFINE_double(view_max_hz, 10.0,
+              "rate of the <topic>/preview view, 0 disables it");
+DEFINE_uint32(view_keep_every_n, 10,
+              "the <topic>/every_n view keeps every n-th message, 0 "
+              "disables it");
+DEFINE_uint32(view_min_topic_id, 0,
+              "the <topic>/filtered view keeps messages with topic_id at "
+              "least this value, 0 disables it");
+DEFINE_uint32(topic_id_modulo, 4,
+              "topic_id cycles through 0..modulo-1 to feed the field "
+              "filter");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rate_hz == 0 || FLAGS_rate_hz > 1000, EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_topic_id_modulo == 0, EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("filter_talker");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  using Payload = example::msg::Payload;
+  example::common::FilteredWriter<Payload> writer(node, FLAGS_topic);
+  RETURN_VAL_IF(!writer.IsValid(), EXIT_FAILURE);
+  if (FLAGS_view_max_hz > 0.0) {
+    example::common::SampleFilter<Payload>::Options options;
+    options.max_hz = FLAGS_view_max_hz;
+    RETURN_VAL_IF(!writer.AddView("/preview", options), EXIT_FAILURE);
+  }
+  if (FLAGS_view_keep_every_n > 0) {
+    example::common::SampleFilter<Payload>::Options options;
+    options.keep_every_n = FLAGS_view_keep_every_n;
+    RETURN_VAL_IF(!writer.AddView("/every_n", options), EXIT_FAILURE);
+  }
+  if (FLAGS_view_min_topic_id > 0) {
+    example::common::SampleFilter<Payload>::Options options;
+    const uint32_t min_id = FLAGS_view_min_topic_id;
+    options.predicate = [min_id](const Payload& msg) {
+      return msg.topic_id() >= min_id;
+    };
+    RETURN_VAL_IF(!writer.AddView("/filtered", options), EXIT_FAILURE);
+  }
+
+  uint32_t seq = 0;
+  uint32_t failed = 0;
+  const uint32_t report_every =
+      std::max<uint32_t>(1, FLAGS_report_interval_s * FLAGS_rate_hz);
+  auto callback = [&]() {
+    auto msg = std::make_shared<Payload>();
+    msg->topic_id(seq % FLAGS_topic_id_modulo);
+    msg->sequence_number(seq++);
+    msg->data_size(FLAGS_bytes);
+    msg->data().resize(FLAGS_bytes, static_cast<uint8_t>(seq));
+    msg->timestamp(example::common::MonotonicNs());
+    if (!writer.Write(msg)) {
+      ++failed;
+    }
+    if (seq % report_every == 0) {
+      AINFO << "filter_talker: sent=" << seq << " failed=" << failed
+            << " views{" << writer.ViewStats() << "} "
+            << example::common::ToString(example::common::ReadProcessStats());
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(1000 / FLAGS_rate_hz,
+                                                   callback, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Checks that FlatView::Parse (common/flat_view.h) rejects field tables
+// that point outside the buffer and buffers cut short, as a corrupted or
+// crafted frame would have, so that the accessors flat_listener uses never
+// read past a message. Exits with a failure if one is accepted.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/flat_view.h"
+
+#include "segar/segar.h"
+
+namespace {
+
+bool Accepts(const std::vector<uint8_t>& buffer) {
+  example::common::FlatView view;
+  return example::common::FlatView::Parse(buffer.data(), buffer.size(),
+                                          &view);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+
+  std::vector<uint8_t> buffer;
+  example::common::FlatBuilder builder(&buffer, 1);
+  builder.Set<uint64_t>(0, 42);
+  builder.Finish();
+  RETURN_VAL_IF(!Accepts(buffer), EXIT_FAILURE);
+
+  int failures = 0;
+  // {offset, size} of the only entry, right after the 16 byte header.
+  const uint32_t bad_entries[][2] = {
+      {0x10000000, 8},   // offset past the end, the size check would wrap
+      {24, 0xfffffff0},  // size past the end
+      {8, 8},            // offset inside the header
+  };
+  for (const auto& entry : bad_entries) {
+    std::vector<uint8_t> crafted = buffer;
+    std::memcpy(crafted.data() + 16, entry, sizeof(entry));
+    if (Accepts(crafted)) {
+      AERROR << "flat_check: accepted a field at offset " << entry[0]
+             << " size " << entry[1] << " in " << crafted.size() << " bytes";
+      ++failures;
+    }
+  }
+  for (size_t size = 0; size < buffer.size(); ++size) {
+    const std::vector<uint8_t> cut(buffer.begin(), buffer.begin() + size);
+    if (Accepts(cut)) {
+      AERROR << "flat_check: accepted " << size << " of " << buffer.size()
+             << " bytes";
+      ++failures;
+    }
+  }
+  AINFO << "flat_check: " << (failures == 0 ? "passed" : "FAILED");
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Receives the frames of flat_talker and records, per frame size, the time
+// from encoding on the sender to the moment the callback has read the frame
+// header. POD frames must be decoded completely first; flat frames are read
+// in place through FlatView.
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/flat_frame.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/frame", "topic to subscribe");
+DEFINE_bool(touch_pixels, false,
+            "also read every pixel byte, as a consumer of the image would");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+
+namespace {
+
+struct SizeStats {
+  example::common::LatencyHistogram latency;
+  uint64_t malformed = 0;
+};
+
+uint64_t Checksum(const uint8_t* data, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0, EXIT_FAILURE);
+
+  std::mutex mutex;
+  std::map<std::string, SizeStats> stats;
+  uint64_t checksum = 0;
+
+  auto node = rti::segar::CreateNode("flat_listener");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto reader = node->CreateReader<example::msg::Payload>(
+      FLAGS_topic, [&](const std::shared_ptr<example::msg::Payload>& msg) {
+        const auto& data = msg->data();
+        const bool flat =
+            msg->topic_id() ==
+            static_cast<uint32_t>(example::common::FrameFormat::kFlat);
+        uint64_t stamp = 0;
+        uint64_t sum = 0;
+        bool ok = false;
+        if (flat) {
+          example::common::FlatView view;
+          ok = example::common::FlatView::Parse(data.data(), data.size(),
+                                                &view);
+          stamp = view.Get<uint64_t>(example::common::kFrameStamp, 0);
+          if (ok && FLAGS_touch_pixels) {
+            const auto pixels = view.GetBytes(example::common::kFramePixels);
+            sum = Checksum(pixels.data, pixels.size);
+          }
+        } else {
+          example::common::Frame frame;
+          ok = example::common::PodDecode(data.data(), data.size(), &frame) !=
+               0;
+          stamp = frame.stamp;
+          if (ok && FLAGS_touch_pixels) {
+            sum = Checksum(frame.pixels.data(), frame.pixels.size());
+          }
+        }
+        const uint64_t now = example::common::MonotonicNs();
+        const std::string key = std::string(flat ? "flat " : "pod ") +
+                                std::to_string(data.size()) + "B";
+        std::lock_guard<std::mutex> lock(mutex);
+        checksum += sum;
+        SizeStats& entry = stats[key];
+        if (!ok || stamp > now) {
+          ++entry.malformed;
+          return;
+        }
+        entry.latency.Record(now - stamp);
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  auto report = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& item : stats) {
+      AINFO << "flat_listener: " << item.first << " latency_us{"
+            << item.second.latency.Summary() << "} malformed="
+            << item.second.malformed;
+    }
+    AINFO << "flat_listener: checksum=" << checksum << " "
+          << example::common::ToString(example::common::ReadProcessStats());
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
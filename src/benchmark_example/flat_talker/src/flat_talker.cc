@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Publishes large camera frames inside Payload::data, encoded either as a
+// flat buffer or in the POD format, for flat_listener to compare the
+// receive-to-callback latency of the two.
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/flat_frame.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/frame", "topic to publish on");
+DEFINE_string(format, "flat", "encoding of the frame: flat or pod");
+DEFINE_string(sizes, "1048576,4194304,16777216",
+              "comma separated pixel buffer sizes in bytes");
+DEFINE_uint32(messages_per_size, 500, "frames sent for each size");
+DEFINE_uint32(rate_hz, 30, "publish rate, at most 1000");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rate_hz == 0 || FLAGS_rate_hz > 1000, EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_format != "flat" && FLAGS_format != "pod",
+                EXIT_FAILURE);
+  const bool flat = FLAGS_format == "flat";
+  std::vector<uint32_t> sizes;
+  std::istringstream size_list(FLAGS_sizes);
+  std::string item;
+  while (std::getline(size_list, item, ',')) {
+    if (!item.empty()) {
+      sizes.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+  }
+  RETURN_VAL_IF(sizes.empty() || FLAGS_messages_per_size == 0, EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("flat_talker");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Payload>(FLAGS_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+
+  example::common::Frame frame;
+  frame.width = 1920;
+  frame.encoding = "rgb8";
+  uint32_t seq = 0;
+  uint32_t failed = 0;
+  auto callback = [&]() {
+    const size_t index = seq / FLAGS_messages_per_size;
+    if (index >= sizes.size()) {
+      return;
+    }
+    if (frame.pixels.size() != sizes[index]) {
+      frame.pixels.assign(sizes[index], 0x5a);
+      frame.height = sizes[index] / (frame.width * 3);
+      AINFO << "flat_talker: sending " << sizes[index] << "B frames as "
+            << FLAGS_format;
+    }
+    auto msg = std::make_shared<example::msg::Payload>();
+    msg->topic_id(static_cast<uint32_t>(
+        flat ? example::common::FrameFormat::kFlat
+             : example::common::FrameFormat::kPod));
+    msg->sequence_number(seq);
+    frame.id = seq++;
+    // Encoding is part of the measured latency for both formats.
+    frame.stamp = example::common::MonotonicNs();
+    if (flat) {
+      example::common::FlatBuilder builder(&msg->data(),
+                                           example::common::kFrameFieldCount);
+      builder.Reserve(frame.pixels.size() + 256);
+      builder.Set(example::common::kFrameStamp, frame.stamp);
+      builder.Set(example::common::kFrameId, frame.id);
+      builder.Set(example::common::kFrameWidth, frame.width);
+      builder.Set(example::common::kFrameHeight, frame.height);
+      builder.SetString(example::common::kFrameEncoding, frame.encoding);
+      builder.SetArray(example::common::kFramePixels, frame.pixels.data(),
+                       frame.pixels.size());
+      builder.Finish();
+    } else {
+      example::common::PodEncode(frame, &msg->data());
+    }
+    msg->data_size(static_cast<uint32_t>(msg->data().size()));
+    msg->timestamp(frame.stamp);
+    if (!writer->Write(msg)) {
+      ++failed;
+    }
+    if (seq % FLAGS_messages_per_size == 0) {
+      AINFO << "flat_talker: sent=" << seq << " failed=" << failed;
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(1000 / FLAGS_rate_hz,
+                                                   callback, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Receiver of the large message benchmark: drops a configurable share of the
+// fragments to simulate packet loss, reassembles the rest, sends Nacks for
+// the missing ones and reports throughput and latency per message size.
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/fragmenter.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Fragment.hpp"
+#include "example/msg/Nack.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/frag", "topic the fragments arrive on");
+DEFINE_string(nack_topic, "/bench/frag/nack", "topic the Nacks are sent on");
+DEFINE_double(loss_pct, 0.0, "percentage of fragments dropped on arrival");
+DEFINE_uint32(seed, 1, "random seed of the loss injection");
+DEFINE_uint32(nack_delay_ms, 5,
+              "silence on a message before its missing fragments are "
+              "requested");
+DEFINE_uint32(nack_interval_ms, 2, "period of the Nack check");
+DEFINE_uint32(give_up_ms, 5000, "incomplete messages are dropped after this");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+DEFINE_string(output, "",
+              "markdown table the results are appended to on shutdown");
+
+namespace {
+
+struct SizeStats {
+  example::common::LatencyHistogram latency;
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  uint64_t messages = 0;
+  uint64_t corrupted = 0;
+
+  double MegabytesPerSecond(uint32_t size) const {
+    if (last_ns <= first_ns) {
+      return 0.0;
+    }
+    return size / (1024.0 * 1024.0) * messages / ((last_ns - first_ns) / 1e9);
+  }
+};
+
+// Spot checks the pattern written by frag_sender.
+bool CheckContent(uint32_t stream_id, const std::vector<uint8_t>& data) {
+  for (size_t i = 0; i < data.size(); i += 4093) {
+    if (data[i] != static_cast<uint8_t>(i + stream_id)) {
+      return false;
+    }
+  }
+  return data.back() == static_cast<uint8_t>(data.size() - 1 + stream_id);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_loss_pct < 0.0 || FLAGS_loss_pct >= 100.0,
+                EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0 || FLAGS_nack_interval_ms == 0,
+                EXIT_FAILURE);
+
+  std::mutex stats_mutex;
+  std::map<uint32_t, SizeStats> stats;
+  example::common::Reassembler::Options options;
+  options.nack_delay_ns = FLAGS_nack_delay_ms * 1000000ULL;
+  options.give_up_ns = FLAGS_give_up_ms * 1000000ULL;
+  example::common::Reassembler reassembler(
+      options, [&](uint32_t stream_id, uint64_t timestamp,
+                   std::vector<uint8_t>&& data) {
+        const uint64_t now = example::common::MonotonicNs();
+        const bool intact = CheckContent(stream_id, data);
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        SizeStats& entry = stats[static_cast<uint32_t>(data.size())];
+        if (entry.messages == 0) {
+          entry.first_ns = timestamp;
+        }
+        entry.last_ns = now;
+        ++entry.messages;
+        entry.corrupted += intact ? 0 : 1;
+        entry.latency.Record(now - timestamp);
+      });
+
+  std::mutex loss_mutex;
+  std::mt19937 rng(FLAGS_seed);
+  std::uniform_real_distribution<double> percent(0.0, 100.0);
+  uint64_t dropped = 0;
+  auto node = rti::segar::CreateNode("frag_receiver");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Nack>(FLAGS_nack_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+  auto reader = node->CreateReader<example::msg::Fragment>(
+      FLAGS_topic,
+      [&](const std::shared_ptr<example::msg::Fragment>& fragment) {
+        if (FLAGS_loss_pct > 0.0) {
+          std::lock_guard<std::mutex> lock(loss_mutex);
+          if (percent(rng) < FLAGS_loss_pct) {
+            ++dropped;
+            return;
+          }
+        }
+        reassembler.OnFragment(*fragment);
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  auto send_nacks = [&]() {
+    std::vector<example::msg::Nack> nacks;
+    reassembler.CollectNacks(example::common::MonotonicNs(), &nacks);
+    for (auto& nack : nacks) {
+      writer->Write(std::make_shared<example::msg::Nack>(std::move(nack)));
+    }
+  };
+  auto nack_timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_nack_interval_ms, send_nacks, false);
+  nack_timer->Start();
+
+  auto report = [&]() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (const auto& item : stats) {
+      AINFO << "frag_receiver: size=" << item.first
+            << "B messages=" << item.second.messages
+            << " MB/s=" << item.second.MegabytesPerSecond(item.first)
+            << " latency_ms{" << item.second.latency.Summary(1e6)
+            << "} corrupted=" << item.second.corrupted;
+    }
+    AINFO << "frag_receiver: loss_pct=" << FLAGS_loss_pct
+          << " dropped=" << dropped
+          << " nacks=" << reassembler.nacks_sent()
+          << " duplicates=" << reassembler.duplicates()
+          << " given_up=" << reassembler.given_up()
+          << " malformed=" << reassembler.malformed();
+  };
+  auto report_timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  report_timer->Start();
+  rti::segar::WaitForShutdown();
+  report();
+
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    std::ofstream output(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| size | loss % | messages | given up | MB/s | p50 ms "
+                "| p99 ms | max ms | nacks | duplicates |\n"
+             << "|---|---|---|---|---|---|---|---|---|---|\n";
+    }
+    output.setf(std::ios::fixed);
+    output.precision(2);
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (const auto& item : stats) {
+      const auto& latency = item.second.latency;
+      output << "| " << item.first << " | " << FLAGS_loss_pct << " | "
+             << item.second.messages << " | " << reassembler.given_up()
+             << " | " << item.second.MegabytesPerSecond(item.first) << " | "
+             << latency.Percentile(50) / 1e6 << " | "
+             << latency.Percentile(99) / 1e6 << " | " << latency.max() / 1e6
+             << " | " << reassembler.nacks_sent() << " | "
+             << reassembler.duplicates() << " |\n";
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Run the large message benchmark with 0-2% injected fragment loss
+# Usage: ./scripts/run_loss_matrix.sh [bandwidth_mbps] [fragment_size]
+# The results are collected in frag_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+RECEIVER_LAUNCH="$SCRIPT_DIR/../../frag_receiver/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../frag_report.md"
+BANDWIDTH_MBPS="${1:-0}"
+FRAGMENT_SIZE="${2:-65536}"
+
+if [ ! -f "$RECEIVER_LAUNCH" ]; then
+  echo "Error: frag_receiver not found: $RECEIVER_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+# The receiver writes its rows when it shuts down
+stop_receiver() {
+  pkill -INT -x frag_receiver 2>/dev/null || true
+  while pgrep -x frag_receiver > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_receiver EXIT
+
+for loss_pct in 0 0.5 1 2; do
+  echo "--- loss_pct=$loss_pct"
+  bash "$RECEIVER_LAUNCH" --loss_pct=$loss_pct --output="$REPORT" > /dev/null 2>&1 &
+  bash "$SCRIPT_DIR/launch.sh" --bandwidth_mbps=$BANDWIDTH_MBPS \
+    --fragment_size=$FRAGMENT_SIZE
+  stop_receiver
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
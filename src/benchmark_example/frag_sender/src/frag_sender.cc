@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Sender of the large message benchmark: splits 1-16MB messages into
+// Fragment messages, paces them through a token bucket and answers the
+// Nacks of frag_receiver with retransmissions.
+
+#include <time.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/fragmenter.h"
+#include "common/proc_stats.h"
+#include "common/token_bucket.h"
+#include "example/msg/Fragment.hpp"
+#include "example/msg/Nack.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/frag", "topic the fragments are sent on");
+DEFINE_string(nack_topic, "/bench/frag/nack", "topic the Nacks arrive on");
+DEFINE_string(sizes, "1048576,4194304,16777216",
+              "comma separated message sizes in bytes");
+DEFINE_uint32(messages_per_size, 50, "messages sent for each size");
+DEFINE_double(rate_hz, 5.0, "messages per second");
+DEFINE_uint32(fragment_size, 65536, "bytes per fragment");
+DEFINE_uint32(bandwidth_mbps, 0,
+              "token bucket rate in MB/s for all fragments, 0 disables "
+              "pacing");
+DEFINE_uint32(burst_kb, 256, "token bucket depth");
+DEFINE_uint32(retained_messages, 8,
+              "messages kept for retransmission after they were sent");
+DEFINE_uint32(drain_ms, 2000,
+              "time to keep answering Nacks after the last message");
+
+namespace {
+
+void SleepUntil(uint64_t due_ns) {
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(due_ns / 1000000000ULL);
+  ts.tv_nsec = static_cast<long>(due_ns % 1000000000ULL);
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
+// Content the receiver can spot check: byte i of stream s is (i + s) & 0xff.
+std::shared_ptr<const std::vector<uint8_t>> MakeMessage(uint32_t stream_id,
+                                                        uint32_t size) {
+  auto data = std::make_shared<std::vector<uint8_t>>(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    (*data)[i] = static_cast<uint8_t>(i + stream_id);
+  }
+  return data;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rate_hz <= 0.0 || FLAGS_fragment_size == 0,
+                EXIT_FAILURE);
+  std::vector<uint32_t> sizes;
+  std::istringstream size_list(FLAGS_sizes);
+  std::string item;
+  while (std::getline(size_list, item, ',')) {
+    if (!item.empty()) {
+      sizes.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+  }
+  RETURN_VAL_IF(sizes.empty(), EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("frag_sender");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Fragment>(FLAGS_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+
+  example::common::TokenBucket pacing(
+      static_cast<uint64_t>(FLAGS_bandwidth_mbps) * 1024 * 1024,
+      static_cast<uint64_t>(FLAGS_burst_kb) * 1024);
+  example::common::FragmentSender::Options options;
+  options.fragment_size = FLAGS_fragment_size;
+  options.retained_messages = FLAGS_retained_messages;
+  example::common::FragmentSender sender(
+      options, &pacing,
+      [&writer](const std::shared_ptr<example::msg::Fragment>& fragment) {
+        return writer->Write(fragment);
+      });
+  auto reader = node->CreateReader<example::msg::Nack>(
+      FLAGS_nack_topic,
+      [&sender](const std::shared_ptr<example::msg::Nack>& nack) {
+        sender.OnNack(*nack);
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  // Give discovery time to match the receiver before the first message.
+  SleepUntil(example::common::MonotonicNs() + 2000000000ULL);
+
+  const auto period_ns = static_cast<uint64_t>(1e9 / FLAGS_rate_hz);
+  uint32_t stream_id = 0;
+  uint64_t due = example::common::MonotonicNs();
+  for (uint32_t size : sizes) {
+    const uint64_t start = example::common::MonotonicNs();
+    const uint64_t sent_before = sender.fragments_sent();
+    for (uint32_t i = 0; i < FLAGS_messages_per_size; ++i) {
+      // Serve retransmissions while waiting for the next message slot.
+      while (example::common::MonotonicNs() < due) {
+        sender.ServeRetransmits();
+        SleepUntil(std::min(due, example::common::MonotonicNs() + 1000000));
+      }
+      due += period_ns;
+      auto data = MakeMessage(++stream_id, size);
+      sender.Send(stream_id, example::common::MonotonicNs(), std::move(data));
+    }
+    const double elapsed_s = (example::common::MonotonicNs() - start) / 1e9;
+    AINFO << "frag_sender: size=" << size << "B messages="
+          << FLAGS_messages_per_size << " fragments="
+          << sender.fragments_sent() - sent_before
+          << " offered_MB/s=" << size / (1024.0 * 1024.0) *
+                                     FLAGS_messages_per_size / elapsed_s;
+  }
+  const uint64_t drain_end =
+      example::common::MonotonicNs() + FLAGS_drain_ms * 1000000ULL;
+  while (example::common::MonotonicNs() < drain_end) {
+    sender.ServeRetransmits();
+    SleepUntil(example::common::MonotonicNs() + 1000000);
+  }
+  AINFO << "frag_sender: fragments=" << sender.fragments_sent()
+        << " retransmitted=" << sender.fragments_resent()
+        << " unavailable=" << sender.unavailable()
+        << " evicted=" << sender.evicted()
+        << " pacing_wait_ms=" << pacing.waited_ns() / 1e6;
+  AINFO << "frag_sender: "
+        << example::common::ToString(example::common::ReadProcessStats());
+  return EXIT_SUCCESS;
+}
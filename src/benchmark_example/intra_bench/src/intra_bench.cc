@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Writer and reader in one process (communication_mode same_proc: INTRA).
+// Measures the per-message cost of in-process delivery and checks that the
+// reader receives the writer's object itself, i.e. nothing was serialized
+// or copied on the way.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/cow_ptr.h"
+#include "common/hybrid_waiter.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/intra", "topic used inside the process");
+DEFINE_string(sizes, "64,4096,65536,1048576",
+              "comma separated payload sizes in bytes");
+DEFINE_uint32(iterations, 100000, "messages per payload size");
+DEFINE_uint32(burst, 64, "messages in flight in the throughput phase");
+DEFINE_uint32(timeout_ms, 1000, "time to wait for one delivery");
+
+namespace {
+
+using Payload = example::msg::Payload;
+
+struct Delivery {
+  std::atomic<const Payload*> expected{nullptr};
+  std::atomic<uint64_t> delivered{0};
+  std::atomic<uint64_t> shared{0};
+  std::atomic<uint64_t> latency_ns{0};
+  example::common::HybridWaiter waiter{
+      example::common::HybridWaiter::Mode::kHybrid,
+      std::chrono::microseconds(20)};
+};
+
+bool WaitDelivered(Delivery* delivery, uint64_t count,
+                   std::chrono::milliseconds timeout) {
+  for (;;) {
+    const uint32_t observed = delivery->waiter.sequence();
+    if (delivery->delivered.load(std::memory_order_acquire) >= count) {
+      return true;
+    }
+    if (!delivery->waiter.WaitChanged(observed, timeout)) {
+      return false;
+    }
+  }
+}
+
+bool ParseSizes(const std::string& list, std::vector<uint32_t>* sizes) {
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (!item.empty()) {
+      sizes->push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+  }
+  return !sizes->empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  std::vector<uint32_t> sizes;
+  RETURN_VAL_IF(!ParseSizes(FLAGS_sizes, &sizes) || FLAGS_burst == 0,
+                EXIT_FAILURE);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("intra_bench");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<Payload>(FLAGS_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+
+  Delivery delivery;
+  auto reader = node->CreateReader<Payload>(
+      FLAGS_topic, [&delivery](const std::shared_ptr<Payload>& msg) {
+        // Consumers only get a const view of the shared message.
+        example::common::CowPtr<Payload> view(msg);
+        delivery.latency_ns.store(
+            example::common::MonotonicNs() - view->timestamp(),
+            std::memory_order_relaxed);
+        if (view.get() == delivery.expected.load(std::memory_order_relaxed)) {
+          delivery.shared.fetch_add(1, std::memory_order_relaxed);
+        }
+        delivery.delivered.fetch_add(1, std::memory_order_release);
+        delivery.waiter.Notify();
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  const std::chrono::milliseconds timeout(FLAGS_timeout_ms);
+  // Discovery of the in-process reader.
+  for (int attempt = 0;; ++attempt) {
+    RETURN_VAL_IF(attempt > 100, EXIT_FAILURE);
+    auto msg = std::make_shared<Payload>();
+    msg->timestamp(example::common::MonotonicNs());
+    const uint64_t before = delivery.delivered.load();
+    writer->Write(msg);
+    if (WaitDelivered(&delivery, before + 1, std::chrono::milliseconds(100))) {
+      break;
+    }
+  }
+
+  for (uint32_t size : sizes) {
+    // Latency: one message in flight, creation of the message not counted.
+    example::common::LatencyHistogram latency;
+    example::common::LatencyHistogram write_cost;
+    uint64_t lost = 0;
+    const uint64_t shared_before = delivery.shared.load();
+    for (uint32_t i = 0; i < FLAGS_iterations; ++i) {
+      auto msg = std::make_shared<Payload>();
+      msg->data().resize(size);
+      msg->sequence_number(i);
+      delivery.expected.store(msg.get(), std::memory_order_relaxed);
+      const uint64_t count = delivery.delivered.load() + 1;
+      const uint64_t start = example::common::MonotonicNs();
+      msg->timestamp(start);
+      writer->Write(msg);
+      write_cost.Record(example::common::MonotonicNs() - start);
+      if (WaitDelivered(&delivery, count, timeout)) {
+        latency.Record(delivery.latency_ns.load(std::memory_order_relaxed));
+      } else {
+        ++lost;
+      }
+    }
+    const uint64_t shared = delivery.shared.load() - shared_before;
+
+    // Throughput: bursts of messages, cost amortized per message.
+    std::vector<std::shared_ptr<Payload>> batch(FLAGS_burst);
+    for (auto& msg : batch) {
+      msg = std::make_shared<Payload>();
+      msg->data().resize(size);
+    }
+    delivery.expected.store(nullptr);
+    const uint64_t start = example::common::MonotonicNs();
+    uint64_t sent = 0;
+    for (uint32_t i = 0; i < FLAGS_iterations / FLAGS_burst; ++i) {
+      const uint64_t count = delivery.delivered.load() + batch.size();
+      for (auto& msg : batch) {
+        msg->timestamp(example::common::MonotonicNs());
+        writer->Write(msg);
+      }
+      sent += batch.size();
+      if (!WaitDelivered(&delivery, count, timeout)) {
+        break;
+      }
+    }
+    const double ns_per_msg =
+        sent == 0 ? 0.0
+                  : static_cast<double>(example::common::MonotonicNs() -
+                                        start) /
+                        sent;
+
+    AINFO << "intra_bench: size=" << size << "B delivery_ns{"
+          << latency.Summary(1.0) << "} write_ns{" << write_cost.Summary(1.0)
+          << "} shared=" << shared << "/" << latency.count()
+          << " lost=" << lost << " burst_ns_per_msg=" << ns_per_msg;
+    AWARN_IF(shared != latency.count())
+        << "intra_bench: " << latency.count() - shared
+        << " messages were not delivered by pointer, check that "
+           "same_proc is INTRA";
+  }
+
+  // Copy on write: a mutating consumer gets its own copy while the writer's
+  // message stays untouched.
+  auto original = std::make_shared<Payload>();
+  original->data_size(1);
+  example::common::CowPtr<Payload> reader_view(original);
+  reader_view.Mutable()->data_size(2);
+  AINFO << "intra_bench: copy on write original=" << original->data_size()
+        << " consumer=" << reader_view->data_size()
+        << " copies=" << reader_view.copies();
+  AINFO << "intra_bench: "
+        << example::common::ToString(example::common::ReadProcessStats());
+  return EXIT_SUCCESS;
+}
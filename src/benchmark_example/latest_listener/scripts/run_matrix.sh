@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Run the latest-only benchmark: filter_talker publishes at 100Hz, the
+# listener needs --work_ms per sample, once with the plain reader queue and
+# once each with the latest-only and keep-last-N OverwriteReader
+# Usage: ./scripts/run_matrix.sh [work_ms] [seconds_per_run]
+# The results are collected in latest_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+TALKER_LAUNCH="$SCRIPT_DIR/../../filter_talker/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../latest_report.md"
+WORK_MS="${1:-100}"
+SECONDS_PER_RUN="${2:-30}"
+
+if [ ! -f "$TALKER_LAUNCH" ]; then
+  echo "Error: filter_talker not found: $TALKER_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+stop_talker() {
+  pkill -INT -x filter_talker 2>/dev/null || true
+  while pgrep -x filter_talker > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_talker EXIT
+
+bash "$TALKER_LAUNCH" --rate_hz=100 --bytes=65536 > /dev/null 2>&1 &
+for mode in queue latest keep_last; do
+  echo "--- $mode, ${WORK_MS}ms per sample"
+  timeout -s INT "$SECONDS_PER_RUN" bash "$SCRIPT_DIR/launch.sh" \
+    --mode=$mode --work_ms=$WORK_MS --output="$REPORT" || true
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Slow subscriber of the latest-only benchmark: every sample takes
+// --work_ms to process, ten times the period of filter_talker at 100Hz by
+// default. Compares the plain reader queue with OverwriteReader in
+// latest-only and keep-last-N mode and reports how old the processed
+// samples are, how many were skipped and the CPU usage of the process.
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/latency_histogram.h"
+#include "common/overwrite_ring.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_string(topic, "/bench/camera", "topic of filter_talker");
+DEFINE_string(mode, "latest",
+              "queue: plain reader, latest: newest sample only, keep_last: "
+              "newest --keep_last samples");
+DEFINE_uint32(keep_last, 4, "samples kept by --mode=keep_last");
+DEFINE_uint32(work_ms, 100, "processing time per sample");
+DEFINE_uint32(report_interval_s, 5, "interval of the report");
+DEFINE_string(output, "",
+              "markdown table a row is appended to at shutdown");
+
+namespace {
+
+struct Stats {
+  example::common::LatencyHistogram staleness;
+  uint64_t processed = 0;
+  uint64_t skipped = 0;
+  uint32_t next_seq = 0;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0, EXIT_FAILURE);
+  size_t keep_last = 0;
+  if (FLAGS_mode == "latest") {
+    keep_last = 1;
+  } else if (FLAGS_mode == "keep_last") {
+    keep_last = FLAGS_keep_last;
+  } else {
+    RETURN_VAL_IF(FLAGS_mode != "queue", EXIT_FAILURE);
+  }
+
+  using Payload = example::msg::Payload;
+  std::mutex mutex;
+  Stats stats;
+  const std::chrono::milliseconds work(FLAGS_work_ms);
+  // Staleness is measured when processing starts: how old the sample the
+  // consumer works on is.
+  auto process = [&](const std::shared_ptr<Payload>& msg) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stats.staleness.Record(example::common::MonotonicNs() -
+                             msg->timestamp());
+      if (stats.processed++ > 0 && msg->sequence_number() > stats.next_seq) {
+        stats.skipped += msg->sequence_number() - stats.next_seq;
+      }
+      stats.next_seq = msg->sequence_number() + 1;
+    }
+    rti::segar::SleepFor(work);
+  };
+
+  auto node = rti::segar::CreateNode("latest_listener");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  std::shared_ptr<rti::segar::Reader<Payload>> reader;
+  std::unique_ptr<example::common::OverwriteReader<Payload>> overwrite;
+  if (keep_last == 0) {
+    reader = node->CreateReader<Payload>(FLAGS_topic, process);
+    RETURN_VAL_IF(!reader, EXIT_FAILURE);
+  } else {
+    overwrite = std::make_unique<example::common::OverwriteReader<Payload>>(
+        node, FLAGS_topic, keep_last, process);
+    RETURN_VAL_IF(!overwrite->IsValid(), EXIT_FAILURE);
+  }
+
+  const auto start_stats = example::common::ReadProcessStats();
+  const uint64_t start_ns = example::common::MonotonicNs();
+  auto cpu_pct = [&]() {
+    return 100.0 *
+           (example::common::ReadProcessStats().CpuSeconds() -
+            start_stats.CpuSeconds()) /
+           ((example::common::MonotonicNs() - start_ns) / 1e9);
+  };
+  auto report = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    AINFO << "latest_listener: mode=" << FLAGS_mode
+          << " processed=" << stats.processed << " skipped=" << stats.skipped
+          << " staleness_ms{" << stats.staleness.Summary(1e6)
+          << "} cpu=" << cpu_pct() << "%";
+    if (overwrite) {
+      AINFO << "latest_listener: ring received=" << overwrite->received()
+            << " delivered=" << overwrite->delivered()
+            << " overwritten=" << overwrite->skipped();
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  report();
+
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    std::ofstream output(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| mode | work ms | processed | skipped | p50 stale ms "
+                "| p99 stale ms | max stale ms | cpu % |\n"
+             << "|---|---|---|---|---|---|---|---|\n";
+    }
+    output.setf(std::ios::fixed);
+    output.precision(2);
+    std::lock_guard<std::mutex> lock(mutex);
+    output << "| " << FLAGS_mode
+           << (keep_last > 1 ? " " + std::to_string(keep_last) : "") << " | "
+           << FLAGS_work_ms << " | " << stats.processed << " | "
+           << stats.skipped << " | "
+           << stats.staleness.Percentile(50) / 1e6 << " | "
+           << stats.staleness.Percentile(99) / 1e6 << " | "
+           << stats.staleness.max() / 1e6 << " | " << cpu_pct() << " |\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Cost of a log statement on the calling thread: AINFO << ... against
+// FAST_AINFO (common/fast_log.h), with 1 to 28 threads logging the same
+// statement concurrently, as fast as they can or at --rate_hz per thread.
+// A call FastLog drops because its buffer is full costs almost nothing, so
+// it is kept out of the timing and reported as the drop rate next to it.
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/fast_log.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+
+DEFINE_string(threads, "1,2,4,8,16,28", "comma separated thread counts");
+DEFINE_string(backends, "ainfo,fast", "comma separated: ainfo, fast");
+DEFINE_uint32(calls, 100000, "log statements per thread and run");
+DEFINE_uint32(rate_hz, 0,
+              "log statements per second and thread, 0 logs back to back");
+DEFINE_uint32(records_per_thread, 8192, "FastLog buffer size in records");
+DEFINE_uint32(flush_interval_ms, 20, "FastLog flush interval");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> items;
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// One statement with the arguments of a typical per-message log line.
+// Returns false if FastLog dropped it.
+bool LogOnce(bool fast, uint32_t thread, uint32_t seq) {
+  static const std::string kTopic = "/bench/camera";
+  if (fast) {
+    // What FAST_AINFO expands to after its compile-time checks, keeping the
+    // result of Log().
+    static constexpr example::common::LogSite kSite{
+        __FILE__, __LINE__, example::common::LogLevel::kInfo,
+        "log_bench: thread={} seq={} topic={} size={} stamp={}"};
+    return example::common::FastLog::Instance().Log(&kSite, thread, seq,
+                                                    kTopic, 65536, 0.5 * seq);
+  }
+  AINFO << "log_bench: thread=" << thread << " seq=" << seq
+        << " topic=" << kTopic << " size=" << 65536 << " stamp=" << 0.5 * seq;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  example::common::FastLog::Options options;
+  options.records_per_thread = FLAGS_records_per_thread;
+  options.flush_interval_ms = FLAGS_flush_interval_ms;
+  example::common::FastLog::Configure(options);
+  auto& fast_log = example::common::FastLog::Instance();
+
+  const auto backends = Split(FLAGS_backends);
+  std::vector<uint32_t> thread_counts;
+  for (const auto& item : Split(FLAGS_threads)) {
+    thread_counts.push_back(static_cast<uint32_t>(std::stoul(item)));
+  }
+  RETURN_VAL_IF(backends.empty() || thread_counts.empty(), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_calls == 0, EXIT_FAILURE);
+  for (const auto& backend : backends) {
+    RETURN_VAL_IF(backend != "ainfo" && backend != "fast", EXIT_FAILURE);
+  }
+
+  std::ofstream output;
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| backend | threads | avg ns | p50 ns | p99 ns | p99.9 ns "
+                "| max ns | calls/s | cpu % | dropped | drop % |\n"
+             << "|---|---|---|---|---|---|---|---|---|---|---|\n";
+    }
+  }
+
+  // Two clock reads surround every measured call.
+  example::common::LatencyHistogram clock_cost;
+  for (int i = 0; i < 10000; ++i) {
+    const uint64_t start = example::common::MonotonicNs();
+    clock_cost.Record(example::common::MonotonicNs() - start);
+  }
+  AINFO << "log_bench: clock overhead ns{" << clock_cost.Summary(1.0) << "}";
+
+  for (uint32_t threads : thread_counts) {
+    for (const auto& backend : backends) {
+      const bool fast = backend == "fast";
+      std::vector<example::common::LatencyHistogram> histograms(threads);
+      std::vector<uint64_t> drops(threads, 0);
+      std::atomic<uint32_t> ready{0};
+      std::atomic<bool> go{false};
+      std::vector<std::thread> workers;
+      for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+          auto& histogram = histograms[t];
+          uint64_t dropped = 0;
+          ready.fetch_add(1);
+          while (!go.load(std::memory_order_acquire)) {
+          }
+          auto next = std::chrono::steady_clock::now();
+          for (uint32_t i = 0; i < FLAGS_calls; ++i) {
+            if (FLAGS_rate_hz > 0) {
+              // Absolute deadlines, so a late call does not shift the rest.
+              next += std::chrono::nanoseconds(1000000000ULL / FLAGS_rate_hz);
+              std::this_thread::sleep_until(next);
+            }
+            const uint64_t start = example::common::MonotonicNs();
+            const bool logged = LogOnce(fast, t, i);
+            const uint64_t end = example::common::MonotonicNs();
+            if (logged) {
+              histogram.Record(end - start);
+            } else {
+              ++dropped;
+            }
+          }
+          drops[t] = dropped;
+        });
+      }
+      while (ready.load() < threads) {
+        std::this_thread::yield();
+      }
+      const auto cpu_before = example::common::ReadProcessStats();
+      const uint64_t start = example::common::MonotonicNs();
+      go.store(true, std::memory_order_release);
+      for (auto& worker : workers) {
+        worker.join();
+      }
+      const double elapsed_s = (example::common::MonotonicNs() - start) / 1e9;
+      const double cpu_pct =
+          100.0 *
+          (example::common::ReadProcessStats().CpuSeconds() -
+           cpu_before.CpuSeconds()) /
+          elapsed_s;
+      if (fast) {
+        // The backlog is written before the next run starts.
+        fast_log.Flush();
+      }
+      example::common::LatencyHistogram all;
+      uint64_t dropped = 0;
+      for (uint32_t t = 0; t < threads; ++t) {
+        all.Merge(histograms[t]);
+        dropped += drops[t];
+      }
+      // Logged calls only; dropped ones returned without doing the work.
+      const double calls_per_s = all.count() / elapsed_s;
+      const double drop_pct =
+          100.0 * dropped / (static_cast<double>(threads) * FLAGS_calls);
+      AINFO << "log_bench: backend=" << backend << " threads=" << threads
+            << " ns{" << all.Summary(1.0) << "} calls/s=" << calls_per_s
+            << " cpu=" << cpu_pct << "% dropped=" << dropped << " ("
+            << drop_pct << "%)";
+      if (output.is_open()) {
+        output.setf(std::ios::fixed);
+        output.precision(1);
+        output << "| " << backend << " | " << threads << " | " << all.mean()
+               << " | " << all.Percentile(50) << " | "
+               << all.Percentile(99) << " | " << all.Percentile(99.9)
+               << " | " << all.max() << " | " << calls_per_s << " | "
+               << cpu_pct << " | " << dropped << " | " << drop_pct << " |\n";
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
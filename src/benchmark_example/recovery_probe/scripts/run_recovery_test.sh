@@ -0,0 +1,73 @@
+#!/usr/bin/env bash
+# Kill the writer of a topic with SIGKILL and restart it right away, once
+# with the default segar.pb.conf and once with config/fast_recovery.pb.conf
+# (shorter lease and announcement period), while one reader stays up and
+# measures the time from each restart to the first delivered message
+# Usage: ./scripts/run_recovery_test.sh [restarts] [seconds_between_kills]
+# The results are collected in recovery_report.md next to the scripts
+# directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJ_DIR="$SCRIPT_DIR/../../../"
+PROBE_DIR="$SCRIPT_DIR/.."
+REPORT="$PROBE_DIR/recovery_report.md"
+RESTARTS="${1:-5}"
+SECONDS_BETWEEN_KILLS="${2:-5}"
+
+if [ ! -x "$PROBE_DIR/bin/recovery_probe" ]; then
+  echo "Error: recovery_probe not found: $PROBE_DIR/bin/recovery_probe"
+  exit 1
+fi
+rm -f "$REPORT"
+
+export LD_LIBRARY_PATH=$PROJ_DIR/third_party/lib:$PROJ_DIR/lib:$LD_LIBRARY_PATH
+export PATH=$PROJ_DIR/third_party/bin:$PATH
+export GLOG_log_dir="$PROJ_DIR/.segar/log"
+export GLOG_minloglevel=0
+export sysmo_start=0
+export SEGAR_DOMAIN_ID=0
+export SEGAR_IP=127.0.0.1
+mkdir -p "$GLOG_log_dir"
+
+# The runtime reads $SEGAR_PATH/config/segar.pb.conf, so every config gets
+# a directory of its own
+RUN_DIR="$(mktemp -d)"
+probe() {
+  SEGAR_PATH="$RUN_DIR/$1" "$PROBE_DIR/bin/recovery_probe" \
+    --flagfile="$PROBE_DIR/config/recovery_probe.flag" "${@:2}" \
+    > /dev/null 2>&1 &
+}
+
+# The reader writes the summary to its log when it shuts down
+stop_all() {
+  pkill -KILL -f "recovery_probe.*--role=writer" 2>/dev/null || true
+  pkill -INT -x recovery_probe 2>/dev/null || true
+  while pgrep -x recovery_probe > /dev/null; do
+    sleep 0.5
+  done
+}
+cleanup() {
+  stop_all
+  rm -rf "$RUN_DIR"
+}
+trap cleanup EXIT
+
+for config in segar fast_recovery; do
+  echo "--- $config.pb.conf, $RESTARTS restarts"
+  mkdir -p "$RUN_DIR/$config/config"
+  cp "$PROBE_DIR/config/$config.pb.conf" "$RUN_DIR/$config/config/segar.pb.conf"
+  probe $config --role=reader --label=$config --output="$REPORT"
+  for ((i = 0; i <= RESTARTS; ++i)); do
+    probe $config --role=writer
+    writer_pid=$!
+    sleep "$SECONDS_BETWEEN_KILLS"
+    kill -KILL $writer_pid 2>/dev/null || true
+    wait $writer_pid 2>/dev/null || true
+  done
+  stop_all
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
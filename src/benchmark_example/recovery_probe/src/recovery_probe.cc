@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Publisher restart test. The writer role publishes Payloads at a fixed rate
+// and stamps each one with its pid and the time the process started. The
+// reader role notices every new writer process and measures how long it took
+// from that start to the first delivered message (restart to first
+// delivery), how long the reader went without messages, and how many of the
+// new writer's messages were published before the first one arrived.
+
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(role, "reader", "writer or reader");
+DEFINE_string(topic, "/bench/recovery", "topic of the probe");
+DEFINE_uint32(period_ms, 1, "publish period of the writer");
+DEFINE_uint32(bytes, 64, "payload size, at least 8");
+DEFINE_string(label, "", "run label written to the report, e.g. the config");
+DEFINE_string(output, "", "markdown table the restarts are appended to");
+
+namespace {
+
+using Payload = example::msg::Payload;
+
+int RunWriter(uint64_t start_ns) {
+  auto node = rti::segar::CreateNode("recovery_writer");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<Payload>(FLAGS_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+
+  const uint32_t pid = static_cast<uint32_t>(getpid());
+  uint32_t seq = 0;
+  auto callback = [&]() {
+    auto msg = std::make_shared<Payload>();
+    msg->topic_id(pid);
+    msg->sequence_number(++seq);
+    msg->timestamp(example::common::MonotonicNs());
+    msg->data_size(FLAGS_bytes);
+    msg->data().resize(FLAGS_bytes);
+    std::memcpy(msg->data().data(), &start_ns, sizeof(start_ns));
+    writer->Write(msg);
+  };
+  auto timer =
+      std::make_shared<rti::segar::Timer>(FLAGS_period_ms, callback, false);
+  timer->Start();
+  AINFO << "recovery_probe: writer pid=" << pid << " started";
+  rti::segar::WaitForShutdown();
+  timer->Stop();
+  return EXIT_SUCCESS;
+}
+
+// Tracks the writer process the messages come from.
+class RestartTracker {
+ public:
+  void OnMessage(const Payload& msg) {
+    const uint64_t now = example::common::MonotonicNs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (msg.topic_id() != writer_pid_ && msg.data().size() >= 8) {
+      uint64_t start_ns = 0;
+      std::memcpy(&start_ns, msg.data().data(), sizeof(start_ns));
+      OnNewWriter(msg, now, start_ns);
+    }
+    last_ns_ = now;
+  }
+
+  std::string Summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return "restarts=" + std::to_string(recovery_.count()) +
+           " recovery_ms{" + recovery_.Summary(1e6) + "} outage_ms{" +
+           outage_.Summary(1e6) + "}";
+  }
+
+ private:
+  void OnNewWriter(const Payload& msg, uint64_t now, uint64_t start_ns) {
+    const bool restart = writer_pid_ != 0;
+    const uint64_t recovery_ns = now > start_ns ? now - start_ns : 0;
+    const uint64_t outage_ns = restart ? now - last_ns_ : 0;
+    // Messages the new writer published before the first one arrived.
+    const uint32_t lost = msg.sequence_number() - 1;
+    writer_pid_ = msg.topic_id();
+    if (restart) {
+      recovery_.Record(recovery_ns);
+      outage_.Record(outage_ns);
+    }
+    AINFO << "recovery_probe: writer pid=" << writer_pid_
+          << (restart ? " restart" : " start") << " recovery_ms="
+          << recovery_ns / 1e6 << " outage_ms=" << outage_ns / 1e6
+          << " lost=" << lost;
+    if (FLAGS_output.empty()) {
+      return;
+    }
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    std::ofstream output(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| run | writer | event | recovery ms | outage ms "
+                "| lost |\n"
+             << "|---|---|---|---|---|---|\n";
+    }
+    output.setf(std::ios::fixed);
+    output.precision(1);
+    output << "| " << FLAGS_label << " | " << writer_pid_ << " | "
+           << (restart ? "restart" : "start") << " | " << recovery_ns / 1e6
+           << " | ";
+    if (restart) {
+      output << outage_ns / 1e6;
+    } else {
+      output << "-";
+    }
+    output << " | " << lost << " |\n";
+  }
+
+  mutable std::mutex mutex_;
+  uint32_t writer_pid_ = 0;
+  uint64_t last_ns_ = 0;
+  example::common::LatencyHistogram recovery_;
+  example::common::LatencyHistogram outage_;
+};
+
+int RunReader() {
+  auto node = rti::segar::CreateNode("recovery_reader");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  RestartTracker tracker;
+  auto reader = node->CreateReader<Payload>(
+      FLAGS_topic, [&tracker](const std::shared_ptr<Payload>& msg) {
+        tracker.OnMessage(*msg);
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+  AINFO << "recovery_probe: reader waiting on " << FLAGS_topic;
+  rti::segar::WaitForShutdown();
+  AINFO << "recovery_probe: " << FLAGS_label << " " << tracker.Summary();
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // Taken before anything else, a restart starts here.
+  const uint64_t start_ns = example::common::MonotonicNs();
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_bytes < sizeof(start_ns) || FLAGS_period_ms == 0,
+                EXIT_FAILURE);
+  if (FLAGS_role == "writer") {
+    return RunWriter(start_ns);
+  }
+  RETURN_VAL_IF(FLAGS_role != "reader", EXIT_FAILURE);
+  return RunReader();
+}
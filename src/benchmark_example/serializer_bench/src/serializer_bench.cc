@@ -0,0 +1,279 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Serialization microbenchmark for the types in src/type_src/example: the
+// Fast-CDR serialize()/deserialize() msg_tool generates for them against
+// the POD layouts of common/example_pod_layouts.h. Reports ns/msg and GB/s
+// for encode and decode, per type and payload size.
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/example_pod_layouts.h"
+#include "common/proc_stats.h"
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "segar/segar.h"
+
+DEFINE_uint32(iterations, 100000, "encode/decode rounds per case");
+DEFINE_string(payload_sizes, "64,4096,65536,1048576",
+              "comma separated Payload data sizes in bytes");
+DEFINE_uint32(string_bytes, 32, "length of the string fields");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+using eprosima::fastcdr::Cdr;
+using example::action::LookUpTransform;
+using example::msg::Batch;
+using example::msg::CameraInfo;
+using example::msg::Compressed;
+using example::msg::Fragment;
+using example::msg::Image;
+using example::msg::LatencyAlert;
+using example::msg::Nack;
+using example::msg::Payload;
+using example::msg::String;
+using example::srv::PrioritizedWork;
+using example::srv::SetCameraInfo;
+
+struct Timing {
+  size_t bytes = 0;
+  double encode_ns = 0.0;
+  double decode_ns = 0.0;
+};
+
+template <typename Fn>
+double NsPerCall(Fn&& fn) {
+  const uint64_t start = example::common::MonotonicNs();
+  for (uint32_t i = 0; i < FLAGS_iterations; ++i) {
+    fn();
+  }
+  return static_cast<double>(example::common::MonotonicNs() - start) /
+         FLAGS_iterations;
+}
+
+template <typename T>
+bool RunCdr(const T& msg, std::vector<char>* buffer, Timing* result) {
+  try {
+    size_t length = 0;
+    result->encode_ns = NsPerCall([&]() {
+      eprosima::fastcdr::FastBuffer fast_buffer(buffer->data(),
+                                                buffer->size());
+      Cdr cdr(fast_buffer);
+      cdr.serialize_encapsulation();
+      msg.serialize(cdr);
+      length = cdr.get_serialized_data_length();
+    });
+    result->bytes = length;
+    T decoded;
+    result->decode_ns = NsPerCall([&]() {
+      eprosima::fastcdr::FastBuffer fast_buffer(buffer->data(), length);
+      Cdr cdr(fast_buffer);
+      cdr.deserialize_encapsulation();
+      decoded.deserialize(cdr);
+    });
+  } catch (const std::exception& e) {
+    AERROR << "serializer_bench: Fast-CDR failed: " << e.what();
+    return false;
+  }
+  return true;
+}
+
+template <typename T>
+bool RunPod(const T& msg, std::vector<char>* buffer, Timing* result) {
+  auto* data = reinterpret_cast<uint8_t*>(buffer->data());
+  size_t length = 0;
+  result->encode_ns = NsPerCall([&]() {
+    length = example::common::PodEncode(msg, data, buffer->size());
+  });
+  result->bytes = length;
+  T decoded;
+  size_t consumed = 0;
+  result->decode_ns = NsPerCall([&]() {
+    consumed = example::common::PodDecode(data, length, &decoded);
+  });
+  // Round trip check: the decoded message encodes to the same bytes.
+  std::vector<uint8_t> again;
+  example::common::PodEncode(decoded, &again);
+  return length != 0 && consumed == length && again.size() == length &&
+         std::memcmp(again.data(), data, length) == 0;
+}
+
+class Report {
+ public:
+  Report() {
+    if (FLAGS_output.empty()) {
+      return;
+    }
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output_.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output_ << "| type | codec | bytes | encode ns | decode ns "
+                 "| encode GB/s | decode GB/s |\n"
+              << "|---|---|---|---|---|---|---|\n";
+    }
+    output_.setf(std::ios::fixed);
+    output_.precision(2);
+  }
+
+  void Add(const std::string& type, const std::string& codec,
+           const Timing& result) {
+    const double encode_gbps = result.bytes / result.encode_ns;
+    const double decode_gbps = result.bytes / result.decode_ns;
+    AINFO << "serializer_bench: " << type << " " << codec
+          << " bytes=" << result.bytes << " encode_ns=" << result.encode_ns
+          << " decode_ns=" << result.decode_ns << " encode_GB/s="
+          << encode_gbps << " decode_GB/s=" << decode_gbps;
+    if (output_.is_open()) {
+      output_ << "| " << type << " | " << codec << " | " << result.bytes
+              << " | " << result.encode_ns << " | " << result.decode_ns
+              << " | " << encode_gbps << " | " << decode_gbps << " |\n";
+    }
+  }
+
+ private:
+  std::ofstream output_;
+};
+
+template <typename T>
+bool Run(const std::string& type, const T& msg, Report* report) {
+  // Room for the CDR alignment padding and encapsulation header.
+  std::vector<char> buffer(example::common::PodEncodedSize(msg) * 2 + 1024);
+  Timing cdr;
+  Timing pod;
+  if (!RunCdr(msg, &buffer, &cdr) || !RunPod(msg, &buffer, &pod)) {
+    AERROR << "serializer_bench: " << type << " failed";
+    return false;
+  }
+  report->Add(type, "fastcdr", cdr);
+  report->Add(type, "pod", pod);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_iterations == 0, EXIT_FAILURE);
+
+  const std::string text(FLAGS_string_bytes, 'x');
+  Report report;
+  bool ok = true;
+
+  Image image;
+  image.width(1920);
+  image.timestamp(1);
+  ok = Run("Image", image, &report) && ok;
+
+  String str;
+  str.data(text);
+  ok = Run("String", str, &report) && ok;
+
+  CameraInfo camera_info;
+  camera_info.camera_name(text);
+  camera_info.width(1920);
+  ok = Run("CameraInfo", camera_info, &report) && ok;
+
+  SetCameraInfo::Request request;
+  request.camera_info(camera_info);
+  ok = Run("SetCameraInfo::Request", request, &report) && ok;
+
+  SetCameraInfo::Response response;
+  response.success(true);
+  response.status_message(text);
+  ok = Run("SetCameraInfo::Response", response, &report) && ok;
+
+  LookUpTransform::Goal goal;
+  goal.target_frame(text);
+  goal.source_frame(text);
+  goal.advanced(true);
+  ok = Run("LookUpTransform::Goal", goal, &report) && ok;
+
+  LookUpTransform::Result result;
+  result.transform(text);
+  result.error(0);
+  ok = Run("LookUpTransform::Result", result, &report) && ok;
+
+  LookUpTransform::Feedback feedback;
+  feedback.current(50);
+  ok = Run("LookUpTransform::Feedback", feedback, &report) && ok;
+
+  LatencyAlert alert;
+  alert.stage(text);
+  alert.timestamp(1);
+  alert.latency_ns(2000000);
+  alert.budget_ns(1000000);
+  alert.violations(3);
+  ok = Run("LatencyAlert", alert, &report) && ok;
+
+  Nack nack;
+  nack.stream_id(1);
+  for (uint32_t i = 0; i < 16; ++i) {
+    nack.missing().push_back(i * 2);
+  }
+  ok = Run("Nack", nack, &report) && ok;
+
+  PrioritizedWork::Request work;
+  work.priority(10);
+  work.work_us(100);
+  work.timestamp(1);
+  ok = Run("PrioritizedWork::Request", work, &report) && ok;
+
+  PrioritizedWork::Response done;
+  done.success(true);
+  done.queued_ns(1000);
+  ok = Run("PrioritizedWork::Response", done, &report) && ok;
+
+  std::istringstream sizes(FLAGS_payload_sizes);
+  std::string item;
+  while (std::getline(sizes, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    const auto bytes = static_cast<uint32_t>(std::stoul(item));
+    const std::vector<uint8_t> data(bytes, 0x5a);
+    Payload payload;
+    payload.topic_id(1);
+    payload.timestamp(example::common::MonotonicNs());
+    payload.data_size(bytes);
+    payload.data() = data;
+    ok = Run("Payload " + item + "B", payload, &report) && ok;
+
+    // The carriers of other messages, with the same amount of data.
+    Batch batch;
+    batch.count(1);
+    batch.first_timestamp(payload.timestamp());
+    batch.data() = data;
+    ok = Run("Batch " + item + "B", batch, &report) && ok;
+
+    Compressed compressed;
+    compressed.raw_size(bytes);
+    compressed.timestamp(payload.timestamp());
+    compressed.sequence_number(1);
+    compressed.data() = data;
+    ok = Run("Compressed " + item + "B", compressed, &report) && ok;
+
+    Fragment fragment;
+    fragment.stream_id(1);
+    fragment.timestamp(payload.timestamp());
+    fragment.total_size(bytes);
+    fragment.fragment_count(1);
+    fragment.fragment_size(bytes);
+    fragment.data() = data;
+    ok = Run("Fragment " + item + "B", fragment, &report) && ok;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
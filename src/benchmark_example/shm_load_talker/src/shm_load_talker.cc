@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topic, "/bench/mixed", "topic to publish on");
+DEFINE_uint32(rate_hz, 100, "publish rate, at most 1000");
+DEFINE_uint32(min_bytes, 4096, "smallest payload size");
+DEFINE_uint32(max_bytes, 1048576, "largest payload size");
+DEFINE_uint32(seed, 1, "random seed of the size distribution");
+DEFINE_uint32(report_interval_s, 5, "interval of the footprint report");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_rate_hz == 0 || FLAGS_rate_hz > 1000, EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_min_bytes == 0 || FLAGS_min_bytes > FLAGS_max_bytes,
+                EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("shm_load_talker");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Payload>(FLAGS_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+
+  // Log-uniform sizes: every size class between min and max is hit about
+  // equally often, which is the worst case for a single fixed block size.
+  std::mt19937 rng(FLAGS_seed);
+  std::uniform_real_distribution<double> log_size(
+      std::log(static_cast<double>(FLAGS_min_bytes)),
+      std::log(static_cast<double>(FLAGS_max_bytes)));
+  uint32_t seq = 0;
+  uint32_t failed = 0;
+  const uint32_t report_every =
+      std::max<uint32_t>(1, FLAGS_report_interval_s * FLAGS_rate_hz);
+  auto callback = [&]() {
+    auto size = static_cast<uint32_t>(std::exp(log_size(rng)));
+    size = std::min(std::max(size, FLAGS_min_bytes), FLAGS_max_bytes);
+    auto msg = std::make_shared<example::msg::Payload>();
+    msg->sequence_number(seq++);
+    msg->data_size(size);
+    msg->data().resize(size, static_cast<uint8_t>(seq));
+    msg->timestamp(example::common::MonotonicNs());
+    if (!writer->Write(msg)) {
+      ++failed;
+    }
+    if (seq % report_every == 0) {
+      AINFO << "shm_load_talker: sent=" << seq << " failed=" << failed << " "
+            << example::common::ToString(example::common::ReadProcessStats());
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(1000 / FLAGS_rate_hz,
+                                                   callback, false);
+  timer->Start();
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Subscribes to a set of Payload topics, keeps per-topic size and rate
+// statistics and derives a block_num for each topic. The decisions are logged
+// every report interval and written as a suggested topics.pb.conf that can be
+// merged into config/topics.pb.conf.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+#include "common/size_class_histogram.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(topics, "/bench/mixed", "comma separated topics to profile");
+DEFINE_uint32(report_interval_s, 5, "interval of decisions and reports");
+DEFINE_double(hold_time_ms, 50.0,
+              "how long a reader keeps a block before releasing it");
+DEFINE_double(headroom, 1.5, "safety factor applied to the block estimate");
+DEFINE_uint32(min_block_num, 2, "smallest block_num suggested");
+DEFINE_uint32(max_block_num, 64, "largest block_num suggested");
+DEFINE_string(output, "topics.pb.conf.suggested",
+              "path of the suggested topics.pb.conf");
+
+namespace {
+
+using example::common::SizeClassHistogram;
+
+struct TopicProfile {
+  std::string topic;
+  std::mutex mutex;
+  SizeClassHistogram window_sizes;
+  SizeClassHistogram total_sizes;
+  uint64_t window_count = 0;
+  uint64_t received = 0;
+  uint64_t lost = 0;
+  bool has_last_seq = false;
+  uint32_t last_seq = 0;
+  double peak_rate_hz = 0.0;
+  uint32_t block_num = 0;
+};
+
+void OnMessage(TopicProfile* profile, const example::msg::Payload& msg) {
+  rti::segar::LockGuard<std::mutex> lock(profile->mutex);
+  const uint64_t size = msg.data().size();
+  profile->window_sizes.Add(size);
+  profile->total_sizes.Add(size);
+  ++profile->window_count;
+  ++profile->received;
+  const uint32_t seq = msg.sequence_number();
+  if (profile->has_last_seq && seq > profile->last_seq + 1) {
+    profile->lost += seq - profile->last_seq - 1;
+  }
+  if (!profile->has_last_seq || seq > profile->last_seq) {
+    profile->last_seq = seq;
+  }
+  profile->has_last_seq = true;
+}
+
+// Blocks in flight ~= arrival rate x hold time (Little's law): the runtime
+// sizes the blocks itself and a message takes one of them, whatever its
+// size. The peak rate is used so that bursts do not run the pool dry.
+uint32_t SuggestBlockNum(double peak_rate_hz) {
+  const double in_flight =
+      peak_rate_hz * FLAGS_hold_time_ms / 1000.0 * FLAGS_headroom;
+  const auto blocks = static_cast<uint32_t>(std::ceil(in_flight));
+  return std::min(std::max(blocks, FLAGS_min_block_num), FLAGS_max_block_num);
+}
+
+void Report(const std::vector<std::unique_ptr<TopicProfile>>& profiles,
+            double window_s) {
+  std::ostringstream conf;
+  conf << "# Suggested by shm_sizing_advisor (hold_time_ms="
+       << FLAGS_hold_time_ms << ", headroom=" << FLAGS_headroom << ")\n"
+       << "topics: [\n";
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    auto& profile = *profiles[i];
+    rti::segar::LockGuard<std::mutex> lock(profile.mutex);
+    const double rate_hz = profile.window_count / window_s;
+    profile.peak_rate_hz = std::max(profile.peak_rate_hz, rate_hz);
+    const uint32_t block_num = SuggestBlockNum(profile.peak_rate_hz);
+    const uint64_t expected = profile.received + profile.lost;
+    const double drop_pct =
+        expected == 0 ? 0.0 : 100.0 * profile.lost / expected;
+    AINFO << "[" << profile.topic << "] rate=" << rate_hz
+          << "Hz peak=" << profile.peak_rate_hz << "Hz size p50="
+          << SizeClassHistogram::HumanSize(profile.window_sizes.Percentile(50))
+          << " p99="
+          << SizeClassHistogram::HumanSize(profile.window_sizes.Percentile(99))
+          << " max=" << profile.window_sizes.max() << "B drop=" << drop_pct
+          << "% classes={" << profile.window_sizes.ToString() << "}";
+    AINFO_IF(block_num != profile.block_num)
+        << "[" << profile.topic << "] block_num " << profile.block_num
+        << " -> " << block_num;
+    profile.block_num = block_num;
+    profile.window_sizes.Reset();
+    profile.window_count = 0;
+
+    conf << "    {\n"
+         << "        # size p99="
+         << SizeClassHistogram::HumanSize(profile.total_sizes.Percentile(99))
+         << " max=" << profile.total_sizes.max()
+         << "B peak_rate=" << profile.peak_rate_hz << "Hz\n"
+         << "        # size classes, for information: {"
+         << profile.total_sizes.ToString() << "}\n"
+         << "        topic: \"" << profile.topic << "\"\n"
+         << "        block_num: " << block_num << "\n"
+         << "    }" << (i + 1 < profiles.size() ? "," : "") << "\n";
+  }
+  conf << "]\n";
+  AINFO << "shm_sizing_advisor: "
+        << example::common::ToString(example::common::ReadProcessStats());
+
+  std::ofstream out(FLAGS_output, std::ios::trunc);
+  AERROR_IF(!(out << conf.str())) << "Failed to write " << FLAGS_output;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_report_interval_s == 0, EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("shm_sizing_advisor");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+
+  std::vector<std::unique_ptr<TopicProfile>> profiles;
+  std::vector<std::shared_ptr<rti::segar::Reader<example::msg::Payload>>>
+      readers;
+  std::istringstream topics(FLAGS_topics);
+  std::string topic;
+  while (std::getline(topics, topic, ',')) {
+    if (topic.empty()) {
+      continue;
+    }
+    profiles.push_back(std::make_unique<TopicProfile>());
+    auto* profile = profiles.back().get();
+    profile->topic = topic;
+    auto reader = node->CreateReader<example::msg::Payload>(
+        topic, [profile](const auto& msg) { OnMessage(profile, *msg); });
+    RETURN_VAL_IF(!reader, EXIT_FAILURE);
+    readers.push_back(reader);
+  }
+  RETURN_VAL_IF(profiles.empty(), EXIT_FAILURE);
+
+  const double window_s = FLAGS_report_interval_s;
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000,
+      [&profiles, window_s]() { Report(profiles, window_s); }, false);
+  timer->Start();
+  AINFO << "Profiling " << profiles.size() << " topic(s), writing "
+        << FLAGS_output;
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
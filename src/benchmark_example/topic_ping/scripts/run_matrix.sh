@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+# Run the ping-pong benchmark with huge page backed SHM and NUMA placement on
+# and off
+# Usage: ./scripts/run_matrix.sh [ping_cpuset] [pong_cpuset]
+# The results are collected in ping_pong_report.md next to the scripts directory
+# Switching the SHM huge pages needs write access to
+# /sys/kernel/mm/transparent_hugepage/shmem_enabled (root); without it only
+# the current setting is measured.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PONG_LAUNCH="$SCRIPT_DIR/../../topic_pong/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../ping_pong_report.md"
+PING_CPUSET="${1:-}"
+PONG_CPUSET="${2:-}"
+SHMEM_ENABLED=/sys/kernel/mm/transparent_hugepage/shmem_enabled
+
+if [ ! -f "$PONG_LAUNCH" ]; then
+  echo "Error: topic_pong not found: $PONG_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+SHMEM_BEFORE="$(sed -n 's/.*\[\(.*\)\].*/\1/p' "$SHMEM_ENABLED" 2>/dev/null || true)"
+if [ -n "$SHMEM_BEFORE" ] && [ -w "$SHMEM_ENABLED" ]; then
+  SHMEM_MODES="never within_size"
+else
+  echo "Warning: cannot switch $SHMEM_ENABLED, measuring '${SHMEM_BEFORE:-unknown}' only"
+  SHMEM_MODES="${SHMEM_BEFORE:-unknown}"
+fi
+
+stop_pong() {
+  pkill -x topic_pong 2>/dev/null || true
+  while pgrep -x topic_pong > /dev/null; do
+    sleep 0.5
+  done
+}
+restore() {
+  stop_pong
+  if [ -n "$SHMEM_BEFORE" ] && [ -w "$SHMEM_ENABLED" ]; then
+    echo "$SHMEM_BEFORE" > "$SHMEM_ENABLED"
+  fi
+}
+trap restore EXIT
+
+for shmem in $SHMEM_MODES; do
+  if [ -w "$SHMEM_ENABLED" ]; then
+    echo "$shmem" > "$SHMEM_ENABLED"
+  fi
+  for numa_policy in none local; do
+    echo "--- shmem_huge_pages=$shmem numa_policy=$numa_policy"
+    # Both processes start fresh, so the SHM segments of the topics are
+    # created under the setting of this run.
+    bash "$PONG_LAUNCH" --numa_policy=$numa_policy --cpuset=$PONG_CPUSET > /dev/null 2>&1 &
+    bash "$SCRIPT_DIR/launch.sh" --numa_policy=$numa_policy \
+      --cpuset=$PING_CPUSET --output="$REPORT"
+    stop_pong
+  done
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
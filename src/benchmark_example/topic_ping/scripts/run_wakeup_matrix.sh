@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# Compare sleeping and polling wake-up of the ping side for small messages
+# Usage: ./scripts/run_wakeup_matrix.sh [poll_cpu] [spin_budget_us]
+# The results are collected in wakeup_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PONG_LAUNCH="$SCRIPT_DIR/../../topic_pong/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../wakeup_report.md"
+POLL_CPU="${1:--1}"
+SPIN_BUDGET_US="${2:-50}"
+
+if [ ! -f "$PONG_LAUNCH" ]; then
+  echo "Error: topic_pong not found: $PONG_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+stop_pong() {
+  pkill -x topic_pong 2>/dev/null || true
+  while pgrep -x topic_pong > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_pong EXIT
+
+bash "$PONG_LAUNCH" > /dev/null 2>&1 &
+for rate_hz in 1000 10000; do
+  for wake_mode in sleep hybrid spin; do
+    echo "--- rate_hz=$rate_hz wake_mode=$wake_mode"
+    bash "$SCRIPT_DIR/launch.sh" --sizes=64,256,1024,4096 \
+      --rate_hz=$rate_hz --iterations=$((rate_hz * 10)) \
+      --wake_mode=$wake_mode --spin_budget_us=$SPIN_BUDGET_US \
+      --poll_cpu=$POLL_CPU --output="$REPORT"
+  done
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Ping side of the ping-pong benchmark described in the Segar vs ROS2 topic
+// test report: sends a Payload, waits for topic_pong to echo it and records
+// the round trip time, for every configured payload size.
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/cpu_topology.h"
+#include "common/hybrid_waiter.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(ping_topic, "/bench/ping", "topic the pings are sent on");
+DEFINE_string(pong_topic, "/bench/pong", "topic the echoes arrive on");
+DEFINE_string(sizes, "64,256,1024,4096,16384,65536,262144,1048576",
+              "comma separated payload sizes in bytes");
+DEFINE_uint32(iterations, 10000, "round trips per payload size");
+DEFINE_uint32(warmup, 100, "round trips before measuring");
+DEFINE_uint32(timeout_ms, 1000, "time to wait for one echo");
+DEFINE_uint32(rate_hz, 0, "pings per second, 0 sends back to back");
+DEFINE_string(wake_mode, "sleep",
+              "how the main thread waits for echoes: sleep, spin or hybrid");
+DEFINE_uint32(spin_budget_us, 50, "polling budget of --wake_mode=hybrid");
+DEFINE_int32(poll_cpu, -1, "cpu the waiting main thread is pinned to");
+DEFINE_string(numa_policy, "none",
+              "memory placement: none, local, interleave or node");
+DEFINE_int32(numa_node, 0, "node used by --numa_policy=node");
+DEFINE_string(cpuset, "", "cpus to run on, e.g. \"0-7,16-23\"");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+// Hands the sequence number of the latest echo from the reader callback to
+// the main thread, which waits through a HybridWaiter.
+class EchoWaiter {
+ public:
+  EchoWaiter(example::common::HybridWaiter::Mode mode,
+             std::chrono::nanoseconds spin_budget)
+      : waiter_(mode, spin_budget) {}
+
+  void OnEcho(uint32_t seq) {
+    last_seq_.store(seq, std::memory_order_release);
+    waiter_.Notify();
+  }
+
+  bool Wait(uint32_t seq, std::chrono::nanoseconds timeout) {
+    const uint64_t deadline = example::common::MonotonicNs() + timeout.count();
+    for (;;) {
+      // Read the counter first: an echo stored after this read also moves
+      // the counter, so WaitChanged cannot miss it.
+      const uint32_t observed = waiter_.sequence();
+      if (last_seq_.load(std::memory_order_acquire) == seq) {
+        return true;
+      }
+      const uint64_t now = example::common::MonotonicNs();
+      if (now >= deadline) {
+        return false;
+      }
+      waiter_.WaitChanged(observed, std::chrono::nanoseconds(deadline - now));
+    }
+  }
+
+  const example::common::HybridWaiter& waiter() const { return waiter_; }
+
+ private:
+  example::common::HybridWaiter waiter_;
+  std::atomic<uint32_t> last_seq_{0};
+};
+
+bool ParseSizes(const std::string& list, std::vector<uint32_t>* sizes) {
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (!item.empty()) {
+      sizes->push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+  }
+  return !sizes->empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  using example::common::NumaPolicy;
+
+  std::vector<uint32_t> sizes;
+  RETURN_VAL_IF(!ParseSizes(FLAGS_sizes, &sizes), EXIT_FAILURE);
+  NumaPolicy numa_policy;
+  RETURN_VAL_IF(
+      !example::common::ParseNumaPolicy(FLAGS_numa_policy, &numa_policy),
+      EXIT_FAILURE);
+  example::common::HybridWaiter::Mode wake_mode;
+  RETURN_VAL_IF(
+      !example::common::HybridWaiter::ParseMode(FLAGS_wake_mode, &wake_mode),
+      EXIT_FAILURE);
+  std::vector<int> cpus;
+  if (!FLAGS_cpuset.empty()) {
+    RETURN_VAL_IF(!example::common::ParseCpuset(FLAGS_cpuset, &cpus),
+                  EXIT_FAILURE);
+    RETURN_VAL_IF(!example::common::PinCurrentThread(cpus), EXIT_FAILURE);
+  } else {
+    cpus = example::common::CurrentCpus();
+  }
+  // Placement is set up before Init so the runtime threads and the SHM
+  // segments this process writes first inherit it.
+  RETURN_VAL_IF(!example::common::ApplyNumaPolicy(numa_policy, cpus,
+                                                  FLAGS_numa_node),
+                EXIT_FAILURE);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  // Pinned after Init so that only the polling thread gets the cpu.
+  RETURN_VAL_IF(FLAGS_poll_cpu >= 0 &&
+                    !example::common::PinCurrentThread({FLAGS_poll_cpu}),
+                EXIT_FAILURE);
+
+  // The published memory is the SHM segments of the topics, whose huge page
+  // use is the system wide shmem setting; Payload::data() is a std::vector
+  // that takes no allocator. The report names the setting of the run.
+  const std::string shmem_huge_pages = example::common::ShmemHugePageSetting();
+  const uint32_t max_size = *std::max_element(sizes.begin(), sizes.end());
+  std::vector<uint8_t> source(max_size);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<uint8_t>(i);
+  }
+  AINFO << "topic_ping: shmem_huge_pages=" << shmem_huge_pages
+        << " numa_policy=" << FLAGS_numa_policy
+        << " numa_nodes=" << example::common::NumaNodeCount();
+
+  auto node = rti::segar::CreateNode("topic_ping");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Payload>(FLAGS_ping_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+  EchoWaiter waiter(wake_mode,
+                    std::chrono::microseconds(FLAGS_spin_budget_us));
+  auto reader = node->CreateReader<example::msg::Payload>(
+      FLAGS_pong_topic,
+      [&waiter](const auto& msg) { waiter.OnEcho(msg->sequence_number()); });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+
+  const std::chrono::milliseconds timeout(FLAGS_timeout_ms);
+  uint32_t seq = 0;
+  auto make_msg = [&source](uint32_t size) {
+    auto msg = std::make_shared<example::msg::Payload>();
+    msg->data_size(size);
+    msg->data().assign(source.begin(), source.begin() + size);
+    return msg;
+  };
+  auto round_trip = [&](const std::shared_ptr<example::msg::Payload>& msg) {
+    msg->sequence_number(++seq);
+    msg->timestamp(example::common::MonotonicNs());
+    return writer->Write(msg) && waiter.Wait(seq, timeout);
+  };
+
+  // Discovery: keep pinging until topic_pong answers.
+  uint32_t answered = 0;
+  for (uint32_t attempt = 0; answered < FLAGS_warmup; ++attempt) {
+    RETURN_VAL_IF(attempt > FLAGS_warmup + 60, EXIT_FAILURE);
+    answered += round_trip(make_msg(sizes.front())) ? 1 : 0;
+  }
+
+  std::ofstream output;
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| size | rate_hz | wake | shmem_huge_pages | numa | msg/s "
+                "| MB/s | avg us | min us | max us | p50 us | p99 us "
+                "| p99.9 us | cpu % | lost |\n"
+             << "|---|---|---|---|---|---|---|---|---|---|---|---|---|---|"
+                "---|\n";
+    }
+  }
+
+  const uint64_t period_ns =
+      FLAGS_rate_hz == 0 ? 0 : 1000000000ULL / FLAGS_rate_hz;
+  for (uint32_t size : sizes) {
+    example::common::LatencyHistogram rtt;
+    uint32_t lost = 0;
+    const auto cpu_before = example::common::ReadProcessStats();
+    const uint64_t start = example::common::MonotonicNs();
+    for (uint32_t i = 0; i < FLAGS_iterations; ++i) {
+      auto msg = make_msg(size);
+      if (period_ns != 0) {
+        const uint64_t due = start + i * period_ns;
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(due / 1000000000ULL);
+        ts.tv_nsec = static_cast<long>(due % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+      }
+      if (round_trip(msg)) {
+        rtt.Record(example::common::MonotonicNs() - msg->timestamp());
+      } else {
+        ++lost;
+      }
+    }
+    const double elapsed_s =
+        (example::common::MonotonicNs() - start) / 1e9;
+    const double cpu_pct = 100.0 *
+                           (example::common::ReadProcessStats().CpuSeconds() -
+                            cpu_before.CpuSeconds()) /
+                           elapsed_s;
+    const double msg_per_s = rtt.count() / elapsed_s;
+    const double mb_per_s =
+        static_cast<double>(size) * rtt.count() / (1024.0 * 1024.0) /
+        elapsed_s;
+    AINFO << "topic_ping: size=" << size << "B rate_hz=" << FLAGS_rate_hz
+          << " wake=" << FLAGS_wake_mode << " msg/s=" << msg_per_s
+          << " MB/s=" << mb_per_s << " rtt_us{" << rtt.Summary()
+          << "} cpu=" << cpu_pct << "% lost=" << lost;
+    if (output.is_open()) {
+      output.setf(std::ios::fixed);
+      output.precision(2);
+      output << "| " << size << " | " << FLAGS_rate_hz << " | "
+             << FLAGS_wake_mode << " | " << shmem_huge_pages << " | "
+             << FLAGS_numa_policy << " | " << msg_per_s << " | " << mb_per_s
+             << " | " << rtt.mean() / 1000.0 << " | " << rtt.min() / 1000.0
+             << " | " << rtt.max() / 1000.0 << " | "
+             << rtt.Percentile(50) / 1000.0 << " | "
+             << rtt.Percentile(99) / 1000.0 << " | "
+             << rtt.Percentile(99.9) / 1000.0 << " | " << cpu_pct << " | "
+             << lost << " |\n";
+    }
+  }
+  AINFO << "topic_ping: wake-ups by polling="
+        << waiter.waiter().spin_wakeups()
+        << " by sleeping=" << waiter.waiter().sleep_wakeups();
+  AINFO << "topic_ping: "
+        << example::common::ToString(example::common::ReadProcessStats());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Pong side of the ping-pong benchmark: echoes every ping unchanged so the
+// measured round trip only contains middleware overhead.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/cpu_topology.h"
+#include "example/msg/Payload.hpp"
+
+#include "segar/segar.h"
+
+DEFINE_string(ping_topic, "/bench/ping", "topic the pings arrive on");
+DEFINE_string(pong_topic, "/bench/pong", "topic the echoes are sent on");
+DEFINE_string(numa_policy, "none",
+              "memory placement: none, local, interleave or node");
+DEFINE_int32(numa_node, 0, "node used by --numa_policy=node");
+DEFINE_string(cpuset, "", "cpus to run on, e.g. \"0-7,16-23\"");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  example::common::NumaPolicy numa_policy;
+  RETURN_VAL_IF(
+      !example::common::ParseNumaPolicy(FLAGS_numa_policy, &numa_policy),
+      EXIT_FAILURE);
+  std::vector<int> cpus;
+  if (!FLAGS_cpuset.empty()) {
+    RETURN_VAL_IF(!example::common::ParseCpuset(FLAGS_cpuset, &cpus),
+                  EXIT_FAILURE);
+    RETURN_VAL_IF(!example::common::PinCurrentThread(cpus), EXIT_FAILURE);
+  } else {
+    cpus = example::common::CurrentCpus();
+  }
+  RETURN_VAL_IF(!example::common::ApplyNumaPolicy(numa_policy, cpus,
+                                                  FLAGS_numa_node),
+                EXIT_FAILURE);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("topic_pong");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+  auto writer = node->CreateWriter<example::msg::Payload>(FLAGS_pong_topic);
+  RETURN_VAL_IF(!writer, EXIT_FAILURE);
+  auto reader = node->CreateReader<example::msg::Payload>(
+      FLAGS_ping_topic, [&writer](const auto& msg) {
+        AERROR_IF(!writer->Write(msg))
+            << "Failed to echo seq:" << msg->sequence_number();
+      });
+  RETURN_VAL_IF(!reader, EXIT_FAILURE);
+  AINFO << "Waiting for pings...";
+  rti::segar::WaitForShutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,471 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+// Synchronization for Segar tasks that suspends the waiting coroutine on a
+// TaskEvent instead of blocking or spinning its processor: CoMutex,
+// CoRwLock, CoSemaphore, BoundedChannel (MPMC) and SpscChannel.
+//
+// Waiters queue up and are woken one by one with the resource already handed
+// to them, so a release wakes exactly the coroutine that gets it and a woken
+// waiter never has to compete again. The short internal std::mutex only
+// guards the wait queues and is never held while a coroutine is suspended.
+// The uncontended paths of CoMutex and SpscChannel are a single atomic
+// operation. Waits re-check their condition at least every
+// kCoWaitPollInterval, so a notification that races with the start of a
+// wait delays the waiter at most by that much.
+
+namespace example {
+namespace common {
+
+constexpr std::chrono::milliseconds kCoWaitPollInterval(1);
+
+namespace co_sync_internal {
+
+// One suspended coroutine. Shared between the waiter and the waker so that
+// the waker may still touch it after the waiter has resumed and returned.
+class Waiter {
+ public:
+  void Wake() {
+    ready_.store(true, std::memory_order_release);
+    event_.Notify();
+  }
+
+  void Wait() {
+    while (!ready_.load(std::memory_order_acquire)) {
+      event_.Wait(kCoWaitPollInterval);
+    }
+  }
+
+ private:
+  rti::segar::TaskEvent event_;
+  std::atomic<bool> ready_{false};
+};
+
+using WaiterQueue = std::deque<std::shared_ptr<Waiter>>;
+
+}  // namespace co_sync_internal
+
+// Mutex for code running in Segar tasks; usable with std::lock_guard and
+// std::unique_lock. Ownership passes directly to the longest waiting
+// coroutine.
+class CoMutex {
+ public:
+  CoMutex() = default;
+  CoMutex(const CoMutex&) = delete;
+  CoMutex& operator=(const CoMutex&) = delete;
+
+  bool try_lock() {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void lock() {
+    for (int i = 0; i < kSpinTries; ++i) {
+      if (try_lock()) {
+        return;
+      }
+    }
+    auto waiter = std::make_shared<co_sync_internal::Waiter>();
+    {
+      rti::segar::LockGuard<std::mutex> guard(queue_mutex_);
+      waiters_.fetch_add(1);
+      if (!locked_.exchange(true)) {
+        waiters_.fetch_sub(1);
+        return;
+      }
+      queue_.push_back(waiter);
+    }
+    contended_.fetch_add(1, std::memory_order_relaxed);
+    waiter->Wait();
+  }
+
+  void unlock() {
+    if (waiters_.load() == 0) {
+      locked_.store(false);
+      // A waiter that registered before the store either took the lock
+      // itself or is queued; in the second case take the lock back and
+      // hand it over.
+      if (waiters_.load() == 0 || locked_.exchange(true)) {
+        return;
+      }
+    }
+    std::shared_ptr<co_sync_internal::Waiter> next;
+    {
+      rti::segar::LockGuard<std::mutex> guard(queue_mutex_);
+      if (queue_.empty()) {
+        locked_.store(false);
+        return;
+      }
+      next = std::move(queue_.front());
+      queue_.pop_front();
+      waiters_.fetch_sub(1);
+    }
+    next->Wake();
+  }
+
+  // Number of lock() calls that had to suspend.
+  uint64_t contended() const {
+    return contended_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int kSpinTries = 16;
+
+  std::atomic<bool> locked_{false};
+  std::atomic<uint32_t> waiters_{0};
+  std::atomic<uint64_t> contended_{0};
+  std::mutex queue_mutex_;
+  co_sync_internal::WaiterQueue queue_;
+};
+
+// Reader-writer lock; usable with std::shared_lock. A waiting writer blocks
+// new readers, and the readers waiting when a writer unlocks are admitted
+// together, so neither side starves.
+class CoRwLock {
+ public:
+  CoRwLock() = default;
+  CoRwLock(const CoRwLock&) = delete;
+  CoRwLock& operator=(const CoRwLock&) = delete;
+
+  void lock_shared() {
+    std::shared_ptr<co_sync_internal::Waiter> waiter;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (!writer_ && writers_.empty()) {
+        ++readers_;
+        return;
+      }
+      waiter = std::make_shared<co_sync_internal::Waiter>();
+      readers_waiting_.push_back(waiter);
+    }
+    waiter->Wait();
+  }
+
+  void unlock_shared() {
+    std::shared_ptr<co_sync_internal::Waiter> next;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (--readers_ > 0 || writers_.empty()) {
+        return;
+      }
+      next = std::move(writers_.front());
+      writers_.pop_front();
+      writer_ = true;
+    }
+    next->Wake();
+  }
+
+  void lock() {
+    std::shared_ptr<co_sync_internal::Waiter> waiter;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (!writer_ && readers_ == 0) {
+        writer_ = true;
+        return;
+      }
+      waiter = std::make_shared<co_sync_internal::Waiter>();
+      writers_.push_back(waiter);
+    }
+    waiter->Wait();
+  }
+
+  void unlock() {
+    co_sync_internal::WaiterQueue wake;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      writer_ = false;
+      if (!readers_waiting_.empty()) {
+        readers_ += static_cast<uint32_t>(readers_waiting_.size());
+        wake.swap(readers_waiting_);
+      } else if (!writers_.empty()) {
+        writer_ = true;
+        wake.push_back(std::move(writers_.front()));
+        writers_.pop_front();
+      }
+    }
+    for (const auto& waiter : wake) {
+      waiter->Wake();
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  uint32_t readers_ = 0;
+  bool writer_ = false;
+  co_sync_internal::WaiterQueue readers_waiting_;
+  co_sync_internal::WaiterQueue writers_;
+};
+
+// Counting semaphore; Release() hands the permit to the longest waiter.
+class CoSemaphore {
+ public:
+  explicit CoSemaphore(uint32_t permits) : permits_(permits) {}
+  CoSemaphore(const CoSemaphore&) = delete;
+  CoSemaphore& operator=(const CoSemaphore&) = delete;
+
+  bool TryAcquire() {
+    rti::segar::LockGuard<std::mutex> guard(mutex_);
+    if (permits_ == 0 || !waiters_.empty()) {
+      return false;
+    }
+    --permits_;
+    return true;
+  }
+
+  void Acquire() {
+    std::shared_ptr<co_sync_internal::Waiter> waiter;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (permits_ > 0 && waiters_.empty()) {
+        --permits_;
+        return;
+      }
+      waiter = std::make_shared<co_sync_internal::Waiter>();
+      waiters_.push_back(waiter);
+    }
+    waiter->Wait();
+  }
+
+  void Release() {
+    std::shared_ptr<co_sync_internal::Waiter> next;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (waiters_.empty()) {
+        ++permits_;
+        return;
+      }
+      next = std::move(waiters_.front());
+      waiters_.pop_front();
+    }
+    next->Wake();
+  }
+
+ private:
+  std::mutex mutex_;
+  uint32_t permits_;
+  co_sync_internal::WaiterQueue waiters_;
+};
+
+// Multi-producer multi-consumer queue of at most capacity values. Send
+// suspends while the channel is full, Recv while it is empty. A value sent
+// to a waiting receiver is handed to it directly.
+template <typename T>
+class BoundedChannel {
+ public:
+  explicit BoundedChannel(size_t capacity)
+      : capacity_(capacity == 0 ? 1 : capacity) {}
+  BoundedChannel(const BoundedChannel&) = delete;
+  BoundedChannel& operator=(const BoundedChannel&) = delete;
+
+  // Returns false if the channel is closed; value is then left unchanged.
+  bool Send(T value) {
+    for (;;) {
+      std::shared_ptr<co_sync_internal::Waiter> waiter;
+      std::shared_ptr<Receiver> receiver;
+      {
+        rti::segar::LockGuard<std::mutex> guard(mutex_);
+        if (closed_) {
+          return false;
+        }
+        if (!receivers_.empty()) {
+          receiver = std::move(receivers_.front());
+          receivers_.pop_front();
+          receiver->value = std::move(value);
+          receiver->received = true;
+        } else if (values_.size() < capacity_) {
+          values_.push_back(std::move(value));
+          return true;
+        } else {
+          waiter = std::make_shared<co_sync_internal::Waiter>();
+          senders_.push_back(waiter);
+        }
+      }
+      if (receiver) {
+        receiver->waiter.Wake();
+        return true;
+      }
+      // Woken when a slot frees up or the channel closes.
+      waiter->Wait();
+    }
+  }
+
+  // Returns false once the channel is closed and drained.
+  bool Recv(T* value) {
+    std::shared_ptr<Receiver> receiver;
+    std::shared_ptr<co_sync_internal::Waiter> sender;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      if (!values_.empty()) {
+        *value = std::move(values_.front());
+        values_.pop_front();
+        if (!senders_.empty()) {
+          sender = std::move(senders_.front());
+          senders_.pop_front();
+        }
+      } else if (closed_) {
+        return false;
+      } else {
+        receiver = std::make_shared<Receiver>();
+        receivers_.push_back(receiver);
+      }
+    }
+    if (sender) {
+      sender->Wake();
+    }
+    if (!receiver) {
+      return true;
+    }
+    receiver->waiter.Wait();
+    if (!receiver->received) {
+      return false;  // closed
+    }
+    *value = std::move(receiver->value);
+    return true;
+  }
+
+  // Wakes all waiters; pending values can still be received.
+  void Close() {
+    co_sync_internal::WaiterQueue senders;
+    std::deque<std::shared_ptr<Receiver>> receivers;
+    {
+      rti::segar::LockGuard<std::mutex> guard(mutex_);
+      closed_ = true;
+      senders.swap(senders_);
+      receivers.swap(receivers_);
+    }
+    for (const auto& sender : senders) {
+      sender->Wake();
+    }
+    for (const auto& receiver : receivers) {
+      receiver->waiter.Wake();
+    }
+  }
+
+ private:
+  struct Receiver {
+    co_sync_internal::Waiter waiter;
+    T value{};
+    bool received = false;  // written before the wake-up
+  };
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  bool closed_ = false;
+  std::deque<T> values_;
+  co_sync_internal::WaiterQueue senders_;
+  std::deque<std::shared_ptr<Receiver>> receivers_;
+};
+
+// Bounded channel for exactly one sending and one receiving task: a
+// lock-free ring, the two sides only meet on a TaskEvent when the ring is
+// full or empty.
+template <typename T>
+class SpscChannel {
+ public:
+  explicit SpscChannel(size_t capacity)
+      : slots_(capacity == 0 ? 1 : capacity) {}
+  SpscChannel(const SpscChannel&) = delete;
+  SpscChannel& operator=(const SpscChannel&) = delete;
+
+  bool TrySend(T* value) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load() >= slots_.size()) {
+      return false;
+    }
+    slots_[head % slots_.size()] = std::move(*value);
+    head_.store(head + 1);
+    if (receiver_waiting_.load()) {
+      receiver_event_.Notify();
+    }
+    return true;
+  }
+
+  bool TryRecv(T* value) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load()) {
+      return false;
+    }
+    *value = std::move(slots_[tail % slots_.size()]);
+    tail_.store(tail + 1);
+    if (sender_waiting_.load()) {
+      sender_event_.Notify();
+    }
+    return true;
+  }
+
+  // Returns false if the channel is closed.
+  bool Send(T value) {
+    while (!TrySend(&value)) {
+      if (closed_.load()) {
+        return false;
+      }
+      // Announce the wait, then check again: a receiver that frees a slot
+      // after the check sees the flag and notifies.
+      sender_waiting_.store(true);
+      if (!TrySend(&value)) {
+        sender_event_.Wait(kCoWaitPollInterval);
+        sender_waiting_.store(false);
+        continue;
+      }
+      sender_waiting_.store(false);
+      break;
+    }
+    return true;
+  }
+
+  // Returns false once the channel is closed and drained.
+  bool Recv(T* value) {
+    while (!TryRecv(value)) {
+      if (closed_.load() && tail_.load() == head_.load()) {
+        return false;
+      }
+      receiver_waiting_.store(true);
+      if (!TryRecv(value)) {
+        receiver_event_.Wait(kCoWaitPollInterval);
+        receiver_waiting_.store(false);
+        continue;
+      }
+      receiver_waiting_.store(false);
+      break;
+    }
+    return true;
+  }
+
+  void Close() {
+    closed_.store(true);
+    sender_event_.Notify();
+    receiver_event_.Notify();
+  }
+
+ private:
+  std::vector<T> slots_;
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<bool> sender_waiting_{false};
+  std::atomic<bool> receiver_waiting_{false};
+  std::atomic<bool> closed_{false};
+  rti::segar::TaskEvent sender_event_;
+  rti::segar::TaskEvent receiver_event_;
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,279 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/lz4_block.h"
+#include "common/pod_codec.h"
+#include "common/proc_stats.h"
+#include "example/msg/Compressed.hpp"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+enum class Codec : uint32_t { kNone = 0, kLz4 = 1 };
+
+inline bool ParseCodec(const std::string& name, Codec* codec) {
+  if (name == "none") {
+    *codec = Codec::kNone;
+  } else if (name == "lz4") {
+    *codec = Codec::kLz4;
+  } else {
+    AERROR << "unknown codec: " << name << ", expected none or lz4";
+    return false;
+  }
+  return true;
+}
+
+// Per-topic compression settings.
+struct CompressionConfig {
+  Codec codec = Codec::kLz4;
+  // Smaller messages are sent as they are.
+  uint32_t threshold_bytes = 4096;
+  // Adaptive mode: when compressed/raw is above max_ratio the next
+  // probe_interval messages are sent uncompressed, then compression is
+  // tried again. 1.0 or more keeps compressing whenever it saves a byte.
+  double max_ratio = 0.9;
+  uint32_t probe_interval = 32;
+  // Messages waiting for the compression task; beyond it the oldest one is
+  // dropped, so a writer faster than compression does not grow the queue.
+  uint32_t max_queued = 8;
+};
+
+// Decides per message whether compression is worth trying. Thread safe; the
+// compression itself runs outside the lock.
+class CompressionPolicy {
+ public:
+  explicit CompressionPolicy(const CompressionConfig& config)
+      : config_(config) {}
+
+  bool ShouldTry(size_t raw_size) {
+    if (config_.codec == Codec::kNone || raw_size < config_.threshold_bytes) {
+      return false;
+    }
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    if (skip_ > 0) {
+      --skip_;
+      ++skipped_;
+      return false;
+    }
+    return true;
+  }
+
+  // Returns whether the compressed result should be sent.
+  bool Report(size_t raw_size, size_t compressed_size) {
+    const double ratio =
+        compressed_size == 0
+            ? 1.0
+            : static_cast<double>(compressed_size) / raw_size;
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    mean_ratio_ = tried_ == 0 ? ratio : 0.9 * mean_ratio_ + 0.1 * ratio;
+    ++tried_;
+    if (ratio > config_.max_ratio) {
+      skip_ = config_.max_ratio < 1.0 ? config_.probe_interval : 0;
+    }
+    return compressed_size != 0 && compressed_size < raw_size;
+  }
+
+  uint64_t tried() const {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    return tried_;
+  }
+  uint64_t skipped() const {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    return skipped_;
+  }
+  double mean_ratio() const {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    return mean_ratio_;
+  }
+
+ private:
+  const CompressionConfig config_;
+  mutable std::mutex mutex_;
+  uint32_t skip_ = 0;
+  uint64_t tried_ = 0;
+  uint64_t skipped_ = 0;
+  double mean_ratio_ = 1.0;
+};
+
+// Fills out with raw, compressed when the policy says so and it pays off.
+inline void CompressInto(const uint8_t* raw, size_t size,
+                         CompressionPolicy* policy,
+                         example::msg::Compressed* out) {
+  out->raw_size(static_cast<uint32_t>(size));
+  if (policy->ShouldTry(size)) {
+    out->data().resize(Lz4CompressBound(size));
+    // Capacity raw size: results that do not save anything are dropped.
+    const size_t compressed = Lz4Compress(raw, size, out->data().data(), size);
+    if (policy->Report(size, compressed)) {
+      out->data().resize(compressed);
+      out->codec(static_cast<uint32_t>(Codec::kLz4));
+      return;
+    }
+  }
+  out->codec(static_cast<uint32_t>(Codec::kNone));
+  out->data().assign(raw, raw + size);
+}
+
+inline bool Decompress(const example::msg::Compressed& in,
+                       std::vector<uint8_t>* raw) {
+  switch (static_cast<Codec>(in.codec())) {
+    case Codec::kNone:
+      *raw = in.data();
+      return raw->size() == in.raw_size();
+    case Codec::kLz4:
+      raw->resize(in.raw_size());
+      return Lz4Decompress(in.data().data(), in.data().size(), raw->data(),
+                           raw->size());
+  }
+  return false;
+}
+
+// Writer of a topic with a compressed copy for remote subscribers. Write()
+// publishes the message unchanged on the topic, so SHM and INTRA readers
+// keep the zero-copy path, then hands it to a Segar task that encodes it
+// (POD layout), compresses it once and publishes the result on
+// "<topic>/compressed", which remote readers subscribe to instead. T needs a
+// PodLayout.
+template <typename T>
+class CompressingWriter {
+ public:
+  using RemotePublish =
+      std::function<bool(const std::shared_ptr<example::msg::Compressed>&)>;
+
+  // remote replaces the writer of "<topic>/compressed", e.g. to shape the
+  // traffic in a benchmark.
+  CompressingWriter(const std::shared_ptr<rti::segar::Node>& node,
+                    const std::string& topic, const CompressionConfig& config,
+                    RemotePublish remote = nullptr)
+      : state_(std::make_shared<State>(config)) {
+    writer_ = node->template CreateWriter<T>(topic);
+    if (remote) {
+      state_->remote = std::move(remote);
+    } else {
+      auto writer = node->template CreateWriter<example::msg::Compressed>(
+          topic + "/compressed");
+      if (writer) {
+        state_->remote = [writer](const auto& msg) {
+          return writer->Write(msg);
+        };
+      }
+    }
+  }
+
+  bool IsValid() const { return writer_ && state_->remote; }
+
+  bool Write(const std::shared_ptr<T>& msg, uint64_t timestamp,
+             uint32_t sequence_number) {
+    const bool ok = writer_->Write(msg);
+    State::Enqueue(state_, {msg, timestamp, sequence_number});
+    return ok;
+  }
+
+  // "tried=... skipped=... ratio=..." of the adaptive policy.
+  std::string Stats() const {
+    return "tried=" + std::to_string(state_->policy.tried()) +
+           " skipped=" + std::to_string(state_->policy.skipped()) +
+           " mean_ratio=" + std::to_string(state_->policy.mean_ratio()) +
+           " compress_ms=" + std::to_string(state_->compress_ns.load() / 1e6) +
+           " dropped=" + std::to_string(state_->dropped.load());
+  }
+
+ private:
+  struct Pending {
+    std::shared_ptr<T> msg;
+    uint64_t timestamp;
+    uint32_t sequence_number;
+  };
+
+  // Compression runs off the writer's thread but one message at a time: a
+  // single drain task per writer publishes the queue in order, so remote
+  // readers see the sequence numbers in the order they were written.
+  struct State {
+    explicit State(const CompressionConfig& config)
+        : policy(config),
+          max_queued(std::max<uint32_t>(config.max_queued, 1)) {}
+
+    // The state is shared with the task so that it outlives the writer.
+    static void Enqueue(const std::shared_ptr<State>& state,
+                        Pending pending) {
+      {
+        rti::segar::LockGuard<std::mutex> lock(state->mutex);
+        if (state->queue.size() >= state->max_queued) {
+          state->queue.pop_front();
+          state->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        state->queue.push_back(std::move(pending));
+        if (state->draining) {
+          return;
+        }
+        state->draining = true;
+      }
+      rti::segar::Execute([state]() { state->Drain(); });
+    }
+
+    void Drain() {
+      for (;;) {
+        Pending pending;
+        {
+          rti::segar::LockGuard<std::mutex> lock(mutex);
+          if (queue.empty()) {
+            draining = false;
+            return;
+          }
+          pending = std::move(queue.front());
+          queue.pop_front();
+        }
+        Publish(*pending.msg, pending.timestamp, pending.sequence_number);
+      }
+    }
+
+    void Publish(const T& msg, uint64_t timestamp, uint32_t sequence_number) {
+      thread_local std::vector<uint8_t> encoded;
+      encoded.clear();
+      PodEncode(msg, &encoded);
+      auto compressed = std::make_shared<example::msg::Compressed>();
+      compressed->timestamp(timestamp);
+      compressed->sequence_number(sequence_number);
+      const uint64_t start = MonotonicNs();
+      CompressInto(encoded.data(), encoded.size(), &policy, compressed.get());
+      compress_ns.fetch_add(MonotonicNs() - start, std::memory_order_relaxed);
+      remote(compressed);
+    }
+
+    CompressionPolicy policy;
+    const size_t max_queued;
+    std::atomic<uint64_t> compress_ns{0};
+    std::atomic<uint64_t> dropped{0};
+    RemotePublish remote;
+    std::mutex mutex;
+    std::deque<Pending> queue;  // guarded by mutex
+    bool draining = false;      // guarded by mutex
+  };
+
+  std::shared_ptr<rti::segar::Writer<T>> writer_;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace common
+}  // namespace example
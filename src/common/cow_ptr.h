@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace example {
+namespace common {
+
+// Read-only handle to a message received through INTRA delivery, where every
+// in-process reader gets the writer's shared_ptr itself. Reading goes through
+// a const view; Mutable() copies the message unless this handle is the only
+// owner left, so one consumer can never change what the others see.
+template <typename T>
+class CowPtr {
+ public:
+  CowPtr() = default;
+  explicit CowPtr(std::shared_ptr<const T> ptr) : ptr_(std::move(ptr)) {}
+
+  const T& operator*() const { return *ptr_; }
+  const T* operator->() const { return ptr_.get(); }
+  const T* get() const { return ptr_.get(); }
+  explicit operator bool() const { return ptr_ != nullptr; }
+  const std::shared_ptr<const T>& shared() const { return ptr_; }
+
+  T* Mutable() {
+    if (ptr_.use_count() != 1) {
+      ptr_ = std::make_shared<T>(*ptr_);
+      ++copies_;
+    }
+    // Sole owner: the object was created non-const by the writer.
+    return const_cast<T*>(ptr_.get());
+  }
+
+  // Number of copies Mutable() has made through this handle.
+  int copies() const { return copies_; }
+
+ private:
+  std::shared_ptr<const T> ptr_;
+  int copies_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
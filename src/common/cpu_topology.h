@@ -0,0 +1,198 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace example {
+namespace common {
+
+// Parses a cpuset string in the scheduler_conf syntax, e.g. "0-7,16-23".
+inline bool ParseCpuset(const std::string& cpuset, std::vector<int>* cpus) {
+  cpus->clear();
+  std::istringstream iss(cpuset);
+  std::string range;
+  while (std::getline(iss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    char* end = nullptr;
+    const long first = std::strtol(range.c_str(), &end, 10);
+    long last = first;
+    if (*end == '-') {
+      last = std::strtol(end + 1, &end, 10);
+    }
+    if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+      return false;
+    }
+    for (long cpu = first; cpu <= last; ++cpu) {
+      cpus->push_back(static_cast<int>(cpu));
+    }
+  }
+  return !cpus->empty();
+}
+
+// Pins the calling thread. Threads created afterwards inherit the mask, so
+// calling this before rti::segar::Init() confines the whole process the same
+// way process_level_cpuset does.
+inline bool PinCurrentThread(const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Cpus the calling thread may currently run on.
+inline std::vector<int> CurrentCpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+// NUMA node of a cpu from sysfs, 0 on machines without NUMA information.
+inline int NumaNodeOfCpu(int cpu) {
+  const std::string path =
+      "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+  int node = 0;
+  while (auto* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(0, 4, "node") == 0) {
+      node = std::atoi(name.c_str() + 4);
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+
+inline int NumaNodeCount() {
+  DIR* dir = opendir("/sys/devices/system/node");
+  if (dir == nullptr) {
+    return 1;
+  }
+  int count = 0;
+  while (auto* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+        name.find_first_not_of("0123456789", 4) == std::string::npos) {
+      ++count;
+    }
+  }
+  closedir(dir);
+  return count > 0 ? count : 1;
+}
+
+enum class NumaPolicy {
+  kNone,        // kernel default (first touch)
+  kLocal,       // bind to the nodes of this process's cpuset
+  kInterleave,  // interleave pages over all nodes
+  kNode,        // bind to one explicit node, e.g. the peer's node
+};
+
+inline bool ParseNumaPolicy(const std::string& name, NumaPolicy* policy) {
+  if (name == "none") {
+    *policy = NumaPolicy::kNone;
+  } else if (name == "local") {
+    *policy = NumaPolicy::kLocal;
+  } else if (name == "interleave") {
+    *policy = NumaPolicy::kInterleave;
+  } else if (name == "node") {
+    *policy = NumaPolicy::kNode;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Sets the memory policy of the calling thread; like the cpu mask it is
+// inherited by threads created later. SHM pages are placed by the policy of
+// the process that touches them first, which for a topic is the writer.
+inline bool ApplyNumaPolicy(NumaPolicy policy, const std::vector<int>& cpus,
+                            int node) {
+  if (policy == NumaPolicy::kNone) {
+    return true;
+  }
+  constexpr int kMaxNodes = 256;
+  unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+  auto set_node = [&mask](int n) {
+    if (n >= 0 && n < kMaxNodes) {
+      mask[n / (8 * sizeof(unsigned long))] |=
+          1UL << (n % (8 * sizeof(unsigned long)));
+    }
+  };
+  int mode = MPOL_BIND;
+  switch (policy) {
+    case NumaPolicy::kLocal: {
+      std::set<int> nodes;
+      for (int cpu : cpus) {
+        nodes.insert(NumaNodeOfCpu(cpu));
+      }
+      for (int n : nodes) {
+        set_node(n);
+      }
+      break;
+    }
+    case NumaPolicy::kInterleave:
+      mode = MPOL_INTERLEAVE;
+      for (int n = 0; n < NumaNodeCount(); ++n) {
+        set_node(n);
+      }
+      break;
+    case NumaPolicy::kNode:
+      set_node(node);
+      break;
+    default:
+      return false;
+  }
+  // The kernel reads maxnode - 1 bits from the mask.
+  return syscall(SYS_set_mempolicy, mode, mask, kMaxNodes + 1) == 0;
+}
+
+// Huge page mode of tmpfs/shmem, which backs the SHM segments. The active
+// value is the bracketed one, e.g. "always within_size [advise] never deny".
+inline std::string ShmemHugePageSetting() {
+  std::ifstream in("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+  std::string line;
+  if (!std::getline(in, line)) {
+    return "unknown";
+  }
+  const auto begin = line.find('[');
+  const auto end = line.find(']');
+  if (begin == std::string::npos || end == std::string::npos || end < begin) {
+    return line;
+  }
+  return line.substr(begin + 1, end - begin - 1);
+}
+
+}  // namespace common
+}  // namespace example
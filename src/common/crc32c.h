@@ -0,0 +1,477 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// The kernels are built for their instructions whatever the -march of the
+// build; they only run after the CPU was checked for them.
+#if defined(__x86_64__)
+#define EXAMPLE_CRC32C_TARGET __attribute__((target("sse4.2")))
+#define EXAMPLE_CRC32C_FOLD_TARGET __attribute__((target("sse4.2,pclmul")))
+#elif defined(__aarch64__) && defined(__clang__)
+#define EXAMPLE_CRC32C_TARGET __attribute__((target("crc")))
+#define EXAMPLE_CRC32C_FOLD_TARGET __attribute__((target("crc,aes")))
+#elif defined(__aarch64__)
+#define EXAMPLE_CRC32C_TARGET __attribute__((target("+crc")))
+#define EXAMPLE_CRC32C_FOLD_TARGET __attribute__((target("+crc+crypto")))
+#endif
+
+namespace example {
+namespace common {
+
+// CRC32C (Castagnoli, the polynomial of iSCSI, ext4 and SCTP) with the
+// usual initial value and final xor of ~0: Crc32c("123456789") is
+// 0xe3069283. Three implementations, the fastest the CPU supports is used:
+//
+// - kCrc: the crc32 instructions of SSE4.2 (x86_64) or of the ARMv8 CRC
+//   extension (aarch64). One instruction folds 8 bytes but its result is
+//   only ready 2-3 cycles later, so the data is cut into three stripes
+//   whose CRCs are computed interleaved and then combined with a table.
+//   That keeps the unit busy every cycle, 8 bytes per cycle.
+// - kCrcFold: kCrc on part of each 14 KB block while carry-less multiplies
+//   (PCLMULQDQ, or PMULL of the ARMv8 crypto extension) fold the rest, the
+//   way the Intel paper "Fast CRC Computation for Generic Polynomials Using
+//   PCLMULQDQ" does. Both units run in parallel, about twice kCrc for
+//   large messages. Messages below one block take kCrc.
+// - kSoftware: slicing-by-8 tables, for CPUs without the instructions.
+enum class Crc32cKernel { kSoftware, kCrc, kCrcFold };
+
+inline std::string ToString(Crc32cKernel kernel) {
+  switch (kernel) {
+    case Crc32cKernel::kSoftware:
+      return "software";
+    case Crc32cKernel::kCrc:
+      return "crc";
+    case Crc32cKernel::kCrcFold:
+      return "crc+fold";
+  }
+  return "unknown";
+}
+
+namespace crc32c_internal {
+
+constexpr uint32_t kPoly = 0x82f63b78;  // reflected
+
+// Slicing-by-8: table[k][b] is the CRC of b followed by k zero bytes.
+struct SoftwareTables {
+  uint32_t table[8][256];
+
+  SoftwareTables() {
+    for (uint32_t b = 0; b < 256; ++b) {
+      uint32_t crc = b;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 1) != 0 ? (crc >> 1) ^ kPoly : crc >> 1;
+      }
+      table[0][b] = crc;
+    }
+    for (int k = 1; k < 8; ++k) {
+      for (uint32_t b = 0; b < 256; ++b) {
+        const uint32_t prev = table[k - 1][b];
+        table[k][b] = (prev >> 8) ^ table[0][prev & 0xff];
+      }
+    }
+  }
+};
+
+inline const SoftwareTables& Tables() {
+  static const SoftwareTables tables;
+  return tables;
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+// The kernels work on the CRC register, without the initial value and the
+// final xor.
+inline uint32_t ExtendSoftware(uint32_t crc, const uint8_t* p, size_t size) {
+  const auto& t = Tables().table;
+  for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size) {
+    crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  }
+  for (; size >= 8; size -= 8, p += 8) {
+    // Little endian: the first byte of the word is its low byte.
+    const uint64_t word = Load64(p) ^ crc;
+    crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^
+          t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+          t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^
+          t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+  }
+  for (; size > 0; --size) {
+    crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+// a * b mod P of two reflected polynomials.
+inline uint32_t MultiplyModP(uint32_t a, uint32_t b) {
+  uint32_t product = 0;
+  for (uint32_t m = 1u << 31; m != 0 && a != 0; m >>= 1) {
+    if ((a & m) != 0) {
+      product ^= b;
+      a ^= m;
+    }
+    b = (b & 1) != 0 ? (b >> 1) ^ kPoly : b >> 1;
+  }
+  return product;
+}
+
+// x^n mod P, reflected.
+inline uint32_t PowerModP(uint64_t n) {
+  uint32_t power = 1u << 30;  // x^1
+  uint32_t result = 1u << 31;  // x^0
+  for (; n != 0; n >>= 1) {
+    if ((n & 1) != 0) {
+      result = MultiplyModP(power, result);
+    }
+    power = MultiplyModP(power, power);
+  }
+  return result;
+}
+
+// Advances a CRC register over `bytes` zero bytes: register * x^(8 bytes)
+// mod P. It is linear, so one table per byte of the register does it.
+class ZeroShift {
+ public:
+  explicit ZeroShift(size_t bytes) {
+    const uint32_t factor = PowerModP(8 * static_cast<uint64_t>(bytes));
+    for (uint32_t i = 0; i < 4; ++i) {
+      for (uint32_t b = 0; b < 256; ++b) {
+        table_[i][b] = MultiplyModP(b << (8 * i), factor);
+      }
+    }
+  }
+
+  uint32_t operator()(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^
+           table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+ private:
+  uint32_t table_[4][256];
+};
+
+// kCrc stripe lengths: long ones make the combining rare, short ones let
+// messages of a few KB use the interleaved loop too.
+constexpr size_t kLongStripe = 8192;
+constexpr size_t kShortStripe = 256;
+
+inline const ZeroShift& LongShift() {
+  static const ZeroShift shift(kLongStripe);
+  return shift;
+}
+
+inline const ZeroShift& ShortShift() {
+  static const ZeroShift shift(kShortStripe);
+  return shift;
+}
+
+// kCrcFold block: kFoldRounds rounds of 64 folded bytes and two words of
+// each of the three crc stripes. The ratio keeps both units busy on recent
+// x86 cores; the whole block is 14 KB.
+constexpr size_t kFoldRounds = 128;
+constexpr size_t kFoldBytes = 64 * kFoldRounds;
+constexpr size_t kFoldStripe = 16 * kFoldRounds;
+constexpr size_t kFoldBlock = kFoldBytes + 3 * kFoldStripe;
+
+// Multipliers of the folds, x^(distance +- 32) mod P shifted into the
+// 33-bit form the carry-less multiply wants.
+struct FoldConstants {
+  uint64_t by4_low = Constant(512 + 32);
+  uint64_t by4_high = Constant(512 - 32);
+  uint64_t by1_low = Constant(128 + 32);
+  uint64_t by1_high = Constant(128 - 32);
+  ZeroShift stripe_shift{kFoldStripe};
+
+  static uint64_t Constant(uint64_t bits) {
+    return static_cast<uint64_t>(PowerModP(bits)) << 1;
+  }
+};
+
+inline const FoldConstants& Folds() {
+  static const FoldConstants folds;
+  return folds;
+}
+
+#if defined(EXAMPLE_CRC32C_TARGET)
+
+EXAMPLE_CRC32C_TARGET inline uint32_t HardwareByte(uint32_t crc, uint8_t v) {
+#if defined(__x86_64__)
+  return _mm_crc32_u8(crc, v);
+#else
+  return __crc32cb(crc, v);
+#endif
+}
+
+EXAMPLE_CRC32C_TARGET inline uint32_t HardwareWord(uint32_t crc,
+                                                   uint64_t v) {
+#if defined(__x86_64__)
+  return static_cast<uint32_t>(_mm_crc32_u64(crc, v));
+#else
+  return __crc32cd(crc, v);
+#endif
+}
+
+// Three stripes of `stripe` bytes at p, combined into one register.
+EXAMPLE_CRC32C_TARGET inline uint32_t HardwareStripes(uint32_t crc,
+                                                      const uint8_t* p,
+                                                      size_t stripe,
+                                                      const ZeroShift& shift) {
+  uint32_t crc1 = 0;
+  uint32_t crc2 = 0;
+  const uint8_t* p1 = p + stripe;
+  const uint8_t* p2 = p + 2 * stripe;
+  for (size_t i = 0; i < stripe; i += 8) {
+    crc = HardwareWord(crc, Load64(p + i));
+    crc1 = HardwareWord(crc1, Load64(p1 + i));
+    crc2 = HardwareWord(crc2, Load64(p2 + i));
+  }
+  return shift(shift(crc) ^ crc1) ^ crc2;
+}
+
+EXAMPLE_CRC32C_TARGET inline uint32_t ExtendHardware(uint32_t crc,
+                                                     const uint8_t* p,
+                                                     size_t size) {
+  for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size) {
+    crc = HardwareByte(crc, *p++);
+  }
+  if (size >= 3 * kLongStripe) {
+    const ZeroShift& shift = LongShift();
+    for (; size >= 3 * kLongStripe; size -= 3 * kLongStripe) {
+      crc = HardwareStripes(crc, p, kLongStripe, shift);
+      p += 3 * kLongStripe;
+    }
+  }
+  if (size >= 3 * kShortStripe) {
+    const ZeroShift& shift = ShortShift();
+    for (; size >= 3 * kShortStripe; size -= 3 * kShortStripe) {
+      crc = HardwareStripes(crc, p, kShortStripe, shift);
+      p += 3 * kShortStripe;
+    }
+  }
+  for (; size >= 8; size -= 8, p += 8) {
+    crc = HardwareWord(crc, Load64(p));
+  }
+  for (; size > 0; --size) {
+    crc = HardwareByte(crc, *p++);
+  }
+  return crc;
+}
+
+// 128-bit lanes of the fold.
+#if defined(__x86_64__)
+using FoldLane = __m128i;
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane LoadLane(const uint8_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane MakeLane(uint64_t low,
+                                                    uint64_t high) {
+  return _mm_set_epi64x(static_cast<int64_t>(high),
+                        static_cast<int64_t>(low));
+}
+
+// lane * x^distance folded onto `data` the distance further on.
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane FoldLanes(FoldLane lane,
+                                                     FoldLane k,
+                                                     FoldLane data) {
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(lane, k, 0x00),
+                                     _mm_clmulepi64_si128(lane, k, 0x11)),
+                       data);
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane XorLanes(FoldLane a, FoldLane b) {
+  return _mm_xor_si128(a, b);
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline uint64_t LowWord(FoldLane lane) {
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(lane));
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline uint64_t HighWord(FoldLane lane) {
+  return static_cast<uint64_t>(_mm_extract_epi64(lane, 1));
+}
+#else
+using FoldLane = uint64x2_t;
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane LoadLane(const uint8_t* p) {
+  return vreinterpretq_u64_u8(vld1q_u8(p));
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane MakeLane(uint64_t low,
+                                                    uint64_t high) {
+  return vcombine_u64(vcreate_u64(low), vcreate_u64(high));
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane FoldLanes(FoldLane lane,
+                                                     FoldLane k,
+                                                     FoldLane data) {
+  const FoldLane low = vreinterpretq_u64_p128(
+      vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(lane, 0)),
+                static_cast<poly64_t>(vgetq_lane_u64(k, 0))));
+  const FoldLane high = vreinterpretq_u64_p128(vmull_high_p64(
+      vreinterpretq_p64_u64(lane), vreinterpretq_p64_u64(k)));
+  return veorq_u64(veorq_u64(low, high), data);
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline FoldLane XorLanes(FoldLane a, FoldLane b) {
+  return veorq_u64(a, b);
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline uint64_t LowWord(FoldLane lane) {
+  return vgetq_lane_u64(lane, 0);
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline uint64_t HighWord(FoldLane lane) {
+  return vgetq_lane_u64(lane, 1);
+}
+#endif
+
+// One kFoldBlock at p: the first kFoldBytes folded in four lanes, the
+// three stripes after them by the crc instruction, in the same loop.
+EXAMPLE_CRC32C_FOLD_TARGET inline uint32_t FoldBlock(
+    uint32_t crc, const uint8_t* p, const FoldConstants& folds) {
+  const FoldLane by4 = MakeLane(folds.by4_low, folds.by4_high);
+  const FoldLane by1 = MakeLane(folds.by1_low, folds.by1_high);
+  const uint8_t* s0 = p + kFoldBytes;
+  const uint8_t* s1 = s0 + kFoldStripe;
+  const uint8_t* s2 = s1 + kFoldStripe;
+  uint32_t crc0 = 0;
+  uint32_t crc1 = 0;
+  uint32_t crc2 = 0;
+  // The register xored into the first bytes stands for the initial value.
+  FoldLane x0 = XorLanes(LoadLane(p), MakeLane(crc, 0));
+  FoldLane x1 = LoadLane(p + 16);
+  FoldLane x2 = LoadLane(p + 32);
+  FoldLane x3 = LoadLane(p + 48);
+  for (size_t round = 0; round < kFoldRounds; ++round) {
+    if (round > 0) {
+      const uint8_t* q = p + 64 * round;
+      x0 = FoldLanes(x0, by4, LoadLane(q));
+      x1 = FoldLanes(x1, by4, LoadLane(q + 16));
+      x2 = FoldLanes(x2, by4, LoadLane(q + 32));
+      x3 = FoldLanes(x3, by4, LoadLane(q + 48));
+    }
+    const size_t i = 16 * round;
+    crc0 = HardwareWord(crc0, Load64(s0 + i));
+    crc1 = HardwareWord(crc1, Load64(s1 + i));
+    crc2 = HardwareWord(crc2, Load64(s2 + i));
+    crc0 = HardwareWord(crc0, Load64(s0 + i + 8));
+    crc1 = HardwareWord(crc1, Load64(s1 + i + 8));
+    crc2 = HardwareWord(crc2, Load64(s2 + i + 8));
+  }
+  const FoldLane x =
+      FoldLanes(FoldLanes(FoldLanes(x0, by1, x1), by1, x2), by1, x3);
+  // The 16 bytes left have the CRC of the folded part.
+  crc = HardwareWord(HardwareWord(0, LowWord(x)), HighWord(x));
+  const ZeroShift& shift = folds.stripe_shift;
+  return shift(shift(shift(crc) ^ crc0) ^ crc1) ^ crc2;
+}
+
+EXAMPLE_CRC32C_FOLD_TARGET inline uint32_t ExtendFold(uint32_t crc,
+                                                      const uint8_t* p,
+                                                      size_t size) {
+  if (size >= kFoldBlock) {
+    const FoldConstants& folds = Folds();
+    for (; size >= kFoldBlock; size -= kFoldBlock, p += kFoldBlock) {
+      crc = FoldBlock(crc, p, folds);
+    }
+  }
+  return ExtendHardware(crc, p, size);
+}
+
+#else
+
+inline uint32_t ExtendHardware(uint32_t crc, const uint8_t* p, size_t size) {
+  return ExtendSoftware(crc, p, size);
+}
+
+inline uint32_t ExtendFold(uint32_t crc, const uint8_t* p, size_t size) {
+  return ExtendSoftware(crc, p, size);
+}
+
+#endif  // EXAMPLE_CRC32C_TARGET
+
+}  // namespace crc32c_internal
+
+inline bool Crc32cSupported(Crc32cKernel kernel) {
+#if defined(__x86_64__)
+  static const bool crc = __builtin_cpu_supports("sse4.2");
+  static const bool fold = crc && __builtin_cpu_supports("pclmul");
+#elif defined(__aarch64__)
+  static const uint64_t hwcap = getauxval(AT_HWCAP);
+  static const bool crc = (hwcap & HWCAP_CRC32) != 0;
+  static const bool fold = crc && (hwcap & HWCAP_PMULL) != 0;
+#else
+  static const bool crc = false;
+  static const bool fold = false;
+#endif
+  switch (kernel) {
+    case Crc32cKernel::kSoftware:
+      return true;
+    case Crc32cKernel::kCrc:
+      return crc;
+    case Crc32cKernel::kCrcFold:
+      return fold;
+  }
+  return false;
+}
+
+inline Crc32cKernel Crc32cBestKernel() {
+  static const Crc32cKernel best =
+      Crc32cSupported(Crc32cKernel::kCrcFold) ? Crc32cKernel::kCrcFold
+      : Crc32cSupported(Crc32cKernel::kCrc)   ? Crc32cKernel::kCrc
+                                              : Crc32cKernel::kSoftware;
+  return best;
+}
+
+// Extends a CRC32C returned before (0 for none) by `size` bytes with the
+// given kernel, which must be supported. For tests and benchmarks.
+inline uint32_t Crc32cExtend(Crc32cKernel kernel, uint32_t crc,
+                             const void* data, size_t size) {
+  const auto* p = static_cast<const uint8_t*>(data);
+  switch (kernel) {
+    case Crc32cKernel::kCrcFold:
+      return ~crc32c_internal::ExtendFold(~crc, p, size);
+    case Crc32cKernel::kCrc:
+      return ~crc32c_internal::ExtendHardware(~crc, p, size);
+    case Crc32cKernel::kSoftware:
+      break;
+  }
+  return ~crc32c_internal::ExtendSoftware(~crc, p, size);
+}
+
+// Extends a CRC32C returned before (0 for none) by `size` bytes, so data
+// in several pieces is covered without copying it together.
+inline uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t size) {
+  return Crc32cExtend(Crc32cBestKernel(), crc, data, size);
+}
+
+inline uint32_t Crc32c(const void* data, size_t size) {
+  return Crc32cExtend(0, data, size);
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,395 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+#include "common/pod_codec.h"
+#include "example/action/LookUpTransform.hpp"
+#include "example/msg/Batch.hpp"
+#include "example/msg/CameraInfo.hpp"
+#include "example/msg/Compressed.hpp"
+#include "example/msg/Fragment.hpp"
+#include "example/msg/Image.hpp"
+#include "example/msg/LatencyAlert.hpp"
+#include "example/msg/Nack.hpp"
+#include "example/msg/Payload.hpp"
+#include "example/msg/String.hpp"
+#include "example/srv/PrioritizedWork.hpp"
+#include "example/srv/SetCameraInfo.hpp"
+
+// POD layouts of the types in src/type_src/example. Fixed fields are ordered
+// by size so that Fixed has no padding; bool is carried as uint8_t.
+
+namespace example {
+namespace common {
+
+template <>
+struct PodLayout<example::msg::Image> {
+  struct Fixed {
+    uint64_t timestamp;
+    int32_t width;
+    uint32_t reserved;
+  };
+  static void Pack(const example::msg::Image& msg, Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->width = msg.width();
+    fixed->reserved = 0;
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Image* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->width(fixed.width);
+  }
+  template <typename M>
+  static auto Tail(M& /*msg*/) {
+    return std::tuple<>();
+  }
+};
+
+template <>
+struct PodLayout<example::msg::String> {
+  struct Fixed {};
+  static void Pack(const example::msg::String&, Fixed*) {}
+  static void Unpack(const Fixed&, example::msg::String*) {}
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.data());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::CameraInfo> {
+  struct Fixed {
+    int32_t width;
+  };
+  static void Pack(const example::msg::CameraInfo& msg, Fixed* fixed) {
+    fixed->width = msg.width();
+  }
+  static void Unpack(const Fixed& fixed, example::msg::CameraInfo* msg) {
+    msg->width(fixed.width);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.camera_name());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::Payload> {
+  struct Fixed {
+    uint64_t timestamp;
+    uint32_t topic_id;
+    uint32_t sequence_number;
+    uint32_t data_size;
+    uint32_t crc32c;
+  };
+  static void Pack(const example::msg::Payload& msg, Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->topic_id = msg.topic_id();
+    fixed->sequence_number = msg.sequence_number();
+    fixed->data_size = msg.data_size();
+    fixed->crc32c = msg.crc32c();
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Payload* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->topic_id(fixed.topic_id);
+    msg->sequence_number(fixed.sequence_number);
+    msg->data_size(fixed.data_size);
+    msg->crc32c(fixed.crc32c);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.data());
+  }
+};
+
+template <>
+struct PodLayout<example::srv::SetCameraInfo::Request> {
+  struct Fixed {};
+  static void Pack(const example::srv::SetCameraInfo::Request&, Fixed*) {}
+  static void Unpack(const Fixed&, example::srv::SetCameraInfo::Request*) {}
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.camera_info());
+  }
+};
+
+template <>
+struct PodLayout<example::srv::SetCameraInfo::Response> {
+  struct Fixed {
+    uint8_t success;
+  };
+  static void Pack(const example::srv::SetCameraInfo::Response& msg,
+                   Fixed* fixed) {
+    fixed->success = msg.success() ? 1 : 0;
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::srv::SetCameraInfo::Response* msg) {
+    msg->success(fixed.success != 0);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.status_message());
+  }
+};
+
+template <>
+struct PodLayout<example::action::LookUpTransform::Goal> {
+  struct Fixed {
+    uint8_t advanced;
+  };
+  static void Pack(const example::action::LookUpTransform::Goal& msg,
+                   Fixed* fixed) {
+    fixed->advanced = msg.advanced() ? 1 : 0;
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::action::LookUpTransform::Goal* msg) {
+    msg->advanced(fixed.advanced != 0);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.target_frame(), msg.source_frame());
+  }
+};
+
+template <>
+struct PodLayout<example::action::LookUpTransform::Result> {
+  struct Fixed {
+    int32_t error;
+  };
+  static void Pack(const example::action::LookUpTransform::Result& msg,
+                   Fixed* fixed) {
+    fixed->error = msg.error();
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::action::LookUpTransform::Result* msg) {
+    msg->error(fixed.error);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.transform());
+  }
+};
+
+template <>
+struct PodLayout<example::action::LookUpTransform::Feedback> {
+  struct Fixed {
+    int32_t current;
+  };
+  static void Pack(const example::action::LookUpTransform::Feedback& msg,
+                   Fixed* fixed) {
+    fixed->current = msg.current();
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::action::LookUpTransform::Feedback* msg) {
+    msg->current(fixed.current);
+  }
+  template <typename M>
+  static auto Tail(M& /*msg*/) {
+    return std::tuple<>();
+  }
+};
+
+template <>
+struct PodLayout<example::msg::Batch> {
+  struct Fixed {
+    uint64_t first_timestamp;
+    uint32_t count;
+    uint32_t reserved;
+  };
+  static void Pack(const example::msg::Batch& msg, Fixed* fixed) {
+    fixed->first_timestamp = msg.first_timestamp();
+    fixed->count = msg.count();
+    fixed->reserved = 0;
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Batch* msg) {
+    msg->first_timestamp(fixed.first_timestamp);
+    msg->count(fixed.count);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.data());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::Compressed> {
+  struct Fixed {
+    uint64_t timestamp;
+    uint32_t codec;
+    uint32_t raw_size;
+    uint32_t sequence_number;
+    uint32_t reserved;
+  };
+  static void Pack(const example::msg::Compressed& msg, Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->codec = msg.codec();
+    fixed->raw_size = msg.raw_size();
+    fixed->sequence_number = msg.sequence_number();
+    fixed->reserved = 0;
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Compressed* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->codec(fixed.codec);
+    msg->raw_size(fixed.raw_size);
+    msg->sequence_number(fixed.sequence_number);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.data());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::Fragment> {
+  struct Fixed {
+    uint64_t timestamp;
+    uint32_t stream_id;
+    uint32_t total_size;
+    uint32_t fragment_index;
+    uint32_t fragment_count;
+    uint32_t fragment_size;
+    uint8_t retransmit;
+    uint8_t reserved[3];
+  };
+  static void Pack(const example::msg::Fragment& msg, Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->stream_id = msg.stream_id();
+    fixed->total_size = msg.total_size();
+    fixed->fragment_index = msg.fragment_index();
+    fixed->fragment_count = msg.fragment_count();
+    fixed->fragment_size = msg.fragment_size();
+    fixed->retransmit = msg.retransmit() ? 1 : 0;
+    for (auto& byte : fixed->reserved) {
+      byte = 0;
+    }
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Fragment* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->stream_id(fixed.stream_id);
+    msg->total_size(fixed.total_size);
+    msg->fragment_index(fixed.fragment_index);
+    msg->fragment_count(fixed.fragment_count);
+    msg->fragment_size(fixed.fragment_size);
+    msg->retransmit(fixed.retransmit != 0);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.data());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::LatencyAlert> {
+  struct Fixed {
+    uint64_t timestamp;
+    uint64_t latency_ns;
+    uint64_t budget_ns;
+    uint64_t violations;
+  };
+  static void Pack(const example::msg::LatencyAlert& msg, Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->latency_ns = msg.latency_ns();
+    fixed->budget_ns = msg.budget_ns();
+    fixed->violations = msg.violations();
+  }
+  static void Unpack(const Fixed& fixed, example::msg::LatencyAlert* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->latency_ns(fixed.latency_ns);
+    msg->budget_ns(fixed.budget_ns);
+    msg->violations(fixed.violations);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.stage());
+  }
+};
+
+template <>
+struct PodLayout<example::msg::Nack> {
+  struct Fixed {
+    uint32_t stream_id;
+    uint8_t complete;
+    uint8_t reserved[3];
+  };
+  static void Pack(const example::msg::Nack& msg, Fixed* fixed) {
+    fixed->stream_id = msg.stream_id();
+    fixed->complete = msg.complete() ? 1 : 0;
+    for (auto& byte : fixed->reserved) {
+      byte = 0;
+    }
+  }
+  static void Unpack(const Fixed& fixed, example::msg::Nack* msg) {
+    msg->stream_id(fixed.stream_id);
+    msg->complete(fixed.complete != 0);
+  }
+  template <typename M>
+  static auto Tail(M& msg) {
+    return std::forward_as_tuple(msg.missing());
+  }
+};
+
+template <>
+struct PodLayout<example::srv::PrioritizedWork::Request> {
+  struct Fixed {
+    uint64_t timestamp;
+    uint32_t work_us;
+    uint8_t priority;
+    uint8_t reserved[3];
+  };
+  static void Pack(const example::srv::PrioritizedWork::Request& msg,
+                   Fixed* fixed) {
+    fixed->timestamp = msg.timestamp();
+    fixed->work_us = msg.work_us();
+    fixed->priority = msg.priority();
+    for (auto& byte : fixed->reserved) {
+      byte = 0;
+    }
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::srv::PrioritizedWork::Request* msg) {
+    msg->timestamp(fixed.timestamp);
+    msg->work_us(fixed.work_us);
+    msg->priority(fixed.priority);
+  }
+  template <typename M>
+  static auto Tail(M& /*msg*/) {
+    return std::tuple<>();
+  }
+};
+
+template <>
+struct PodLayout<example::srv::PrioritizedWork::Response> {
+  struct Fixed {
+    uint64_t queued_ns;
+    uint8_t success;
+    uint8_t reserved[7];
+  };
+  static void Pack(const example::srv::PrioritizedWork::Response& msg,
+                   Fixed* fixed) {
+    fixed->queued_ns = msg.queued_ns();
+    fixed->success = msg.success() ? 1 : 0;
+    for (auto& byte : fixed->reserved) {
+      byte = 0;
+    }
+  }
+  static void Unpack(const Fixed& fixed,
+                     example::srv::PrioritizedWork::Response* msg) {
+    msg->queued_ns(fixed.queued_ns);
+    msg->success(fixed.success != 0);
+  }
+  template <typename M>
+  static auto Tail(M& /*msg*/) {
+    return std::tuple<>();
+  }
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,494 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+
+// Binary logging for hot paths:
+//
+//   FAST_AINFO("rx seq={} size={} topic={}", seq, size, topic);
+//
+// The format string and the call site are constants checked at compile
+// time (one "{}" per argument). The calling thread only copies the
+// arguments into a record of its own lock-free buffer; formatting and the
+// write through AINFO/AWARN/AERROR happen on the flush thread. Supported
+// arguments: bool, char, integers, enums, floating point, pointers and
+// strings (const char*, std::string, std::string_view; copied, up to 64
+// bytes per record). A record that does not fit into a full buffer is
+// dropped and counted, the caller never waits.
+#define FAST_AINFO(format, ...) FAST_LOG_AT(kInfo, format, ##__VA_ARGS__)
+#define FAST_AWARN(format, ...) FAST_LOG_AT(kWarn, format, ##__VA_ARGS__)
+#define FAST_AERROR(format, ...) FAST_LOG_AT(kError, format, ##__VA_ARGS__)
+
+#define FAST_LOG_AT(level, format, ...)                                     \
+  do {                                                                      \
+    static constexpr ::example::common::LogSite fast_log_site{              \
+        __FILE__, __LINE__, ::example::common::LogLevel::level, format};    \
+    static_assert(                                                          \
+        ::example::common::fast_log_internal::CountPlaceholders(format) ==  \
+            decltype(::example::common::fast_log_internal::CountArgs(       \
+                __VA_ARGS__))::value,                                       \
+        "FAST_LOG: one {} per argument");                                   \
+    static_assert(decltype(::example::common::fast_log_internal::CountArgs( \
+                      __VA_ARGS__))::value <=                               \
+                      ::example::common::fast_log_internal::kMaxArgs,       \
+                  "FAST_LOG: too many arguments");                          \
+    ::example::common::FastLog::Instance().Log(&fast_log_site,              \
+                                               ##__VA_ARGS__);              \
+  } while (0)
+
+namespace example {
+namespace common {
+
+enum class LogLevel : uint8_t { kInfo, kWarn, kError };
+
+// Everything about a log statement that is known at compile time.
+struct LogSite {
+  const char* file;
+  int line;
+  LogLevel level;
+  const char* format;
+};
+
+namespace fast_log_internal {
+
+constexpr size_t kMaxArgs = 8;
+constexpr size_t kTextBytes = 64;
+
+constexpr size_t CountPlaceholders(const char* format) {
+  size_t count = 0;
+  for (; *format != '\0'; ++format) {
+    if (format[0] == '{' && format[1] == '}') {
+      ++count;
+      ++format;
+    }
+  }
+  return count;
+}
+
+template <typename... Args>
+std::integral_constant<size_t, sizeof...(Args)> CountArgs(const Args&...);
+
+enum class ArgType : uint8_t {
+  kBool,
+  kChar,
+  kInt,
+  kUint,
+  kDouble,
+  kPointer,
+  kText
+};
+
+// One log statement as the hot path leaves it: raw argument values,
+// strings copied into text.
+struct Record {
+  const LogSite* site;
+  uint64_t timestamp_ns;
+  uint32_t thread_id;
+  uint8_t arg_count;
+  uint8_t text_used;
+  ArgType types[kMaxArgs];
+  uint64_t values[kMaxArgs];
+  char text[kTextBytes];
+};
+
+template <typename>
+constexpr bool kAlwaysFalse = false;
+
+inline void PutText(Record* record, std::string_view text) {
+  const size_t offset = record->text_used;
+  const size_t size = std::min(text.size(), kTextBytes - offset);
+  std::memcpy(record->text + offset, text.data(), size);
+  record->text_used = static_cast<uint8_t>(offset + size);
+  record->types[record->arg_count] = ArgType::kText;
+  record->values[record->arg_count] = offset << 32 | size;
+}
+
+template <typename A>
+void Put(Record* record, const A& arg) {
+  using D = std::decay_t<A>;
+  const uint8_t i = record->arg_count;
+  if constexpr (std::is_same_v<D, bool>) {
+    record->types[i] = ArgType::kBool;
+    record->values[i] = arg ? 1 : 0;
+  } else if constexpr (std::is_same_v<D, char>) {
+    record->types[i] = ArgType::kChar;
+    record->values[i] = static_cast<unsigned char>(arg);
+  } else if constexpr (std::is_enum_v<D>) {
+    Put(record, static_cast<std::underlying_type_t<D>>(arg));
+    return;
+  } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+    record->types[i] = ArgType::kInt;
+    record->values[i] = static_cast<uint64_t>(static_cast<int64_t>(arg));
+  } else if constexpr (std::is_integral_v<D>) {
+    record->types[i] = ArgType::kUint;
+    record->values[i] = static_cast<uint64_t>(arg);
+  } else if constexpr (std::is_floating_point_v<D>) {
+    const double value = static_cast<double>(arg);
+    record->types[i] = ArgType::kDouble;
+    std::memcpy(&record->values[i], &value, sizeof(value));
+  } else if constexpr (std::is_array_v<A>) {
+    PutText(record, std::string_view(arg));
+  } else if constexpr (std::is_same_v<D, const char*> ||
+                       std::is_same_v<D, char*>) {
+    PutText(record, arg == nullptr ? "(null)" : arg);
+  } else if constexpr (std::is_convertible_v<const D&, std::string_view>) {
+    PutText(record, std::string_view(arg));
+  } else if constexpr (std::is_pointer_v<D>) {
+    record->types[i] = ArgType::kPointer;
+    record->values[i] = reinterpret_cast<uintptr_t>(arg);
+  } else {
+    static_assert(kAlwaysFalse<D>, "FAST_LOG: unsupported argument type");
+  }
+  record->arg_count = i + 1;
+}
+
+inline void AppendArg(const Record& record, size_t i, std::string* out) {
+  char buffer[32];
+  const uint64_t value = record.values[i];
+  switch (record.types[i]) {
+    case ArgType::kBool:
+      *out += value ? "true" : "false";
+      return;
+    case ArgType::kChar:
+      out->push_back(static_cast<char>(value));
+      return;
+    case ArgType::kInt:
+      snprintf(buffer, sizeof(buffer), "%lld",
+               static_cast<long long>(static_cast<int64_t>(value)));
+      break;
+    case ArgType::kUint:
+      snprintf(buffer, sizeof(buffer), "%llu",
+               static_cast<unsigned long long>(value));
+      break;
+    case ArgType::kDouble: {
+      double d;
+      std::memcpy(&d, &value, sizeof(d));
+      snprintf(buffer, sizeof(buffer), "%g", d);
+      break;
+    }
+    case ArgType::kPointer:
+      snprintf(buffer, sizeof(buffer), "0x%llx",
+               static_cast<unsigned long long>(value));
+      break;
+    case ArgType::kText:
+      out->append(record.text + (value >> 32), value & 0xffffffffULL);
+      return;
+  }
+  *out += buffer;
+}
+
+// Single producer (the owning thread), single consumer (the flush thread)
+// ring of records. Each side caches the other side's index so that it only
+// touches the shared cache line when the ring looks full or empty.
+class ThreadBuffer {
+ public:
+  ThreadBuffer(size_t capacity, uint32_t thread_id)
+      : thread_id_(thread_id), records_(RoundUp(capacity)),
+        mask_(records_.size() - 1) {}
+
+  // Returns the record to fill or nullptr when the ring is full.
+  Record* Claim() {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ >= records_.size()) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ >= records_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+    }
+    Record* record = &records_[head & mask_];
+    record->thread_id = thread_id_;
+    record->arg_count = 0;
+    record->text_used = 0;
+    return record;
+  }
+
+  void Commit() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Flush thread side: appends the pending records to out.
+  void Drain(std::vector<Record>* out) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; ++i) {
+      out->push_back(records_[i & mask_]);
+    }
+    tail_.store(head, std::memory_order_release);
+  }
+
+  uint64_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+  // Set when the owning thread exits; the flush thread frees the buffer
+  // after draining it.
+  std::atomic<bool> retired{false};
+
+ private:
+  static size_t RoundUp(size_t capacity) {
+    size_t size = 64;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    return size;
+  }
+
+  const uint32_t thread_id_;
+  std::vector<Record> records_;
+  const size_t mask_;
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace fast_log_internal
+
+// Process wide backend of the FAST_* macros. The flush thread starts with
+// the first log statement; Configure() before that changes the defaults.
+class FastLog {
+ public:
+  // Receives formatted lines on the flush thread.
+  using Sink = std::function<void(LogLevel, const std::string&)>;
+
+  struct Options {
+    size_t records_per_thread = 8192;
+    uint32_t flush_interval_ms = 20;
+    Sink sink;  // empty: AINFO, AWARN or AERROR by level
+  };
+
+  static void Configure(const Options& options) { DefaultOptions() = options; }
+
+  static FastLog& Instance() {
+    static FastLog instance(DefaultOptions());
+    return instance;
+  }
+
+  ~FastLog() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+  }
+
+  // False when the record was dropped because the buffer was full.
+  template <typename... Args>
+  bool Log(const LogSite* site, const Args&... args) {
+    ThreadBuffer* buffer = LocalBuffer();
+    fast_log_internal::Record* record = buffer->Claim();
+    if (record == nullptr) {
+      return false;
+    }
+    record->site = site;
+    record->timestamp_ns = MonotonicNs();
+    (fast_log_internal::Put(record, args), ...);
+    buffer->Commit();
+    return true;
+  }
+
+  // Blocks until everything logged before the call has been written.
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target = ++flush_requested_;
+    wake_.notify_one();
+    flushed_cv_.wait(lock, [&]() { return flushed_ >= target; });
+  }
+
+  uint64_t written() const { return written_.load(); }
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  using ThreadBuffer = fast_log_internal::ThreadBuffer;
+
+  explicit FastLog(const Options& options)
+      : options_(options),
+        realtime_offset_ns_(RealtimeNs() - MonotonicNs()),
+        flusher_([this]() { Run(); }) {}
+
+  static Options& DefaultOptions() {
+    static Options options;
+    return options;
+  }
+
+  static uint64_t RealtimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+  // Registers the calling thread's buffer on first use.
+  ThreadBuffer* LocalBuffer() {
+    struct Holder {
+      ~Holder() {
+        if (buffer) {
+          buffer->retired.store(true, std::memory_order_release);
+        }
+      }
+      std::shared_ptr<ThreadBuffer> buffer;
+    };
+    thread_local Holder holder;
+    if (!holder.buffer) {
+      holder.buffer = std::make_shared<ThreadBuffer>(
+          options_.records_per_thread,
+          static_cast<uint32_t>(syscall(SYS_gettid)));
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers_.push_back(holder.buffer);
+    }
+    return holder.buffer.get();
+  }
+
+  void Run() {
+    std::vector<fast_log_internal::Record> records;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait_for(lock,
+                     std::chrono::milliseconds(options_.flush_interval_ms),
+                     [this]() { return stop_ || flush_requested_ > flushed_; });
+      const bool stop = stop_;
+      const uint64_t requested = flush_requested_;
+      // Buffers retired before the drain have no more records coming.
+      std::vector<bool> retired;
+      for (const auto& buffer : buffers_) {
+        retired.push_back(buffer->retired.load(std::memory_order_acquire));
+      }
+      buffers = buffers_;
+      lock.unlock();
+
+      records.clear();
+      uint64_t dropped = 0;
+      for (const auto& buffer : buffers) {
+        buffer->Drain(&records);
+        dropped += buffer->TakeDropped();
+      }
+      // Buffers are drained one after the other; sorting restores the
+      // order across threads within a flush.
+      std::stable_sort(records.begin(), records.end(),
+                       [](const auto& a, const auto& b) {
+                         return a.timestamp_ns < b.timestamp_ns;
+                       });
+      for (const auto& record : records) {
+        Write(record);
+      }
+      if (dropped > 0) {
+        Emit(LogLevel::kWarn, "fast_log: dropped " + std::to_string(dropped) +
+                                  " records, buffers full");
+      }
+      written_.fetch_add(records.size());
+      dropped_.fetch_add(dropped);
+
+      lock.lock();
+      for (size_t i = retired.size(); i-- > 0;) {
+        if (retired[i]) {
+          buffers_.erase(buffers_.begin() + i);
+        }
+      }
+      flushed_ = requested;
+      flushed_cv_.notify_all();
+      if (stop) {
+        return;
+      }
+    }
+  }
+
+  void Write(const fast_log_internal::Record& record) {
+    const LogSite& site = *record.site;
+    std::string line;
+    line.reserve(128);
+    const uint64_t wall_ns = realtime_offset_ns_ + record.timestamp_ns;
+    const time_t seconds = static_cast<time_t>(wall_ns / 1000000000ULL);
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+    char prefix[64];
+    const char* file = std::strrchr(site.file, '/');
+    snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%06u %u ", tm.tm_hour,
+             tm.tm_min, tm.tm_sec,
+             static_cast<unsigned>(wall_ns % 1000000000ULL / 1000),
+             record.thread_id);
+    line += prefix;
+    line += file == nullptr ? site.file : file + 1;
+    line += ':';
+    line += std::to_string(site.line);
+    line += "] ";
+    size_t arg = 0;
+    for (const char* p = site.format; *p != '\0'; ++p) {
+      if (p[0] == '{' && p[1] == '}' && arg < record.arg_count) {
+        fast_log_internal::AppendArg(record, arg++, &line);
+        ++p;
+      } else {
+        line.push_back(*p);
+      }
+    }
+    Emit(site.level, line);
+  }
+
+  void Emit(LogLevel level, const std::string& line) {
+    if (options_.sink) {
+      options_.sink(level, line);
+      return;
+    }
+    switch (level) {
+      case LogLevel::kInfo:
+        AINFO << line;
+        break;
+      case LogLevel::kWarn:
+        AWARN << line;
+        break;
+      case LogLevel::kError:
+        AERROR << line;
+        break;
+    }
+  }
+
+  const Options options_;
+  const uint64_t realtime_offset_ns_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_cv_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  bool stop_ = false;
+  uint64_t flush_requested_ = 0;
+  uint64_t flushed_ = 0;
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  // Declared last: the thread starts once everything above is constructed.
+  std::thread flusher_;
+};
+
+}  // namespace common
+}  // namespace example
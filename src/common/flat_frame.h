@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/flat_view.h"
+#include "common/pod_codec.h"
+
+namespace example {
+namespace common {
+
+// Camera frame carried in Payload::data by flat_talker / flat_listener,
+// either as a flat buffer (field ids below) or in the POD format.
+enum FrameField : uint16_t {
+  kFrameStamp = 0,
+  kFrameId,
+  kFrameWidth,
+  kFrameHeight,
+  kFrameEncoding,
+  kFramePixels,
+  kFrameFieldCount,
+};
+
+// Value of Payload::topic_id telling the listener how data is encoded.
+enum class FrameFormat : uint32_t { kPod = 0, kFlat = 1 };
+
+struct Frame {
+  uint64_t stamp = 0;
+  uint32_t id = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::string encoding;
+  std::vector<uint8_t> pixels;
+};
+
+template <>
+struct PodLayout<Frame> {
+  struct Fixed {
+    uint64_t stamp;
+    uint32_t id;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+  };
+  static void Pack(const Frame& frame, Fixed* fixed) {
+    *fixed = {frame.stamp, frame.id, frame.width, frame.height, 0};
+  }
+  static void Unpack(const Fixed& fixed, Frame* frame) {
+    frame->stamp = fixed.stamp;
+    frame->id = fixed.id;
+    frame->width = fixed.width;
+    frame->height = fixed.height;
+  }
+  template <typename M>
+  static auto Tail(M& frame) {
+    return std::forward_as_tuple(frame.encoding, frame.pixels);
+  }
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace example {
+namespace common {
+
+// Flat buffer format for messages carried in a byte array (e.g. the data
+// field of Payload): a header, a table with the offset and size of every
+// field, then the field data, each field 8-byte aligned.
+//
+//   FlatBuilder builder(&msg->data(), kFieldCount);
+//   builder.Set(kStamp, stamp);
+//   builder.SetBytes(kPixels, pixels, size);
+//   builder.Finish();
+//
+//   FlatView view;
+//   if (FlatView::Parse(msg->data().data(), msg->data().size(), &view)) {
+//     uint64_t stamp = view.Get<uint64_t>(kStamp, 0);
+//   }
+//
+// Parsing validates the header and the field table only, so reading a
+// scalar costs the same for a 64B and a 16MB message and allocates nothing.
+// Field ids are small integers fixed by the schema of the message.
+
+namespace flat_internal {
+
+constexpr uint32_t kMagic = 0x31544c46;  // "FLT1"
+constexpr size_t kAlign = 8;
+
+struct Header {
+  uint32_t magic;
+  uint16_t field_count;
+  uint16_t reserved;
+  uint64_t total_size;
+};
+
+struct Entry {
+  uint32_t offset;  // from the start of the buffer, 0 if the field is unset
+  uint32_t size;
+};
+
+constexpr size_t AlignUp(size_t n) { return (n + kAlign - 1) & ~(kAlign - 1); }
+
+}  // namespace flat_internal
+
+template <typename E>
+struct FlatArray {
+  const E* data = nullptr;
+  size_t size = 0;
+
+  const E* begin() const { return data; }
+  const E* end() const { return data + size; }
+  const E& operator[](size_t i) const { return data[i]; }
+  bool empty() const { return size == 0; }
+};
+
+class FlatBuilder {
+ public:
+  // Clears out and reserves the header and field table.
+  FlatBuilder(std::vector<uint8_t>* out, uint16_t field_count)
+      : out_(out), field_count_(field_count) {
+    out_->clear();
+    out_->resize(flat_internal::AlignUp(
+        sizeof(flat_internal::Header) +
+        field_count * sizeof(flat_internal::Entry)));
+  }
+
+  // Reserves the final size up front to avoid reallocations of large
+  // messages.
+  void Reserve(size_t bytes) { out_->reserve(out_->size() + bytes); }
+
+  template <typename T>
+  bool Set(uint16_t id, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "scalar fields must be trivially copyable");
+    return SetBytes(id, &value, sizeof(value));
+  }
+
+  bool SetString(uint16_t id, const std::string& value) {
+    return SetBytes(id, value.data(), value.size());
+  }
+
+  template <typename E>
+  bool SetArray(uint16_t id, const E* data, size_t count) {
+    static_assert(std::is_trivially_copyable<E>::value,
+                  "array elements must be trivially copyable");
+    static_assert(alignof(E) <= flat_internal::kAlign, "");
+    return SetBytes(id, data, count * sizeof(E));
+  }
+
+  // Returns the field storage to be filled in place, e.g. by a camera
+  // driver, or nullptr if the id is out of range. The pointer is valid until
+  // the next field is added unless Reserve() made room for it.
+  uint8_t* Allocate(uint16_t id, size_t size) {
+    if (id >= field_count_ || size > UINT32_MAX) {
+      return nullptr;
+    }
+    const size_t offset = out_->size();
+    if (offset > UINT32_MAX) {
+      return nullptr;
+    }
+    out_->resize(flat_internal::AlignUp(offset + size));
+    flat_internal::Entry entry{static_cast<uint32_t>(offset),
+                               static_cast<uint32_t>(size)};
+    std::memcpy(EntryAt(id), &entry, sizeof(entry));
+    return out_->data() + offset;
+  }
+
+  bool SetBytes(uint16_t id, const void* data, size_t size) {
+    uint8_t* dst = Allocate(id, size);
+    if (dst != nullptr && size != 0) {
+      std::memcpy(dst, data, size);
+    }
+    return dst != nullptr;
+  }
+
+  // Writes the header; returns the size of the finished buffer.
+  size_t Finish() {
+    flat_internal::Header header{flat_internal::kMagic, field_count_, 0,
+                                 out_->size()};
+    std::memcpy(out_->data(), &header, sizeof(header));
+    return out_->size();
+  }
+
+ private:
+  uint8_t* EntryAt(uint16_t id) {
+    return out_->data() + sizeof(flat_internal::Header) +
+           id * sizeof(flat_internal::Entry);
+  }
+
+  std::vector<uint8_t>* out_;
+  uint16_t field_count_;
+};
+
+class FlatView {
+ public:
+  // Checks the header and that every field lies inside the buffer. The view
+  // points into data, which must outlive it.
+  static bool Parse(const uint8_t* data, size_t size, FlatView* view) {
+    flat_internal::Header header;
+    if (data == nullptr || size < sizeof(header)) {
+      return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    const size_t table_end = sizeof(header) +
+                             header.field_count * sizeof(flat_internal::Entry);
+    if (header.magic != flat_internal::kMagic || header.total_size > size ||
+        table_end > header.total_size) {
+      return false;
+    }
+    for (uint16_t id = 0; id < header.field_count; ++id) {
+      const flat_internal::Entry entry = ReadEntry(data, id);
+      // offset is checked first so that the subtraction cannot wrap.
+      if (entry.offset != 0 &&
+          (entry.offset < table_end || entry.offset > header.total_size ||
+           entry.size > header.total_size - entry.offset)) {
+        return false;
+      }
+    }
+    view->data_ = data;
+    view->field_count_ = header.field_count;
+    return true;
+  }
+
+  uint16_t field_count() const { return field_count_; }
+
+  bool Has(uint16_t id) const {
+    return id < field_count_ && ReadEntry(data_, id).offset != 0;
+  }
+
+  template <typename T>
+  T Get(uint16_t id, T fallback) const {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    const uint8_t* p = Field(id, sizeof(T));
+    if (p != nullptr) {
+      std::memcpy(&fallback, p, sizeof(T));
+    }
+    return fallback;
+  }
+
+  // Raw bytes of a field, size 0 if unset.
+  FlatArray<uint8_t> GetBytes(uint16_t id) const {
+    if (!Has(id)) {
+      return {};
+    }
+    const flat_internal::Entry entry = ReadEntry(data_, id);
+    return {data_ + entry.offset, entry.size};
+  }
+
+  std::string GetString(uint16_t id) const {
+    const FlatArray<uint8_t> bytes = GetBytes(id);
+    return std::string(reinterpret_cast<const char*>(bytes.data), bytes.size);
+  }
+
+  // Typed view of an array field without copying. Empty if the field is
+  // unset or the buffer is not aligned for E.
+  template <typename E>
+  FlatArray<E> GetArray(uint16_t id) const {
+    static_assert(std::is_trivially_copyable<E>::value, "");
+    const FlatArray<uint8_t> bytes = GetBytes(id);
+    if (bytes.data == nullptr ||
+        reinterpret_cast<uintptr_t>(bytes.data) % alignof(E) != 0) {
+      return {};
+    }
+    return {reinterpret_cast<const E*>(bytes.data), bytes.size / sizeof(E)};
+  }
+
+ private:
+  static flat_internal::Entry ReadEntry(const uint8_t* data, uint16_t id) {
+    flat_internal::Entry entry;
+    std::memcpy(&entry,
+                data + sizeof(flat_internal::Header) +
+                    id * sizeof(flat_internal::Entry),
+                sizeof(entry));
+    return entry;
+  }
+
+  const uint8_t* Field(uint16_t id, size_t size) const {
+    if (!Has(id)) {
+      return nullptr;
+    }
+    const flat_internal::Entry entry = ReadEntry(data_, id);
+    return entry.size == size ? data_ + entry.offset : nullptr;
+  }
+
+  const uint8_t* data_ = nullptr;
+  uint16_t field_count_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,376 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/proc_stats.h"
+#include "common/token_bucket.h"
+#include "example/msg/Fragment.hpp"
+#include "example/msg/Nack.hpp"
+
+// Fragmentation of large messages on top of ordinary topics: the sender
+// splits a message into Fragment messages of a fixed size and keeps it until
+// the receiver acknowledges it; the receiver copies every fragment straight
+// to its place in a buffer of the final size and asks for missing fragments
+// with Nack messages.
+
+namespace example {
+namespace common {
+
+class FragmentSender {
+ public:
+  using Publish =
+      std::function<bool(const std::shared_ptr<example::msg::Fragment>&)>;
+
+  struct Options {
+    uint32_t fragment_size = 64 * 1024;
+    // Messages kept for retransmission; the oldest is dropped when full.
+    size_t retained_messages = 8;
+  };
+
+  // pacing may be nullptr. publish is called from the thread calling Send
+  // or ServeRetransmits.
+  FragmentSender(Options options, TokenBucket* pacing, Publish publish)
+      : options_(options), pacing_(pacing), publish_(std::move(publish)) {}
+
+  // Publishes every fragment of data, paced by the token bucket. Pending
+  // retransmissions are served between fragments so that they are not
+  // stuck behind a 16MB message.
+  bool Send(uint32_t stream_id, uint64_t timestamp,
+            std::shared_ptr<const std::vector<uint8_t>> data) {
+    if (data->empty() || data->size() > UINT32_MAX ||
+        options_.fragment_size == 0) {
+      return false;
+    }
+    Retained retained{timestamp, std::move(data)};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (retained_.size() >= options_.retained_messages) {
+        retained_.erase(retained_.begin());
+        ++evicted_;
+      }
+      retained_[stream_id] = retained;
+    }
+    const uint32_t count = FragmentCount(retained.data->size());
+    bool ok = true;
+    for (uint32_t index = 0; index < count; ++index) {
+      ok = PublishFragment(stream_id, retained, index, false) && ok;
+      ServeRetransmits();
+    }
+    return ok;
+  }
+
+  // Queues the retransmissions a receiver asked for, or forgets an
+  // acknowledged message. Thread safe, cheap enough for a reader callback.
+  void OnNack(const example::msg::Nack& nack) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nack.complete()) {
+      retained_.erase(nack.stream_id());
+      return;
+    }
+    for (uint32_t index : nack.missing()) {
+      pending_.emplace_back(nack.stream_id(), index);
+    }
+  }
+
+  // Sends the queued retransmissions, returns how many were sent.
+  size_t ServeRetransmits() {
+    size_t sent = 0;
+    for (;;) {
+      std::pair<uint32_t, uint32_t> request;
+      Retained retained;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) {
+          return sent;
+        }
+        request = pending_.front();
+        pending_.pop_front();
+        auto it = retained_.find(request.first);
+        if (it == retained_.end()) {
+          ++unavailable_;
+          continue;
+        }
+        retained = it->second;
+      }
+      if (request.second < FragmentCount(retained.data->size()) &&
+          PublishFragment(request.first, retained, request.second, true)) {
+        ++sent;
+        resent_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  uint64_t fragments_sent() const { return sent_.load(); }
+  uint64_t fragments_resent() const { return resent_.load(); }
+  // Retransmissions asked for messages that were no longer retained.
+  uint64_t unavailable() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return unavailable_;
+  }
+  uint64_t evicted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evicted_;
+  }
+
+ private:
+  struct Retained {
+    uint64_t timestamp = 0;
+    std::shared_ptr<const std::vector<uint8_t>> data;
+  };
+
+  uint32_t FragmentCount(size_t size) const {
+    return static_cast<uint32_t>((size + options_.fragment_size - 1) /
+                                 options_.fragment_size);
+  }
+
+  bool PublishFragment(uint32_t stream_id, const Retained& retained,
+                       uint32_t index, bool retransmit) {
+    const size_t size = retained.data->size();
+    const size_t offset = static_cast<size_t>(index) * options_.fragment_size;
+    const size_t length =
+        std::min<size_t>(options_.fragment_size, size - offset);
+    if (pacing_ != nullptr) {
+      pacing_->Acquire(length);
+    }
+    auto fragment = std::make_shared<example::msg::Fragment>();
+    fragment->stream_id(stream_id);
+    fragment->timestamp(retained.timestamp);
+    fragment->total_size(static_cast<uint32_t>(size));
+    fragment->fragment_index(index);
+    fragment->fragment_count(FragmentCount(size));
+    fragment->fragment_size(options_.fragment_size);
+    fragment->retransmit(retransmit);
+    fragment->data().assign(retained.data->begin() + offset,
+                            retained.data->begin() + offset + length);
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    return publish_(fragment);
+  }
+
+  const Options options_;
+  TokenBucket* pacing_;
+  Publish publish_;
+  mutable std::mutex mutex_;
+  std::map<uint32_t, Retained> retained_;
+  std::deque<std::pair<uint32_t, uint32_t>> pending_;
+  uint64_t unavailable_ = 0;
+  uint64_t evicted_ = 0;
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> resent_{0};
+};
+
+class Reassembler {
+ public:
+  using Complete = std::function<void(uint32_t stream_id, uint64_t timestamp,
+                                      std::vector<uint8_t>&& data)>;
+
+  struct Options {
+    uint32_t max_message_bytes = 64 * 1024 * 1024;
+    // A message that received nothing for this long is asked for its
+    // missing fragments, then again after every further interval.
+    uint64_t nack_delay_ns = 5000000;
+    // A message still incomplete after this long is given up.
+    uint64_t give_up_ns = 2000000000;
+    size_t max_missing_per_nack = 512;
+  };
+
+  Reassembler(Options options, Complete complete)
+      : options_(options), complete_(std::move(complete)) {}
+
+  // Thread safe. Fragments of one message may arrive on several threads at
+  // once: the lookup is done under a lock, the copy into the message buffer
+  // is not, so large fragments are copied in parallel.
+  bool OnFragment(const example::msg::Fragment& fragment) {
+    const uint32_t count = fragment.fragment_count();
+    const uint64_t size = fragment.total_size();
+    const uint64_t fragment_size = fragment.fragment_size();
+    const uint64_t offset = fragment.fragment_index() * fragment_size;
+    // Every fragment but the last is exactly fragment_size long, the last
+    // one the rest; anything shorter would leave a hole in the message.
+    if (size == 0 || size > options_.max_message_bytes ||
+        fragment_size == 0 || count == 0 ||
+        fragment.fragment_index() >= count || offset > size ||
+        fragment.data().size() != std::min(fragment_size, size - offset) ||
+        count != (size + fragment_size - 1) / fragment_size) {
+      malformed_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    const uint64_t now = MonotonicNs();
+    std::shared_ptr<Slot> slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (finished_.count(fragment.stream_id()) != 0) {
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      auto& entry = slots_[fragment.stream_id()];
+      if (!entry) {
+        entry = std::make_shared<Slot>(fragment, now);
+      }
+      slot = entry;
+    }
+    // Compared with what the first fragment set up, not with data, which
+    // the completing thread may be moving out. With the fragment size fixed
+    // every fragment lands at its own offset, without holes or overlaps.
+    if (slot->total_size != size || slot->fragment_size != fragment_size ||
+        slot->count != count) {
+      malformed_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (slot->received[fragment.fragment_index()].exchange(1) != 0) {
+      duplicates_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    std::memcpy(slot->data.data() + offset, fragment.data().data(),
+                fragment.data().size());
+    slot->last_ns.store(now, std::memory_order_relaxed);
+    if (slot->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return true;
+    }
+    // Last fragment: this thread delivers, unless CollectNacks gave the
+    // message up in the meantime.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = slots_.find(fragment.stream_id());
+      if (it == slots_.end() || it->second != slot) {
+        return true;
+      }
+      slots_.erase(it);
+      Finish(fragment.stream_id());
+    }
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    complete_(fragment.stream_id(), slot->timestamp, std::move(slot->data));
+    return true;
+  }
+
+  // Builds the Nacks due at now: acknowledgements of completed messages
+  // and missing fragment lists of stalled ones. Call it periodically.
+  void CollectNacks(uint64_t now, std::vector<example::msg::Nack>* nacks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t stream_id : acks_) {
+      example::msg::Nack nack;
+      nack.stream_id(stream_id);
+      nack.complete(true);
+      nacks->push_back(std::move(nack));
+    }
+    acks_.clear();
+    for (auto it = slots_.begin(); it != slots_.end();) {
+      Slot& slot = *it->second;
+      if (Elapsed(now, slot.first_ns) > options_.give_up_ns) {
+        given_up_.fetch_add(1, std::memory_order_relaxed);
+        Finish(it->first);
+        it = slots_.erase(it);
+        continue;
+      }
+      const uint64_t last = std::max(
+          slot.last_ns.load(std::memory_order_relaxed), slot.last_nack_ns);
+      if (Elapsed(now, last) >= options_.nack_delay_ns) {
+        example::msg::Nack nack;
+        nack.stream_id(it->first);
+        auto& missing = nack.missing();
+        for (uint32_t i = 0;
+             i < slot.count && missing.size() < options_.max_missing_per_nack;
+             ++i) {
+          if (slot.received[i].load(std::memory_order_relaxed) == 0) {
+            missing.push_back(i);
+          }
+        }
+        if (!nack.missing().empty()) {
+          slot.last_nack_ns = now;
+          nacks_sent_.fetch_add(1, std::memory_order_relaxed);
+          nacks->push_back(std::move(nack));
+        }
+      }
+      ++it;
+    }
+  }
+
+  uint64_t completed() const { return completed_.load(); }
+  uint64_t duplicates() const { return duplicates_.load(); }
+  uint64_t malformed() const { return malformed_.load(); }
+  uint64_t given_up() const { return given_up_.load(); }
+  uint64_t nacks_sent() const { return nacks_sent_.load(); }
+
+ private:
+  // now may be older than a stamp OnFragment stored after the caller read
+  // the clock; that counts as no time passed rather than wrapping around.
+  static uint64_t Elapsed(uint64_t now, uint64_t since) {
+    return now > since ? now - since : 0;
+  }
+
+  struct Slot {
+    Slot(const example::msg::Fragment& fragment, uint64_t now)
+        : timestamp(fragment.timestamp()),
+          total_size(fragment.total_size()),
+          fragment_size(fragment.fragment_size()),
+          count(fragment.fragment_count()),
+          data(fragment.total_size()),
+          received(new std::atomic<uint8_t>[fragment.fragment_count()]),
+          remaining(fragment.fragment_count()),
+          first_ns(now),
+          last_ns(now) {
+      for (uint32_t i = 0; i < count; ++i) {
+        received[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    const uint64_t timestamp;
+    const uint64_t total_size;
+    const uint64_t fragment_size;
+    const uint32_t count;
+    std::vector<uint8_t> data;
+    std::unique_ptr<std::atomic<uint8_t>[]> received;
+    std::atomic<uint32_t> remaining;
+    const uint64_t first_ns;
+    std::atomic<uint64_t> last_ns;
+    uint64_t last_nack_ns = 0;  // guarded by mutex_
+  };
+
+  // Remembers a finished stream so that late retransmissions are not taken
+  // for a new message. Called with mutex_ held.
+  void Finish(uint32_t stream_id) {
+    acks_.push_back(stream_id);
+    finished_.insert(stream_id);
+    finished_order_.push_back(stream_id);
+    if (finished_order_.size() > kFinishedHistory) {
+      finished_.erase(finished_order_.front());
+      finished_order_.pop_front();
+    }
+  }
+
+  static constexpr size_t kFinishedHistory = 1024;
+
+  const Options options_;
+  Complete complete_;
+  std::mutex mutex_;
+  std::map<uint32_t, std::shared_ptr<Slot>> slots_;
+  std::vector<uint32_t> acks_;
+  std::set<uint32_t> finished_;
+  std::deque<uint32_t> finished_order_;
+  std::atomic<uint64_t> completed_{0};
+  std::atomic<uint64_t> duplicates_{0};
+  std::atomic<uint64_t> malformed_{0};
+  std::atomic<uint64_t> given_up_{0};
+  std::atomic<uint64_t> nacks_sent_{0};
+};
+
+}  // namespace common
+}  // namespace example
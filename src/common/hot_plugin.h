@@ -0,0 +1,253 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Exports `Class` as the plugin implementation of `Interface` from a shared
+// library loaded by HotPlugin<Interface>.
+#define EXAMPLE_REGISTER_PLUGIN(Interface, Class)                            \
+  extern "C" Interface* ExampleCreatePlugin() { return new Class(); }        \
+  extern "C" void ExampleDestroyPlugin(Interface* plugin) { delete plugin; } \
+  extern "C" const char* ExamplePluginInterface() {                          \
+    return Interface::kInterfaceName;                                        \
+  }
+
+namespace example {
+namespace common {
+
+// Logic of a component kept in its own shared library and swapped while the
+// process runs. The component keeps its node, readers and writers, and so
+// its subscriptions and SHM mappings; only the code behind them changes.
+//
+// `Interface` declares `static constexpr char kInterfaceName[]`, bumped with
+// every incompatible change, and the member functions
+//   bool Init();
+//   std::string SaveState() const;
+//   void RestoreState(const std::string& state);
+// A library is only loaded when its EXAMPLE_REGISTER_PLUGIN names the same
+// interface.
+//
+// Each load dlopen()s a private copy of the library: the dynamic loader
+// returns the already loaded image for a path it knows, and the build may
+// overwrite the file while the old code is still mapped. The copy lives in
+// an anonymous memfd opened through /proc/self/fd, so no other user can
+// replace it between the copy and the dlopen(). A reload creates
+// and initializes the new instance first, hands the state of the old one
+// over and only then swaps them, so a library that fails to load or to
+// initialize leaves the running one in place.
+//
+// Not thread-safe: Load(), ReloadIfChanged() and calls through get() come
+// from one thread, e.g. the Proc() of the component. Messages that arrive
+// during a reload wait in the reader queue.
+template <typename Interface>
+class HotPlugin {
+ public:
+  explicit HotPlugin(std::string path) : path_(std::move(path)) {}
+
+  HotPlugin(const HotPlugin&) = delete;
+  HotPlugin& operator=(const HotPlugin&) = delete;
+
+  // Loads the library at the path; false keeps the current instance.
+  bool Load(std::string* error) {
+    FileStamp stamp;
+    if (!Stat(&stamp)) {
+      *error = "cannot stat " + path_;
+      return false;
+    }
+    auto next = Open(error);
+    if (next == nullptr) {
+      return false;
+    }
+    if (!next->Init()) {
+      *error = "Init of " + path_ + " failed";
+      return false;
+    }
+    if (instance_ != nullptr) {
+      next->RestoreState(instance_->SaveState());
+    }
+    // The old instance and its library go here, after the new one is ready.
+    instance_ = std::move(next);
+    loaded_ = stamp;
+    pending_ = stamp;
+    ++generation_;
+    return true;
+  }
+
+  // Reloads once the file changed and kept its new size and time for one
+  // more check, so a library still being written is not loaded. Returns
+  // true when it reloaded; a failed reload is reported in `error`.
+  bool ReloadIfChanged(std::string* error) {
+    FileStamp stamp;
+    if (!Stat(&stamp) || stamp == loaded_) {
+      return false;
+    }
+    if (!(stamp == pending_)) {
+      pending_ = stamp;
+      return false;
+    }
+    if (!Load(error)) {
+      // Not retried until the file changes again.
+      loaded_ = stamp;
+      return false;
+    }
+    return true;
+  }
+
+  Interface* get() const { return instance_.get(); }
+  // Successful loads so far.
+  uint32_t generation() const { return generation_; }
+  const std::string& path() const { return path_; }
+
+ private:
+  struct FileStamp {
+    int64_t mtime_ns = 0;
+    int64_t size = -1;
+    bool operator==(const FileStamp& other) const {
+      return mtime_ns == other.mtime_ns && size == other.size;
+    }
+  };
+
+  // Destroys the instance before its code is unmapped. The memfd of the
+  // copy stays open until then, so a later copy cannot get the same
+  // /proc/self/fd path while the loader still knows this one.
+  struct Deleter {
+    void* handle = nullptr;
+    void (*destroy)(Interface*) = nullptr;
+    int fd = -1;
+    void operator()(Interface* plugin) const {
+      destroy(plugin);
+      dlclose(handle);
+      close(fd);
+    }
+  };
+  using Instance = std::unique_ptr<Interface, Deleter>;
+
+  bool Stat(FileStamp* stamp) const {
+    struct stat st;
+    if (stat(path_.c_str(), &st) != 0) {
+      return false;
+    }
+    stamp->mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                      st.st_mtim.tv_nsec;
+    stamp->size = static_cast<int64_t>(st.st_size);
+    return true;
+  }
+
+  Instance Open(std::string* error) {
+    const int fd = Copy(error);
+    if (fd < 0) {
+      return nullptr;
+    }
+    const std::string copy = "/proc/self/fd/" + std::to_string(fd);
+    void* handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+      *error = dlerror();
+      close(fd);
+      return nullptr;
+    }
+    auto create = reinterpret_cast<Interface* (*)()>(
+        dlsym(handle, "ExampleCreatePlugin"));
+    auto destroy = reinterpret_cast<void (*)(Interface*)>(
+        dlsym(handle, "ExampleDestroyPlugin"));
+    auto name = reinterpret_cast<const char* (*)()>(
+        dlsym(handle, "ExamplePluginInterface"));
+    if (create == nullptr || destroy == nullptr || name == nullptr) {
+      *error = path_ + " is not a plugin";
+      dlclose(handle);
+      close(fd);
+      return nullptr;
+    }
+    if (std::strcmp(name(), Interface::kInterfaceName) != 0) {
+      *error = path_ + " implements " + name() + ", expected " +
+               Interface::kInterfaceName;
+      dlclose(handle);
+      close(fd);
+      return nullptr;
+    }
+    Interface* plugin = create();
+    if (plugin == nullptr) {
+      *error = path_ + " created no instance";
+      dlclose(handle);
+      close(fd);
+      return nullptr;
+    }
+    return Instance(plugin, Deleter{handle, destroy, fd});
+  }
+
+  // Copies the library into a new memfd; returns the fd or -1.
+  int Copy(std::string* error) const {
+    const int in = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+      *error = "cannot open " + path_ + ": " + std::strerror(errno);
+      return -1;
+    }
+    const size_t slash = path_.rfind('/');
+    const std::string name =
+        slash == std::string::npos ? path_ : path_.substr(slash + 1);
+    const int out = memfd_create(name.c_str(), MFD_CLOEXEC);
+    if (out < 0) {
+      *error = std::string("memfd_create failed: ") + std::strerror(errno);
+      close(in);
+      return -1;
+    }
+    const bool copied = CopyFd(in, out);
+    const int saved_errno = errno;
+    close(in);
+    if (!copied) {
+      *error = "cannot copy " + path_ + ": " + std::strerror(saved_errno);
+      close(out);
+      return -1;
+    }
+    return out;
+  }
+
+  static bool CopyFd(int in, int out) {
+    char buffer[64 * 1024];
+    for (;;) {
+      const ssize_t n = read(in, buffer, sizeof(buffer));
+      if (n == 0) {
+        return true;
+      }
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      for (ssize_t done = 0; done < n;) {
+        const ssize_t w = write(out, buffer + done, n - done);
+        if (w < 0 && errno != EINTR) {
+          return false;
+        }
+        done += w < 0 ? 0 : w;
+      }
+    }
+  }
+
+  const std::string path_;
+  Instance instance_{nullptr, Deleter{}};
+  FileStamp loaded_;
+  FileStamp pending_;
+  uint32_t generation_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+#include "common/proc_stats.h"
+
+namespace example {
+namespace common {
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Wake-up channel between a producer (e.g. a reader callback) and one
+// consumer thread, built on a sequence counter. The consumer can spin on the
+// counter for a bounded budget before sleeping on a futex, trading CPU for
+// the wake-up latency of the sleep path.
+class HybridWaiter {
+ public:
+  enum class Mode {
+    kSleep,   // futex only
+    kSpin,    // poll until the timeout, never sleep
+    kHybrid,  // poll for the spin budget, then futex
+  };
+
+  static bool ParseMode(const std::string& name, Mode* mode) {
+    if (name == "sleep") {
+      *mode = Mode::kSleep;
+    } else if (name == "spin") {
+      *mode = Mode::kSpin;
+    } else if (name == "hybrid") {
+      *mode = Mode::kHybrid;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  HybridWaiter(Mode mode, std::chrono::nanoseconds spin_budget)
+      : mode_(mode), spin_budget_ns_(spin_budget.count()) {}
+
+  HybridWaiter(const HybridWaiter&) = delete;
+  HybridWaiter& operator=(const HybridWaiter&) = delete;
+
+  uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+  void Notify() {
+    seq_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_),
+              FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+  }
+
+  // Returns true once sequence() differs from `seen`, false on timeout.
+  bool WaitChanged(uint32_t seen, std::chrono::nanoseconds timeout) {
+    const uint64_t start = MonotonicNs();
+    const uint64_t deadline = start + timeout.count();
+    if (mode_ != Mode::kSleep) {
+      const uint64_t spin_end =
+          mode_ == Mode::kSpin ? deadline : start + spin_budget_ns_;
+      for (uint32_t i = 1;; ++i) {
+        if (sequence() != seen) {
+          ++spin_wakeups_;
+          return true;
+        }
+        CpuRelax();
+        if (i % 64 == 0 && MonotonicNs() >= spin_end) {
+          break;
+        }
+      }
+      if (mode_ == Mode::kSpin) {
+        return false;
+      }
+    }
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    bool changed = false;
+    for (;;) {
+      if (sequence() != seen) {
+        changed = true;
+        break;
+      }
+      const uint64_t now = MonotonicNs();
+      if (now >= deadline) {
+        break;
+      }
+      const uint64_t left = deadline - now;
+      struct timespec ts;
+      ts.tv_sec = static_cast<time_t>(left / 1000000000ULL);
+      ts.tv_nsec = static_cast<long>(left % 1000000000ULL);
+      // Returns at once if the counter moved after the check above.
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_),
+              FUTEX_WAIT_PRIVATE, seen, &ts, nullptr, 0);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+    if (changed) {
+      ++sleep_wakeups_;
+    }
+    return changed;
+  }
+
+  // Wake-ups served by polling and by the futex, for reporting.
+  uint64_t spin_wakeups() const { return spin_wakeups_; }
+  uint64_t sleep_wakeups() const { return sleep_wakeups_; }
+
+ private:
+  const Mode mode_;
+  const uint64_t spin_budget_ns_;
+  std::atomic<uint32_t> seq_{0};
+  std::atomic<uint32_t> sleepers_{0};
+  uint64_t spin_wakeups_ = 0;
+  uint64_t sleep_wakeups_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
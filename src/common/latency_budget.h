@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/msg/LatencyAlert.hpp"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+// Topic the LatencyAlert events of all stages are published on.
+constexpr char kLatencyAlertTopic[] = "/latency_budget/alerts";
+
+// Checks the pipeline latency of one stage against its budget. The first
+// writer of a chain stamps the message with MonotonicNs(); every reader or
+// component along the DAG calls Check() with that stamp, which measures the
+// time since publication on the shared monotonic clock. The cost is one
+// clock read and a histogram update, no per-message record leaves the
+// process. Violations are logged and published as LatencyAlert, both rate
+// limited to one per min_alert_interval_ms; a summary is logged every
+// report_interval_s. Thread safe.
+class LatencyBudget {
+ public:
+  struct Options {
+    std::string stage;
+    uint64_t budget_ns = 0;  // 0: measure only
+    uint32_t report_interval_s = 10;
+    uint32_t min_alert_interval_ms = 1000;
+  };
+
+  // node may be null: violations are then only logged.
+  LatencyBudget(const std::shared_ptr<rti::segar::Node>& node,
+                Options options)
+      : options_(std::move(options)) {
+    if (node && options_.budget_ns > 0) {
+      writer_ = node->CreateWriter<example::msg::LatencyAlert>(
+          kLatencyAlertTopic);
+    }
+    next_report_ns_ = MonotonicNs() + options_.report_interval_s * kNsPerS;
+  }
+
+  // Returns whether the message stamped stamp_ns is within the budget.
+  bool Check(uint64_t stamp_ns) {
+    const uint64_t now = MonotonicNs();
+    const uint64_t latency = now > stamp_ns ? now - stamp_ns : 0;
+    const bool late = options_.budget_ns > 0 && latency > options_.budget_ns;
+    bool alert = false;
+    bool report = false;
+    uint64_t violations = 0;
+    std::string summary;
+    {
+      rti::segar::LockGuard<std::mutex> lock(mutex_);
+      window_.Record(latency);
+      if (late) {
+        violations = ++violations_;
+        if (now >= next_alert_ns_) {
+          alert = true;
+          next_alert_ns_ = now + options_.min_alert_interval_ms * kNsPerMs;
+        }
+      }
+      if (options_.report_interval_s > 0 && now >= next_report_ns_) {
+        report = true;
+        violations = violations_;
+        summary = window_.Summary(1e6);
+        window_.Reset();
+        next_report_ns_ = now + options_.report_interval_s * kNsPerS;
+      }
+    }
+    if (alert) {
+      Alert(stamp_ns, latency, violations);
+    }
+    if (report) {
+      AINFO << "latency_budget: stage=" << options_.stage
+            << " budget_ms=" << options_.budget_ns / 1e6
+            << " violations=" << violations << " latency_ms{" << summary
+            << "}";
+    }
+    return !late;
+  }
+
+  uint64_t violations() const {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    return violations_;
+  }
+
+ private:
+  static constexpr uint64_t kNsPerMs = 1000000ULL;
+  static constexpr uint64_t kNsPerS = 1000000000ULL;
+
+  void Alert(uint64_t stamp_ns, uint64_t latency, uint64_t violations) {
+    AWARN << "latency_budget: stage=" << options_.stage
+          << " latency_ms=" << latency / 1e6
+          << " budget_ms=" << options_.budget_ns / 1e6
+          << " violations=" << violations;
+    if (!writer_) {
+      return;
+    }
+    auto msg = std::make_shared<example::msg::LatencyAlert>();
+    msg->stage(options_.stage);
+    msg->timestamp(stamp_ns);
+    msg->latency_ns(latency);
+    msg->budget_ns(options_.budget_ns);
+    msg->violations(violations);
+    writer_->Write(msg);
+  }
+
+  const Options options_;
+  std::shared_ptr<rti::segar::Writer<example::msg::LatencyAlert>> writer_;
+  mutable std::mutex mutex_;
+  LatencyHistogram window_;
+  uint64_t violations_ = 0;
+  uint64_t next_alert_ns_ = 0;
+  uint64_t next_report_ns_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
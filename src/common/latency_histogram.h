@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace example {
+namespace common {
+
+// Log-linear histogram of nanosecond values: every power of two is split
+// into 16 linear sub-buckets, so a percentile is off by at most 1/16 of its
+// value. Recording is O(1) and allocation free; the class is not thread
+// safe, callers keep one per thread or guard it.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBits = 4;
+  static constexpr uint64_t kSubCount = uint64_t{1} << kSubBits;
+  static constexpr size_t kNumBuckets = (64 - kSubBits + 1) * kSubCount;
+
+  static size_t BucketOf(uint64_t value) {
+    if (value < kSubCount) {
+      return static_cast<size_t>(value);
+    }
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - kSubBits;
+    return static_cast<size_t>((shift + 1) * kSubCount +
+                               ((value >> shift) - kSubCount));
+  }
+
+  // Largest value that falls into the bucket.
+  static uint64_t BucketUpper(size_t bucket) {
+    if (bucket < kSubCount) {
+      return bucket;
+    }
+    const int shift = static_cast<int>(bucket / kSubCount) - 1;
+    const uint64_t lower = (kSubCount + bucket % kSubCount) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+  }
+
+  void Record(uint64_t value) {
+    ++counts_[BucketOf(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  void Reset() { *this = LatencyHistogram(); }
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_;
+  }
+
+  uint64_t Percentile(double pct) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    const auto target = std::max<uint64_t>(
+        1, static_cast<uint64_t>(pct / 100.0 * count_ + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += counts_[i];
+      if (seen >= target) {
+        return std::min(BucketUpper(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  // "n=1000 avg=27.4 min=20.1 p50=26.0 p90=31.0 p99=60.0 p99.9=150.0
+  // max=168.2", values divided by `unit` (1000 prints microseconds).
+  std::string Summary(double unit = 1000.0) const {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(2);
+    oss << "n=" << count_ << " avg=" << mean() / unit
+        << " min=" << min() / unit << " p50=" << Percentile(50) / unit
+        << " p90=" << Percentile(90) / unit
+        << " p99=" << Percentile(99) / unit
+        << " p99.9=" << Percentile(99.9) / unit << " max=" << max_ / unit;
+    return oss.str();
+  }
+
+ private:
+  std::array<uint64_t, kNumBuckets> counts_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
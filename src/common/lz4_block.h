@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// LZ4 block format (doc/lz4_Block_format.md in the LZ4 sources)
+// with a greedy single-probe match finder, the same scheme as LZ4's default
+// "fast" level. Blocks are compatible with LZ4_decompress_safe and with the
+// blocks of the lz4 command line tool.
+
+namespace example {
+namespace common {
+
+namespace lz4_internal {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;   // the block ends with literals
+constexpr size_t kMatchFindLimit = 12;  // no match starts in the last bytes
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashBits = 14;
+
+inline uint32_t Read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32 - kHashBits);
+}
+
+// Writes a length continuation: 255 bytes then the remainder.
+inline uint8_t* PutLength(uint8_t* op, size_t length) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+// Emits literals and, if match_length is not 0, a match; returns nullptr if
+// the output is too small. match_length excludes the implicit minimum.
+inline uint8_t* PutSequence(uint8_t* op, uint8_t* oend,
+                            const uint8_t* literals, size_t literal_length,
+                            size_t offset, size_t match_length,
+                            bool has_match) {
+  const size_t worst = 1 + literal_length / 255 + 1 + literal_length + 2 +
+                       match_length / 255 + 1;
+  if (worst > static_cast<size_t>(oend - op)) {
+    return nullptr;
+  }
+  uint8_t* token = op++;
+  *token = static_cast<uint8_t>((literal_length < 15 ? literal_length : 15)
+                                << 4);
+  if (literal_length >= 15) {
+    op = PutLength(op, literal_length - 15);
+  }
+  if (literal_length != 0) {
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+  }
+  if (!has_match) {
+    return op;
+  }
+  *op++ = static_cast<uint8_t>(offset);
+  *op++ = static_cast<uint8_t>(offset >> 8);
+  *token |= static_cast<uint8_t>(match_length < 15 ? match_length : 15);
+  if (match_length >= 15) {
+    op = PutLength(op, match_length - 15);
+  }
+  return op;
+}
+
+}  // namespace lz4_internal
+
+inline size_t Lz4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+// Compresses src into dst, returns the compressed size or 0 if it does not
+// fit into capacity (use Lz4CompressBound to never fail).
+inline size_t Lz4Compress(const uint8_t* src, size_t size, uint8_t* dst,
+                          size_t capacity) {
+  using namespace lz4_internal;  // NOLINT
+  uint8_t* op = dst;
+  uint8_t* const oend = dst + capacity;
+  const uint8_t* anchor = src;
+  if (size > kMatchFindLimit) {
+    // Positions relative to src; the table is per thread to keep the
+    // 64KB off small coroutine stacks and out of the allocator.
+    thread_local std::vector<uint32_t> table;
+    table.assign(size_t{1} << kHashBits, 0);
+    const uint8_t* const match_find_limit = src + size - kMatchFindLimit;
+    const uint8_t* const match_limit = src + size - kLastLiterals;
+    const uint8_t* ip = src + 1;
+    uint32_t misses = 0;
+    while (ip < match_find_limit) {
+      const uint32_t h = Hash(Read32(ip));
+      const uint8_t* ref = src + table[h];
+      table[h] = static_cast<uint32_t>(ip - src);
+      if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxOffset ||
+          Read32(ref) != Read32(ip)) {
+        // Step faster through data that does not compress.
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+      while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+      const uint8_t* mp = ip + kMinMatch;
+      const uint8_t* rp = ref + kMinMatch;
+      while (mp < match_limit && *mp == *rp) {
+        ++mp;
+        ++rp;
+      }
+      op = PutSequence(op, oend, anchor, static_cast<size_t>(ip - anchor),
+                       static_cast<size_t>(ip - ref),
+                       static_cast<size_t>(mp - ip) - kMinMatch, true);
+      if (op == nullptr) {
+        return 0;
+      }
+      ip = mp;
+      anchor = ip;
+      if (ip < match_find_limit) {
+        table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+      }
+    }
+  }
+  op = PutSequence(op, oend, anchor,
+                   static_cast<size_t>(src + size - anchor), 0, 0, false);
+  return op == nullptr ? 0 : static_cast<size_t>(op - dst);
+}
+
+// Decompresses a block that must expand to exactly raw_size bytes. Safe
+// against malformed input: never reads or writes out of bounds.
+inline bool Lz4Decompress(const uint8_t* src, size_t size, uint8_t* dst,
+                          size_t raw_size) {
+  const uint8_t* ip = src;
+  const uint8_t* const iend = src + size;
+  uint8_t* op = dst;
+  uint8_t* const oend = dst + raw_size;
+  auto get_length = [&ip, iend](size_t* length) {
+    uint8_t byte;
+    do {
+      if (ip >= iend) {
+        return false;
+      }
+      byte = *ip++;
+      *length += byte;
+    } while (byte == 255);
+    return true;
+  };
+  for (;;) {
+    if (ip >= iend) {
+      return false;
+    }
+    const uint8_t token = *ip++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !get_length(&literal_length)) {
+      return false;
+    }
+    if (literal_length > static_cast<size_t>(iend - ip) ||
+        literal_length > static_cast<size_t>(oend - op)) {
+      return false;
+    }
+    if (literal_length != 0) {
+      std::memcpy(op, ip, literal_length);
+      ip += literal_length;
+      op += literal_length;
+    }
+    if (ip == iend) {
+      return op == oend;  // the last sequence has no match
+    }
+    if (iend - ip < 2) {
+      return false;
+    }
+    const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+      return false;
+    }
+    size_t match_length = token & 15;
+    if (match_length == 15 && !get_length(&match_length)) {
+      return false;
+    }
+    match_length += lz4_internal::kMinMatch;
+    if (match_length > static_cast<size_t>(oend - op)) {
+      return false;
+    }
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      std::memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      // Overlapping copy repeats the last offset bytes. With an offset of at
+      // least 8, every 8-byte chunk reads bytes that are already written.
+      size_t i = 0;
+      if (offset >= 8) {
+        for (; i + 8 <= match_length; i += 8) {
+          std::memcpy(op + i, match + i, 8);
+        }
+      }
+      for (; i < match_length; ++i) {
+        op[i] = match[i];
+      }
+      op += match_length;
+    }
+  }
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,495 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace example {
+namespace common {
+
+// What an account holds; the overflow policies pick their victims by kind.
+enum class MemoryKind {
+  kShm,           // mapped SHM blocks
+  kReaderQueue,   // messages waiting in reader pending queues
+  kHistory,       // writer history kept for late joiners
+  kPool,          // preallocated message and buffer pools
+  kActionGoals,   // retained action goals and results
+  kTracing,       // trace and log buffers
+  kOther,
+};
+
+inline const char* ToString(MemoryKind kind) {
+  switch (kind) {
+    case MemoryKind::kShm:
+      return "shm";
+    case MemoryKind::kReaderQueue:
+      return "queue";
+    case MemoryKind::kHistory:
+      return "history";
+    case MemoryKind::kPool:
+      return "pool";
+    case MemoryKind::kActionGoals:
+      return "goals";
+    case MemoryKind::kTracing:
+      return "tracing";
+    case MemoryKind::kOther:
+      break;
+  }
+  return "other";
+}
+
+inline bool ParseMemoryKind(const std::string& name, MemoryKind* kind) {
+  for (MemoryKind k : {MemoryKind::kShm, MemoryKind::kReaderQueue,
+                       MemoryKind::kHistory, MemoryKind::kPool,
+                       MemoryKind::kActionGoals, MemoryKind::kTracing,
+                       MemoryKind::kOther}) {
+    if (name == ToString(k)) {
+      *kind = k;
+      return true;
+    }
+  }
+  return false;
+}
+
+// What happens when a charge does not fit the budget.
+enum class OverflowPolicy {
+  kShrinkHistory,  // reduce the depth of history accounts
+  kDropOldest,     // drop the oldest entries of queues, histories and pools
+  kRejectCharges,  // refuse the charge, the holder drops what it would keep
+};
+
+inline bool ParseOverflowPolicy(const std::string& name,
+                                OverflowPolicy* policy) {
+  if (name == "shrink_history") {
+    *policy = OverflowPolicy::kShrinkHistory;
+  } else if (name == "drop_oldest") {
+    *policy = OverflowPolicy::kDropOldest;
+  } else if (name == "reject_charges") {
+    *policy = OverflowPolicy::kRejectCharges;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+inline const char* ToString(OverflowPolicy policy) {
+  switch (policy) {
+    case OverflowPolicy::kShrinkHistory:
+      return "shrink_history";
+    case OverflowPolicy::kDropOldest:
+      return "drop_oldest";
+    case OverflowPolicy::kRejectCharges:
+      break;
+  }
+  return "reject_charges";
+}
+
+// Per-node memory accounting of a process against one budget. Every holder
+// of memory the runtime does not account for itself (pending queues,
+// histories, pools, retained goals, trace buffers) registers an account
+// under its node name and charges what it keeps; a memory monitor sets the
+// accounts it can only measure (mapped SHM) and checks the RSS of the
+// process on every tick with Enforce().
+//
+// A charge that would exceed the budget first has the policy reclaim memory
+// from the accounts it applies to, largest first, through the reclaimer each
+// account registered. A charge that still does not fit is refused and the
+// caller drops the data it was about to keep. With kRejectCharges nothing is
+// reclaimed, and once Enforce() saw the RSS over budget every charge is
+// refused until it is back under. Only charges are refused: memory the
+// runtime holds, such as its writer histories, is measured or estimated
+// but never throttled.
+//
+// A budget of 0 disables enforcement, the accounting stays.
+class MemoryBudget {
+ public:
+  // Frees at least `want` bytes if it can, in the way `policy` asks for,
+  // and returns what it freed, after releasing it through its account. It
+  // runs without a lock of the budget held, one reclaim per account at a
+  // time.
+  using Reclaimer = std::function<uint64_t(uint64_t want,
+                                           OverflowPolicy policy)>;
+
+  class Account {
+   public:
+    Account(const Account&) = delete;
+    Account& operator=(const Account&) = delete;
+
+    ~Account() { budget_->used_.fetch_sub(bytes_.load()); }
+
+    // Charges `bytes` if the budget allows it, see MemoryBudget.
+    bool TryCharge(uint64_t bytes) { return budget_->Charge(this, bytes); }
+    // Charges without checking, for memory that is already held.
+    void Add(uint64_t bytes) {
+      budget_->used_.fetch_add(bytes);
+      Hold(bytes);
+    }
+    void Release(uint64_t bytes) {
+      bytes = std::min<uint64_t>(bytes, bytes_.load());
+      bytes_.fetch_sub(bytes);
+      budget_->used_.fetch_sub(bytes);
+    }
+    // Sets a measured or estimated size.
+    void Set(uint64_t bytes) {
+      const uint64_t old = bytes_.exchange(bytes);
+      budget_->used_.fetch_add(bytes - old);
+      UpdatePeak(bytes);
+    }
+
+    const std::string& node() const { return node_; }
+    const std::string& name() const { return name_; }
+    MemoryKind kind() const { return kind_; }
+    uint64_t bytes() const { return bytes_.load(); }
+    uint64_t peak() const { return peak_.load(); }
+
+    // Stops reclaiming, waiting for a running reclaim. Holders call it
+    // before they destroy what the reclaimer refers to.
+    void Close() {
+      std::lock_guard<std::mutex> lock(reclaim_mutex_);
+      reclaimer_ = nullptr;
+    }
+
+   private:
+    friend class MemoryBudget;
+    Account(MemoryBudget* budget, std::string node, std::string name,
+            MemoryKind kind, Reclaimer reclaimer)
+        : budget_(budget),
+          node_(std::move(node)),
+          name_(std::move(name)),
+          kind_(kind),
+          reclaimer_(std::move(reclaimer)) {}
+
+    uint64_t Reclaim(uint64_t want, OverflowPolicy policy) {
+      std::lock_guard<std::mutex> lock(reclaim_mutex_);
+      return reclaimer_ ? reclaimer_(want, policy) : 0;
+    }
+
+    // The account's share of bytes the budget already counts.
+    void Hold(uint64_t bytes) { UpdatePeak(bytes_.fetch_add(bytes) + bytes); }
+
+    void UpdatePeak(uint64_t bytes) {
+      uint64_t peak = peak_.load();
+      while (bytes > peak && !peak_.compare_exchange_weak(peak, bytes)) {
+      }
+    }
+
+    MemoryBudget* budget_;
+    const std::string node_;
+    const std::string name_;
+    const MemoryKind kind_;
+    std::mutex reclaim_mutex_;
+    Reclaimer reclaimer_;
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> peak_{0};
+  };
+
+  struct AccountStats {
+    std::string node;
+    std::string name;
+    MemoryKind kind;
+    uint64_t bytes;
+    uint64_t peak;
+  };
+
+  // The budget of the process, shared by the components it loads.
+  static MemoryBudget& Instance() {
+    static MemoryBudget budget;
+    return budget;
+  }
+
+  MemoryBudget() = default;
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  void Configure(uint64_t budget_bytes, OverflowPolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = budget_bytes;
+    policy_ = policy;
+    rejecting_ = false;
+  }
+
+  // Accounts live as long as their holder keeps the returned pointer.
+  std::shared_ptr<Account> Register(const std::string& node,
+                                    const std::string& name, MemoryKind kind,
+                                    Reclaimer reclaimer = nullptr) {
+    std::shared_ptr<Account> account(
+        new Account(this, node, name, kind, std::move(reclaimer)));
+    std::lock_guard<std::mutex> lock(mutex_);
+    Prune();
+    accounts_.push_back(account);
+    return account;
+  }
+
+  // Brings a measured usage, e.g. the RSS, under the budget by the policy.
+  // Returns how much it is still over. Freed heap memory does not always
+  // go back to the system, so the next measurement may stay high.
+  uint64_t Enforce(uint64_t usage) {
+    OverflowPolicy policy;
+    uint64_t over = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (budget_ == 0 || usage <= budget_) {
+        rejecting_ = false;
+        return 0;
+      }
+      over = usage - budget_;
+      policy = policy_;
+      if (policy == OverflowPolicy::kRejectCharges) {
+        rejecting_ = true;
+        return over;
+      }
+    }
+    const uint64_t freed = Reclaim(over, policy);
+    return freed >= over ? 0 : over - freed;
+  }
+
+  uint64_t budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+  }
+  OverflowPolicy policy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+  }
+  // Bytes charged to all accounts.
+  uint64_t used() const { return used_.load(); }
+  bool rejecting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rejecting_;
+  }
+  // Charges refused and bytes the reclaimers freed so far.
+  uint64_t rejected() const { return rejected_.load(); }
+  uint64_t reclaimed() const { return reclaimed_.load(); }
+
+  std::vector<AccountStats> Snapshot() const {
+    std::vector<AccountStats> stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& weak : accounts_) {
+      if (auto account = weak.lock()) {
+        stats.push_back({account->node(), account->name(), account->kind(),
+                         account->bytes(), account->peak()});
+      }
+    }
+    return stats;
+  }
+
+  // One line per account, grouped by node, and a total.
+  std::string Report() const {
+    auto stats = Snapshot();
+    std::stable_sort(stats.begin(), stats.end(),
+                     [](const AccountStats& a, const AccountStats& b) {
+                       return a.node < b.node;
+                     });
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    for (const auto& account : stats) {
+      oss << account.node << " " << account.name << " ["
+          << ToString(account.kind) << "] " << account.bytes / 1024.0
+          << "KB peak=" << account.peak / 1024.0 << "KB\n";
+    }
+    const uint64_t limit = budget();
+    oss << "total " << used() / 1024.0 << "KB budget=";
+    if (limit == 0) {
+      oss << "off";
+    } else {
+      oss << limit / 1024.0 << "KB policy=" << ToString(policy());
+    }
+    oss << " rejected=" << rejected() << " reclaimed="
+        << reclaimed() / 1024.0 << "KB";
+    return oss.str();
+  }
+
+ private:
+  bool Charge(Account* account, uint64_t bytes) {
+    uint64_t limit;
+    OverflowPolicy policy;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (budget_ != 0 && rejecting_) {
+        rejected_.fetch_add(1);
+        return false;
+      }
+      limit = budget_;
+      policy = policy_;
+    }
+    // The bytes are reserved in used_ by the same compare-exchange that
+    // checks them, so concurrent charges cannot overshoot the budget
+    // together. After a reclaim the check is made once more, others may
+    // have taken what was freed.
+    for (bool reclaimed = false;; reclaimed = true) {
+      uint64_t used = used_.load();
+      while (limit == 0 || used + bytes <= limit) {
+        if (used_.compare_exchange_weak(used, used + bytes)) {
+          account->Hold(bytes);
+          return true;
+        }
+      }
+      const uint64_t over = used + bytes - limit;
+      if (reclaimed || policy == OverflowPolicy::kRejectCharges ||
+          Reclaim(over, policy) < over) {
+        rejected_.fetch_add(1);
+        return false;
+      }
+    }
+  }
+
+  static bool Applies(OverflowPolicy policy, MemoryKind kind) {
+    switch (policy) {
+      case OverflowPolicy::kShrinkHistory:
+        return kind == MemoryKind::kHistory;
+      case OverflowPolicy::kDropOldest:
+        return kind == MemoryKind::kReaderQueue ||
+               kind == MemoryKind::kHistory || kind == MemoryKind::kPool;
+      case OverflowPolicy::kRejectCharges:
+        break;
+    }
+    return false;
+  }
+
+  uint64_t Reclaim(uint64_t want, OverflowPolicy policy) {
+    // Sizes are taken once, the accounts keep changing while we sort.
+    std::vector<std::pair<uint64_t, std::shared_ptr<Account>>> victims;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& weak : accounts_) {
+        auto account = weak.lock();
+        if (account && Applies(policy, account->kind())) {
+          victims.emplace_back(account->bytes(), std::move(account));
+        }
+      }
+    }
+    std::sort(victims.begin(), victims.end(),
+              [](const std::pair<uint64_t, std::shared_ptr<Account>>& a,
+                 const std::pair<uint64_t, std::shared_ptr<Account>>& b) {
+                return a.first > b.first;
+              });
+    uint64_t freed = 0;
+    for (const auto& victim : victims) {
+      if (freed >= want) {
+        break;
+      }
+      freed += victim.second->Reclaim(want - freed, policy);
+    }
+    reclaimed_.fetch_add(freed);
+    return freed;
+  }
+
+  void Prune() {
+    accounts_.erase(std::remove_if(accounts_.begin(), accounts_.end(),
+                                   [](const std::weak_ptr<Account>& weak) {
+                                     return weak.expired();
+                                   }),
+                    accounts_.end());
+  }
+
+  mutable std::mutex mutex_;
+  uint64_t budget_ = 0;
+  OverflowPolicy policy_ = OverflowPolicy::kDropOldest;
+  bool rejecting_ = false;
+  std::vector<std::weak_ptr<Account>> accounts_;
+  std::atomic<uint64_t> used_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> reclaimed_{0};
+};
+
+// Keep-last history of messages charged to a budget account, the shape of a
+// writer history or of a cache for late joiners. Push() refuses a message
+// the budget has no room for. Reclaiming drops the oldest messages; with
+// kShrinkHistory the depth also shrinks with them and stays there, down to
+// one message.
+template <typename T>
+class BudgetedHistory {
+ public:
+  BudgetedHistory(const std::string& node, const std::string& name,
+                  size_t depth, std::function<uint64_t(const T&)> size_of,
+                  MemoryBudget* budget = &MemoryBudget::Instance())
+      : depth_(std::max<size_t>(depth, 1)), size_of_(std::move(size_of)) {
+    account_ = budget->Register(
+        node, name, MemoryKind::kHistory,
+        [this](uint64_t want, OverflowPolicy policy) {
+          return Reclaim(want, policy);
+        });
+  }
+
+  BudgetedHistory(const BudgetedHistory&) = delete;
+  BudgetedHistory& operator=(const BudgetedHistory&) = delete;
+
+  ~BudgetedHistory() { account_->Close(); }
+
+  bool Push(T message) {
+    const uint64_t bytes = size_of_(message);
+    // Charged before taking the lock, the budget may call Reclaim().
+    if (!account_->TryCharge(bytes)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.emplace_back(std::move(message), bytes);
+    while (entries_.size() > depth_) {
+      account_->Release(entries_.front().second);
+      entries_.pop_front();
+    }
+    return true;
+  }
+
+  // Oldest first.
+  std::vector<T> Messages() const {
+    std::vector<T> messages;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+      messages.push_back(entry.first);
+    }
+    return messages;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+  size_t depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return depth_;
+  }
+  const MemoryBudget::Account& account() const { return *account_; }
+
+ private:
+  uint64_t Reclaim(uint64_t want, OverflowPolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t freed = 0;
+    while (freed < want && entries_.size() > 1) {
+      freed += entries_.front().second;
+      account_->Release(entries_.front().second);
+      entries_.pop_front();
+    }
+    if (policy == OverflowPolicy::kShrinkHistory) {
+      depth_ = std::max<size_t>(std::min(depth_, entries_.size()), 1);
+    }
+    return freed;
+  }
+
+  mutable std::mutex mutex_;
+  size_t depth_;
+  const std::function<uint64_t(const T&)> size_of_;
+  std::deque<std::pair<T, uint64_t>> entries_;
+  std::shared_ptr<MemoryBudget::Account> account_;
+};
+
+}  // namespace common
+}  // namespace example
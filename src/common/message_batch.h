@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "common/pod_codec.h"
+#include "example/msg/Batch.hpp"
+
+namespace example {
+namespace common {
+
+// Packs messages of one topic into Batch samples so that a stream of small
+// messages crosses the network as a few large datagrams. A batch is handed
+// out by Take() once it holds max_bytes or when the owner decides it is old
+// enough (age_ns). Messages of max_bytes or more are never delayed: they
+// close the pending batch and travel alone. Not thread safe; T needs a
+// PodLayout.
+template <typename T>
+class BatchBuilder {
+ public:
+  explicit BatchBuilder(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Appends msg, returns whether the batch should be taken now.
+  bool Add(const T& msg, uint64_t now_ns) {
+    if (!batch_) {
+      batch_ = std::make_shared<example::msg::Batch>();
+      batch_->first_timestamp(now_ns);
+      batch_->data().reserve(max_bytes_);
+    }
+    PodEncode(msg, &batch_->data());
+    batch_->count(batch_->count() + 1);
+    return batch_->data().size() >= max_bytes_;
+  }
+
+  // Whether msg should not share a batch with others.
+  bool IsLarge(const T& msg) const { return PodEncodedSize(msg) >= max_bytes_; }
+
+  bool Empty() const { return !batch_; }
+
+  uint64_t age_ns(uint64_t now_ns) const {
+    return batch_ ? now_ns - batch_->first_timestamp() : 0;
+  }
+
+  std::shared_ptr<example::msg::Batch> Take() { return std::move(batch_); }
+
+ private:
+  const size_t max_bytes_;
+  std::shared_ptr<example::msg::Batch> batch_;
+};
+
+// Calls fn(const std::shared_ptr<T>&) for every message of batch, returns the
+// number of messages delivered. Stops at the first malformed message.
+template <typename T, typename Fn>
+uint32_t ForEachInBatch(const example::msg::Batch& batch, Fn&& fn) {
+  const uint8_t* data = batch.data().data();
+  size_t left = batch.data().size();
+  uint32_t delivered = 0;
+  while (delivered < batch.count() && left > 0) {
+    auto msg = std::make_shared<T>();
+    const size_t used = PodDecode(data, left, msg.get());
+    if (used == 0) {
+      break;
+    }
+    data += used;
+    left -= used;
+    ++delivered;
+    fn(msg);
+  }
+  return delivered;
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,188 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+// Keep-last-N mailbox: producers never wait and never fail, a new sample
+// replaces the oldest one once N are pending. The consumer gets the pending
+// samples in order and learns how many it never saw. capacity 1 is a
+// single-slot, latest-only mailbox.
+//
+// Every slot is an atomic pointer that is only ever exchanged, so each
+// sample has exactly one owner at any time and no compare-and-swap loop is
+// needed. Push is safe from any number of threads, Pop from one thread at a
+// time.
+template <typename T>
+class OverwriteRing {
+ public:
+  explicit OverwriteRing(size_t capacity)
+      : slots_(capacity == 0 ? 1 : capacity) {}
+
+  ~OverwriteRing() {
+    for (auto& slot : slots_) {
+      delete slot.exchange(nullptr);
+    }
+  }
+
+  OverwriteRing(const OverwriteRing&) = delete;
+  OverwriteRing& operator=(const OverwriteRing&) = delete;
+
+  void Push(std::shared_ptr<T> msg) {
+    const uint64_t seq = head_.fetch_add(1);
+    delete slots_[seq % slots_.size()].exchange(new Node{seq, std::move(msg)});
+  }
+
+  // Takes the oldest pending sample. Samples overwritten since the previous
+  // Pop are added to skipped().
+  bool Pop(std::shared_ptr<T>* msg) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load();
+    if (head >= tail + slots_.size()) {
+      // Lapped: only the last capacity samples can still be there.
+      skipped_.fetch_add(head - slots_.size() - tail,
+                         std::memory_order_relaxed);
+      tail = head - slots_.size();
+    }
+    Node* node = slots_[tail % slots_.size()].exchange(nullptr);
+    if (node == nullptr || node->seq < tail) {
+      // Empty, or the producer of seq tail has not stored it yet. A stale
+      // node was skipped when the tail moved past it.
+      delete node;
+      tail_.store(tail, std::memory_order_relaxed);
+      return false;
+    }
+    // Overwritten again while we were looking.
+    skipped_.fetch_add(node->seq - tail, std::memory_order_relaxed);
+    tail_.store(node->seq + 1, std::memory_order_relaxed);
+    *msg = std::move(node->msg);
+    delete node;
+    delivered_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool Empty() const {
+    return head_.load() <= tail_.load(std::memory_order_relaxed);
+  }
+
+  // True when Pop would make progress: the slot it takes next holds a node
+  // (a sample, or a stale one Pop discards). False while the producer of
+  // that slot is between claiming it and storing, which Empty() does not
+  // tell apart. Consumer side only; the node is not dereferenced.
+  bool Ready() const {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load();
+    if (head <= tail) {
+      return false;
+    }
+    if (head >= tail + slots_.size()) {
+      tail = head - slots_.size();
+    }
+    return slots_[tail % slots_.size()].load() != nullptr;
+  }
+
+  size_t capacity() const { return slots_.size(); }
+  uint64_t pushed() const { return head_.load(std::memory_order_relaxed); }
+  uint64_t delivered() const {
+    return delivered_.load(std::memory_order_relaxed);
+  }
+  uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node {
+    uint64_t seq;
+    std::shared_ptr<T> msg;
+  };
+
+  std::vector<std::atomic<Node*>> slots_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> delivered_{0};
+  std::atomic<uint64_t> skipped_{0};
+};
+
+// Reader whose callback only sees the freshest keep_last samples. The Segar
+// reader callback just pushes into an OverwriteRing and, unless a drain is
+// already running, starts one as a Segar task, so a slow callback never
+// builds up a backlog: samples that arrive while it runs overwrite each
+// other and are counted as skipped. The callback is never run concurrently
+// with itself.
+template <typename T>
+class OverwriteReader {
+ public:
+  using Callback = std::function<void(const std::shared_ptr<T>&)>;
+
+  OverwriteReader(const std::shared_ptr<rti::segar::Node>& node,
+                  const std::string& topic, size_t keep_last,
+                  Callback callback)
+      : state_(std::make_shared<State>(keep_last, std::move(callback))) {
+    // The state is shared with the tasks so that it outlives this reader.
+    auto state = state_;
+    reader_ = node->template CreateReader<T>(
+        topic, [state](const std::shared_ptr<T>& msg) {
+          state->ring.Push(msg);
+          State::Schedule(state);
+        });
+  }
+
+  bool IsValid() const { return reader_ != nullptr; }
+
+  uint64_t received() const { return state_->ring.pushed(); }
+  uint64_t delivered() const { return state_->ring.delivered(); }
+  uint64_t skipped() const { return state_->ring.skipped(); }
+
+ private:
+  struct State {
+    State(size_t keep_last, Callback cb)
+        : ring(keep_last), callback(std::move(cb)) {}
+
+    static void Schedule(const std::shared_ptr<State>& state) {
+      if (!state->draining.exchange(true)) {
+        rti::segar::Execute([state]() { state->Drain(); });
+      }
+    }
+
+    void Drain() {
+      do {
+        std::shared_ptr<T> msg;
+        while (ring.Pop(&msg)) {
+          callback(msg);
+        }
+        draining.store(false);
+        // A Push that saw draining still set relies on this check; both
+        // sides use sequentially consistent operations so one of them
+        // notices the other. A producer that has claimed a slot but not
+        // stored it yet schedules a new drain after storing, so the drain
+        // ends here instead of spinning on that slot.
+      } while (ring.Ready() && !draining.exchange(true));
+    }
+
+    OverwriteRing<T> ring;
+    Callback callback;
+    std::atomic<bool> draining{false};
+  };
+
+  std::shared_ptr<State> state_;
+  std::shared_ptr<rti::segar::Reader<T>> reader_;
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,266 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/cpu_topology.h"
+
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+struct ParallelOptions {
+  // Tasks sharing the range, the caller included. 0: one per cpu the
+  // calling processor may run on, i.e. the cpuset of its scheduler group.
+  uint32_t workers = 0;
+  // Smallest chunk handed to the body, in indices.
+  size_t min_grain = 1;
+};
+
+namespace parallel_internal {
+
+// One parallel loop. [0, units) is split evenly over one slot per worker.
+// A worker takes chunks from the front of its own slot, an eighth of what
+// is left but at least the grain, so chunks start large and get smaller
+// towards the end. A worker whose slot is empty steals the back half of
+// another slot. Each slot is a packed [begin, end) changed by
+// compare-and-swap only, so the owner and thieves never block each other.
+class Job {
+ public:
+  using Body = std::function<void(uint32_t worker, size_t begin, size_t end)>;
+
+  Job(size_t begin, size_t end, uint32_t workers, size_t grain,
+      const Body* body)
+      : begin_(begin),
+        end_(end),
+        // Slots hold 32 bit unit indices; above that a unit spans indices.
+        unit_(((end - begin) >> 32) + 1),
+        grain_(std::max<size_t>(grain / unit_, 1)),
+        remaining_((end - begin + unit_ - 1) / unit_),
+        slots_(workers),
+        body_(body) {
+    const uint64_t units = remaining_.load(std::memory_order_relaxed);
+    for (uint32_t w = 0; w < workers; ++w) {
+      slots_[w].range.store(
+          Pack(units * w / workers, units * (w + 1) / workers),
+          std::memory_order_relaxed);
+    }
+  }
+
+  // Runs chunks as worker self until none are left to take or steal.
+  void Run(uint32_t self) {
+    uint64_t first;
+    uint64_t last;
+    while (Next(self, &first, &last)) {
+      (*body_)(self, begin_ + first * unit_,
+               std::min(end_, begin_ + last * unit_));
+      remaining_.fetch_sub(last - first, std::memory_order_acq_rel);
+    }
+  }
+
+  // Chunks taken by other workers may still be running.
+  bool Finished() const {
+    return remaining_.load(std::memory_order_acquire) == 0;
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> range{0};
+  };
+
+  static uint64_t Pack(uint64_t first, uint64_t last) {
+    return first | (last << 32);
+  }
+  static uint64_t First(uint64_t range) { return range & 0xffffffffULL; }
+  static uint64_t Last(uint64_t range) { return range >> 32; }
+
+  bool Next(uint32_t self, uint64_t* first, uint64_t* last) {
+    return TakeFront(self, first, last) || Steal(self, first, last);
+  }
+
+  bool TakeFront(uint32_t self, uint64_t* first, uint64_t* last) {
+    auto& range = slots_[self].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    for (;;) {
+      const uint64_t f = First(current);
+      const uint64_t l = Last(current);
+      if (f >= l) {
+        return false;
+      }
+      const uint64_t take = std::min<uint64_t>(
+          l - f, std::max<uint64_t>((l - f) / 8, grain_));
+      if (range.compare_exchange_weak(current, Pack(f + take, l),
+                                      std::memory_order_acq_rel)) {
+        *first = f;
+        *last = f + take;
+        return true;
+      }
+    }
+  }
+
+  // Called with an empty own slot: moves the back half of the next slot
+  // that has work into it and takes the first chunk of that.
+  bool Steal(uint32_t self, uint64_t* first, uint64_t* last) {
+    const uint32_t workers = static_cast<uint32_t>(slots_.size());
+    for (uint32_t i = 1; i < workers; ++i) {
+      auto& range = slots_[(self + i) % workers].range;
+      uint64_t current = range.load(std::memory_order_acquire);
+      for (;;) {
+        const uint64_t f = First(current);
+        const uint64_t l = Last(current);
+        if (f >= l) {
+          break;
+        }
+        // A chunk of at most the grain goes as a whole.
+        const uint64_t mid = l - f <= grain_ ? f : f + (l - f) / 2;
+        if (range.compare_exchange_weak(current, Pack(f, mid),
+                                        std::memory_order_acq_rel)) {
+          // Nobody steals from an empty slot, so a plain store is enough.
+          slots_[self].range.store(Pack(mid, l), std::memory_order_release);
+          return TakeFront(self, first, last);
+        }
+      }
+    }
+    return false;
+  }
+
+  const size_t begin_;
+  const size_t end_;
+  const size_t unit_;
+  const uint64_t grain_;
+  std::atomic<uint64_t> remaining_;
+  std::vector<Slot> slots_;
+  const Body* body_;
+};
+
+inline uint32_t DefaultWorkers() {
+  const size_t cpus = CurrentCpus().size();
+  return cpus == 0 ? 1 : static_cast<uint32_t>(cpus);
+}
+
+// Runs body(worker, begin, end) over [begin, end) with up to
+// options.workers workers, worker 0 being the caller, and returns once
+// every index is done. Returns the number of workers used.
+inline uint32_t Run(size_t begin, size_t end, const ParallelOptions& options,
+                    const Job::Body& body) {
+  if (end <= begin) {
+    return 0;
+  }
+  const size_t grain = std::max<size_t>(options.min_grain, 1);
+  const size_t chunks = (end - begin + grain - 1) / grain;
+  const uint32_t workers = static_cast<uint32_t>(std::min<size_t>(
+      options.workers == 0 ? DefaultWorkers() : options.workers, chunks));
+  if (workers <= 1) {
+    body(0, begin, end);
+    return 1;
+  }
+  // Helpers hold the job, not the body: one that starts after the loop is
+  // over finds nothing left to take and never touches the body.
+  auto job = std::make_shared<Job>(begin, end, workers, grain, &body);
+  for (uint32_t w = 1; w < workers; ++w) {
+    rti::segar::Execute([job, w]() { job->Run(w); });
+  }
+  job->Run(0);
+  // The caller never waits for a helper to start, only for chunks that
+  // helpers already run; their slots were stolen otherwise.
+  while (!job->Finished()) {
+    rti::segar::Yield();
+  }
+  return workers;
+}
+
+}  // namespace parallel_internal
+
+// Data-parallel loops on the Segar task pool. The calling task takes part
+// and the helpers are ordinary Segar tasks, so the loops run on the
+// processors of the caller's scheduler and never block a processor: a call
+// from a busy pool degrades to the caller doing most of the work. Call them
+// from a Segar task, a reader callback or a component's Proc. The body must
+// be safe to run concurrently for disjoint ranges.
+
+// Calls body(first, last) for disjoint subranges covering [begin, end).
+template <typename Body>
+void ParallelForRange(size_t begin, size_t end, Body&& body,
+                      const ParallelOptions& options = ParallelOptions()) {
+  parallel_internal::Run(begin, end, options,
+                         [&body](uint32_t, size_t first, size_t last) {
+                           body(first, last);
+                         });
+}
+
+// Calls body(i) for every i in [begin, end).
+template <typename Body>
+void ParallelFor(size_t begin, size_t end, Body&& body,
+                 const ParallelOptions& options = ParallelOptions()) {
+  ParallelForRange(
+      begin, end,
+      [&body](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          body(i);
+        }
+      },
+      options);
+}
+
+// Folds [begin, end): every worker folds its chunks with
+// acc = map(first, last, acc), starting from identity, and the per-worker
+// results are combined in worker order. combine must be associative; chunk
+// boundaries differ between runs, so floating point sums may differ in the
+// last bits.
+template <typename T, typename Map, typename Combine>
+T ParallelReduce(size_t begin, size_t end, T identity, Map&& map,
+                 Combine&& combine,
+                 const ParallelOptions& options = ParallelOptions()) {
+  struct alignas(64) Partial {
+    T value;
+  };
+  const uint32_t max_workers = options.workers == 0
+                                   ? parallel_internal::DefaultWorkers()
+                                   : options.workers;
+  std::vector<Partial> partials(max_workers, Partial{identity});
+  const uint32_t used = parallel_internal::Run(
+      begin, end, options,
+      [&map, &partials](uint32_t worker, size_t first, size_t last) {
+        partials[worker].value =
+            map(first, last, std::move(partials[worker].value));
+      });
+  T result = std::move(identity);
+  for (uint32_t w = 0; w < used; ++w) {
+    result = combine(std::move(result), std::move(partials[w].value));
+  }
+  return result;
+}
+
+// out[i] = fn(in[i]) for the random access range [first, last). Returns
+// the end of the output range.
+template <typename InputIt, typename OutputIt, typename Fn>
+OutputIt ParallelTransform(InputIt first, InputIt last, OutputIt out, Fn&& fn,
+                           const ParallelOptions& options = ParallelOptions()) {
+  const size_t count = static_cast<size_t>(std::distance(first, last));
+  ParallelForRange(
+      0, count,
+      [&](size_t begin, size_t end) {
+        std::transform(first + begin, first + end, out + begin, fn);
+      },
+      options);
+  return out + count;
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,340 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace example {
+namespace common {
+
+// Layout of a message type in the POD wire format, specialized per type
+// (see common/example_pod_layouts.h):
+//
+//   struct Fixed { ... };                 // fixed-size fields, no padding
+//   static void Pack(const T&, Fixed*);
+//   static void Unpack(const Fixed&, T*);
+//   template <typename M>                 // M is T or const T
+//   static auto Tail(M& msg);             // std::forward_as_tuple of the
+//                                         // variable-size fields
+//
+// Wire format: Fixed copied as is, then every Tail field in order. Strings
+// and arrays of arithmetic types are a uint32 element count followed by the
+// raw elements; nested messages use their own layout. Byte order is the
+// host's, which is little endian on every supported platform.
+template <typename T>
+struct PodLayout;
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "the POD wire format is little endian");
+
+template <typename T, typename = void>
+struct HasPodLayout : std::false_type {};
+template <typename T>
+struct HasPodLayout<T, std::void_t<typename PodLayout<T>::Fixed>>
+    : std::true_type {};
+
+template <typename T>
+using PodTail = decltype(PodLayout<T>::Tail(std::declval<const T&>()));
+
+// True when every field of T is in Fixed: encoding is one memcpy of
+// PodFixedSize<T> bytes.
+template <typename T>
+constexpr bool kPodFixedSize = std::tuple_size<PodTail<T>>::value == 0;
+
+template <typename T>
+constexpr size_t PodFixedSize() {
+  using Fixed = typename PodLayout<T>::Fixed;
+  return std::is_empty<Fixed>::value ? 0 : sizeof(Fixed);
+}
+
+namespace pod_internal {
+
+template <typename T>
+constexpr bool CheckFixed() {
+  using Fixed = typename PodLayout<T>::Fixed;
+  static_assert(std::is_trivially_copyable<Fixed>::value,
+                "Fixed must be trivially copyable");
+  static_assert(std::is_empty<Fixed>::value ||
+                    std::has_unique_object_representations<Fixed>::value,
+                "Fixed must not contain padding, order fields by size or "
+                "add explicit reserved fields");
+  return true;
+}
+
+template <typename E>
+constexpr bool IsBulk() {
+  return std::is_arithmetic<E>::value && !std::is_same<E, bool>::value;
+}
+
+// Fewest bytes a field of type F takes on the wire, to check an element
+// count against the rest of the buffer.
+template <typename F>
+constexpr size_t MinFieldSize();
+
+template <typename... F>
+constexpr size_t MinTailSize(const std::tuple<F...>* /*tail*/) {
+  return (size_t{0} + ... + MinFieldSize<std::decay_t<F>>());
+}
+
+template <typename F>
+constexpr size_t MinFieldSize() {
+  if constexpr (HasPodLayout<F>::value) {
+    return PodFixedSize<F>() +
+           MinTailSize(static_cast<const PodTail<F>*>(nullptr));
+  } else {
+    // Strings and arrays: the count.
+    return sizeof(uint32_t);
+  }
+}
+
+class Writer {
+ public:
+  Writer(uint8_t* data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+  bool Put(const void* src, size_t n) {
+    if (!ok_ || n > capacity_ - size_) {
+      ok_ = false;
+      return false;
+    }
+    if (n != 0) {
+      std::memcpy(data_ + size_, src, n);
+    }
+    size_ += n;
+    return true;
+  }
+  bool PutCount(size_t count) {
+    if (count > UINT32_MAX) {
+      ok_ = false;
+      return false;
+    }
+    const auto value = static_cast<uint32_t>(count);
+    return Put(&value, sizeof(value));
+  }
+
+  bool ok() const { return ok_; }
+  size_t size() const { return size_; }
+
+ private:
+  uint8_t* data_;
+  size_t capacity_;
+  size_t size_ = 0;
+  bool ok_ = true;
+};
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  // Returns a pointer to the next n bytes, nullptr if the buffer is short.
+  const uint8_t* Take(size_t n) {
+    if (!ok_ || n > size_ - offset_) {
+      ok_ = false;
+      return nullptr;
+    }
+    const uint8_t* p = data_ + offset_;
+    offset_ += n;
+    return p;
+  }
+  bool Get(void* dst, size_t n) {
+    const uint8_t* p = Take(n);
+    if (p != nullptr && n != 0) {
+      std::memcpy(dst, p, n);
+    }
+    return p != nullptr;
+  }
+  bool GetCount(size_t elem_size, uint32_t* count) {
+    // Rejects counts that cannot fit in the rest of the buffer before
+    // anything is allocated for them.
+    return Get(count, sizeof(*count)) &&
+           (elem_size == 0 || *count <= (size_ - offset_) / elem_size);
+  }
+
+  bool ok() const { return ok_; }
+  size_t offset() const { return offset_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool ok_ = true;
+};
+
+template <typename T>
+size_t EncodedSize(const T& msg);
+template <typename T>
+bool Encode(const T& msg, Writer* writer);
+template <typename T>
+bool Decode(Reader* reader, T* msg);
+
+inline size_t FieldSize(const std::string& value) {
+  return sizeof(uint32_t) + value.size();
+}
+inline bool PutField(const std::string& value, Writer* writer) {
+  return writer->PutCount(value.size()) &&
+         writer->Put(value.data(), value.size());
+}
+inline bool GetField(Reader* reader, std::string* value) {
+  uint32_t count = 0;
+  if (!reader->GetCount(1, &count)) {
+    return false;
+  }
+  const uint8_t* p = reader->Take(count);
+  if (p == nullptr) {
+    return false;
+  }
+  value->assign(reinterpret_cast<const char*>(p), count);
+  return true;
+}
+
+template <typename E>
+size_t FieldSize(const std::vector<E>& value) {
+  if constexpr (IsBulk<E>()) {
+    return sizeof(uint32_t) + value.size() * sizeof(E);
+  } else {
+    size_t size = sizeof(uint32_t);
+    for (const auto& item : value) {
+      size += EncodedSize(item);
+    }
+    return size;
+  }
+}
+template <typename E>
+bool PutField(const std::vector<E>& value, Writer* writer) {
+  if (!writer->PutCount(value.size())) {
+    return false;
+  }
+  if constexpr (IsBulk<E>()) {
+    // One memcpy for the whole array, which libc vectorizes.
+    return writer->Put(value.data(), value.size() * sizeof(E));
+  } else {
+    for (const auto& item : value) {
+      if (!Encode(item, writer)) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+template <typename E>
+bool GetField(Reader* reader, std::vector<E>* value) {
+  uint32_t count = 0;
+  if constexpr (IsBulk<E>()) {
+    if (!reader->GetCount(sizeof(E), &count)) {
+      return false;
+    }
+    value->resize(count);
+    return reader->Get(value->data(), count * sizeof(E));
+  } else {
+    if (!reader->GetCount(MinFieldSize<E>(), &count)) {
+      return false;
+    }
+    value->resize(count);
+    for (auto& item : *value) {
+      if (!Decode(reader, &item)) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+template <typename M, typename = std::enable_if_t<HasPodLayout<M>::value>>
+size_t FieldSize(const M& value) {
+  return EncodedSize(value);
+}
+template <typename M, typename = std::enable_if_t<HasPodLayout<M>::value>>
+bool PutField(const M& value, Writer* writer) {
+  return Encode(value, writer);
+}
+template <typename M, typename = std::enable_if_t<HasPodLayout<M>::value>>
+bool GetField(Reader* reader, M* value) {
+  return Decode(reader, value);
+}
+
+template <typename T>
+size_t EncodedSize(const T& msg) {
+  size_t size = PodFixedSize<T>();
+  std::apply(
+      [&size](const auto&... field) { ((size += FieldSize(field)), ...); },
+      PodLayout<T>::Tail(msg));
+  return size;
+}
+
+template <typename T>
+bool Encode(const T& msg, Writer* writer) {
+  static_assert(CheckFixed<T>(), "");
+  typename PodLayout<T>::Fixed fixed;
+  PodLayout<T>::Pack(msg, &fixed);
+  if (!writer->Put(&fixed, PodFixedSize<T>())) {
+    return false;
+  }
+  return std::apply(
+      [writer](const auto&... field) {
+        return (PutField(field, writer) && ...);
+      },
+      PodLayout<T>::Tail(msg));
+}
+
+template <typename T>
+bool Decode(Reader* reader, T* msg) {
+  static_assert(CheckFixed<T>(), "");
+  typename PodLayout<T>::Fixed fixed;
+  if (!reader->Get(&fixed, PodFixedSize<T>())) {
+    return false;
+  }
+  PodLayout<T>::Unpack(fixed, msg);
+  return std::apply(
+      [reader](auto&... field) { return (GetField(reader, &field) && ...); },
+      PodLayout<T>::Tail(*msg));
+}
+
+}  // namespace pod_internal
+
+template <typename T>
+size_t PodEncodedSize(const T& msg) {
+  if constexpr (kPodFixedSize<T>) {
+    return PodFixedSize<T>();
+  } else {
+    return pod_internal::EncodedSize(msg);
+  }
+}
+
+// Writes msg to out, returns the number of bytes written or 0 if capacity
+// is too small.
+template <typename T>
+size_t PodEncode(const T& msg, uint8_t* out, size_t capacity) {
+  pod_internal::Writer writer(out, capacity);
+  return pod_internal::Encode(msg, &writer) ? writer.size() : 0;
+}
+
+// Appends msg to buffer.
+template <typename T>
+void PodEncode(const T& msg, std::vector<uint8_t>* buffer) {
+  const size_t offset = buffer->size();
+  buffer->resize(offset + PodEncodedSize(msg));
+  PodEncode(msg, buffer->data() + offset, buffer->size() - offset);
+}
+
+// Reads msg from data, returns the number of bytes consumed or 0 if the
+// data is truncated or malformed.
+template <typename T>
+size_t PodDecode(const uint8_t* data, size_t size, T* msg) {
+  pod_internal::Reader reader(data, size);
+  return pod_internal::Decode(&reader, msg) ? reader.offset() : 0;
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "common/co_sync.h"
+#include "common/proc_stats.h"
+
+namespace example {
+namespace common {
+
+// Admits at most `workers` callers at a time, the waiting ones in order of
+// priority (higher first, FIFO within a priority). Service callbacks and
+// action on_execute handlers enter it with the priority the caller put in
+// its request, so a high priority request overtakes queued bulk work
+// instead of waiting behind it. A freed slot is handed directly to the
+// next waiter, which is woken through the suspending Waiter of co_sync.h.
+//
+// Ordering is strict: under a sustained overload of high priority requests
+// lower ones wait indefinitely. Size `workers` to the processors that serve
+// the callbacks; with more workers than processors the extra callbacks are
+// admitted and the ordering is back to the runtime's.
+class PriorityGate {
+ public:
+  // Held while the caller is admitted; leaving the scope frees the slot.
+  class Ticket {
+   public:
+    Ticket(Ticket&& other) noexcept
+        : gate_(std::exchange(other.gate_, nullptr)),
+          priority_(other.priority_),
+          queued_ns_(other.queued_ns_) {}
+    Ticket(const Ticket&) = delete;
+    Ticket& operator=(const Ticket&) = delete;
+    Ticket& operator=(Ticket&&) = delete;
+
+    ~Ticket() {
+      if (gate_ != nullptr) {
+        gate_->Leave();
+      }
+    }
+
+    // Priority to forward when the holder calls further services, so the
+    // whole call chain runs at the priority of the original caller.
+    uint8_t priority() const { return priority_; }
+    // Time spent waiting for admission.
+    uint64_t queued_ns() const { return queued_ns_; }
+
+   private:
+    friend class PriorityGate;
+    Ticket(PriorityGate* gate, uint8_t priority, uint64_t queued_ns)
+        : gate_(gate), priority_(priority), queued_ns_(queued_ns) {}
+
+    PriorityGate* gate_;
+    uint8_t priority_;
+    uint64_t queued_ns_;
+  };
+
+  explicit PriorityGate(uint32_t workers) : workers_(workers ? workers : 1) {}
+
+  PriorityGate(const PriorityGate&) = delete;
+  PriorityGate& operator=(const PriorityGate&) = delete;
+
+  Ticket Enter(uint8_t priority) {
+    const uint64_t start = MonotonicNs();
+    std::shared_ptr<co_sync_internal::Waiter> waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (running_ < workers_) {
+        ++running_;
+        return Ticket(this, priority, 0);
+      }
+      waiter = std::make_shared<co_sync_internal::Waiter>();
+      queues_[priority].push_back(waiter);
+      ++waiting_[priority];
+    }
+    queued_.fetch_add(1, std::memory_order_relaxed);
+    waiter->Wait();
+    return Ticket(this, priority, MonotonicNs() - start);
+  }
+
+  uint32_t workers() const { return workers_; }
+  // Enter() calls that had to wait.
+  uint64_t queued() const { return queued_.load(std::memory_order_relaxed); }
+  // Callers waiting per priority right now.
+  uint32_t waiting(uint8_t priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiting_[priority];
+  }
+
+ private:
+  void Leave() {
+    std::shared_ptr<co_sync_internal::Waiter> next;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queues_.empty()) {
+        --running_;
+        return;
+      }
+      // The slot passes to the waiter as is, running_ does not change.
+      auto highest = queues_.begin();
+      next = std::move(highest->second.front());
+      highest->second.pop_front();
+      --waiting_[highest->first];
+      if (highest->second.empty()) {
+        queues_.erase(highest);
+      }
+    }
+    next->Wake();
+  }
+
+  const uint32_t workers_;
+  mutable std::mutex mutex_;
+  uint32_t running_ = 0;
+  std::map<uint8_t, co_sync_internal::WaiterQueue, std::greater<uint8_t>>
+      queues_;
+  std::array<uint32_t, 256> waiting_{};
+  std::atomic<uint64_t> queued_{0};
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace example {
+namespace common {
+
+// CLOCK_MONOTONIC is shared by all processes on a host, so timestamps taken
+// by a writer can be compared with the reader's clock without translation.
+inline uint64_t MonotonicNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Snapshot of the memory and CPU usage of the current process.
+struct ProcessStats {
+  uint64_t rss_kb = 0;        // VmRSS
+  uint64_t rss_anon_kb = 0;   // RssAnon: heap, stacks, private mappings
+  uint64_t rss_shmem_kb = 0;  // RssShmem: mapped SHM segments
+  uint64_t hwm_kb = 0;        // VmHWM: peak RSS
+  double cpu_user_s = 0.0;
+  double cpu_sys_s = 0.0;
+
+  double CpuSeconds() const { return cpu_user_s + cpu_sys_s; }
+};
+
+inline ProcessStats ReadProcessStats() {
+  ProcessStats stats;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    std::istringstream iss(line);
+    std::string key;
+    uint64_t value = 0;
+    if (!(iss >> key >> value)) {
+      continue;
+    }
+    if (key == "VmRSS:") {
+      stats.rss_kb = value;
+    } else if (key == "RssAnon:") {
+      stats.rss_anon_kb = value;
+    } else if (key == "RssShmem:") {
+      stats.rss_shmem_kb = value;
+    } else if (key == "VmHWM:") {
+      stats.hwm_kb = value;
+    }
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    stats.cpu_user_s = static_cast<double>(usage.ru_utime.tv_sec) +
+                       static_cast<double>(usage.ru_utime.tv_usec) / 1e6;
+    stats.cpu_sys_s = static_cast<double>(usage.ru_stime.tv_sec) +
+                      static_cast<double>(usage.ru_stime.tv_usec) / 1e6;
+  }
+  return stats;
+}
+
+// Resident kB of every SHM segment the process maps, by segment name:
+// POSIX segments under /dev/shm, SysV segments and memfds, from
+// /proc/self/smaps. Together they make up most of RssShmem.
+inline std::map<std::string, uint64_t> ReadShmSegments() {
+  std::map<std::string, uint64_t> segments;
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  std::string segment;
+  while (std::getline(smaps, line)) {
+    std::istringstream iss(line);
+    std::string first;
+    iss >> first;
+    if (first.empty()) {
+      continue;
+    }
+    if (first.back() != ':') {
+      // Mapping header: address perms offset dev inode [path].
+      std::string field;
+      for (int i = 0; i < 4; ++i) {
+        iss >> field;
+      }
+      std::string path;
+      std::getline(iss >> std::ws, path);
+      const size_t deleted = path.find(" (deleted)");
+      if (deleted != std::string::npos) {
+        path.erase(deleted);
+      }
+      if (path.compare(0, 9, "/dev/shm/") == 0) {
+        segment = path.substr(9);
+      } else if (path.compare(0, 5, "/SYSV") == 0 ||
+                 path.compare(0, 7, "/memfd:") == 0) {
+        segment = path.substr(1);
+      } else {
+        segment.clear();
+      }
+      continue;
+    }
+    uint64_t kb = 0;
+    if (!segment.empty() && first == "Rss:" && (iss >> kb)) {
+      segments[segment] += kb;
+    }
+  }
+  return segments;
+}
+
+inline std::string ToString(const ProcessStats& stats) {
+  std::ostringstream oss;
+  oss << "rss=" << stats.rss_kb << "KB anon=" << stats.rss_anon_kb
+      << "KB shmem=" << stats.rss_shmem_kb << "KB peak=" << stats.hwm_kb
+      << "KB cpu=" << stats.CpuSeconds() << "s";
+  return oss.str();
+}
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+// Decides which samples of a stream a consumer wants: at most max_hz per
+// second, every keep_every_n-th sample and samples matching a predicate over
+// the message fields. Options left at their defaults pass everything.
+template <typename T>
+class SampleFilter {
+ public:
+  struct Options {
+    double max_hz = 0.0;        // 0: no rate limit
+    uint32_t keep_every_n = 1;  // 1: keep all
+    std::function<bool(const T&)> predicate;
+  };
+
+  SampleFilter() = default;
+  explicit SampleFilter(Options options) : options_(std::move(options)) {
+    if (options_.max_hz > 0.0) {
+      period_ns_ = static_cast<uint64_t>(1e9 / options_.max_hz);
+    }
+  }
+
+  // Not thread safe, call from one publishing thread.
+  bool Accept(const T& msg, uint64_t now_ns) {
+    ++seen_;
+    if (options_.keep_every_n > 1 && (seen_ - 1) % options_.keep_every_n) {
+      return false;
+    }
+    if (options_.predicate && !options_.predicate(msg)) {
+      return false;
+    }
+    if (period_ns_ != 0) {
+      // Next slot counted from the previous one so the average rate stays at
+      // max_hz, without bursts after a pause of the source.
+      if (now_ns < next_ns_) {
+        return false;
+      }
+      next_ns_ = next_ns_ + period_ns_ > now_ns ? next_ns_ + period_ns_
+                                                : now_ns + period_ns_;
+    }
+    ++accepted_;
+    return true;
+  }
+
+  uint64_t seen() const { return seen_; }
+  uint64_t accepted() const { return accepted_; }
+
+ private:
+  Options options_;
+  uint64_t period_ns_ = 0;
+  uint64_t next_ns_ = 0;
+  uint64_t seen_ = 0;
+  uint64_t accepted_ = 0;
+};
+
+// Writer that publishes every message on its own topic and, for each added
+// view, a filtered subset on a derived topic. Filtering happens before
+// Write(), so readers of a view topic are never copied to or woken up for
+// samples they would drop: subscribe to "<topic>/10hz" instead of filtering
+// "<topic>" in the callback.
+template <typename T>
+class FilteredWriter {
+ public:
+  using Writer = rti::segar::Writer<T>;
+
+  FilteredWriter(std::shared_ptr<rti::segar::Node> node, std::string topic)
+      : node_(std::move(node)), topic_(std::move(topic)) {
+    writer_ = node_->template CreateWriter<T>(topic_);
+  }
+
+  // Adds a view published on topic() + suffix, e.g. "/10hz".
+  bool AddView(const std::string& suffix,
+               typename SampleFilter<T>::Options options) {
+    auto writer = node_->template CreateWriter<T>(topic_ + suffix);
+    if (!writer) {
+      AERROR << "FilteredWriter: cannot create writer for " << topic_
+             << suffix;
+      return false;
+    }
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    views_.push_back({topic_ + suffix, SampleFilter<T>(std::move(options)),
+                      std::move(writer)});
+    return true;
+  }
+
+  bool Write(const std::shared_ptr<T>& msg) {
+    bool ok = writer_ && writer_->Write(msg);
+    const uint64_t now = MonotonicNs();
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    for (auto& view : views_) {
+      if (view.filter.Accept(*msg, now)) {
+        ok = view.writer->Write(msg) && ok;
+      }
+    }
+    return ok;
+  }
+
+  bool IsValid() const { return writer_ != nullptr; }
+  const std::string& topic() const { return topic_; }
+
+  // "<view topic> accepted/seen" for each view.
+  std::string ViewStats() const {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    std::string out;
+    for (const auto& view : views_) {
+      out += (out.empty() ? "" : " ") + view.topic + " " +
+             std::to_string(view.filter.accepted()) + "/" +
+             std::to_string(view.filter.seen());
+    }
+    return out;
+  }
+
+ private:
+  struct View {
+    std::string topic;
+    SampleFilter<T> filter;
+    std::shared_ptr<Writer> writer;
+  };
+
+  std::shared_ptr<rti::segar::Node> node_;
+  std::string topic_;
+  std::shared_ptr<Writer> writer_;
+  mutable std::mutex mutex_;
+  std::vector<View> views_;
+};
+
+}  // namespace common
+}  // namespace example
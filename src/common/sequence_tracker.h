@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/latency_histogram.h"
+
+namespace example {
+namespace common {
+
+// Loss, duplicate, reorder and latency accounting of the messages a reader
+// receives, per writer. Writers stamp a per-writer sequence number and an
+// id into their messages (e.g. `topic_id` and `sequence_number` of
+// Payload); the reader callback passes both to Record().
+//
+// The last kWindow sequence numbers below the highest one seen are kept in
+// a bitmap, so a message that arrives late within the window is told apart
+// from a duplicate and taken back from the lost count. Messages older than
+// the window count as reordered.
+//
+// A restart of the writer is told by its incarnation, a number that grows
+// with every start such as the start time, if the writer stamps one into
+// its messages. Without it, sequence 1 seen again or a sequence number
+// that jumps back below kWindow from beyond it is taken as a restart. On a
+// restart the counts go on and the sequence is followed from there.
+//
+// Recording is O(1) and allocation free once the writer is known. Like
+// LatencyHistogram the class is not thread safe: readers whose callbacks
+// may run concurrently guard it.
+class SequenceTracker {
+ public:
+  static constexpr uint32_t kWindow = 64;
+
+  enum class Result {
+    kInOrder,    // the next expected message
+    kGap,        // messages before it are missing
+    kLate,       // fills an earlier gap
+    kDuplicate,  // seen before
+    kRestart,    // the writer started over
+  };
+
+  struct WriterStats {
+    uint64_t writer_id = 0;
+    uint64_t received = 0;
+    uint64_t lost = 0;
+    uint64_t duplicates = 0;
+    uint64_t reordered = 0;
+    uint64_t restarts = 0;
+    uint64_t highest = 0;
+    LatencyHistogram latency;
+  };
+
+  // `latency_ns` is recorded for every message but duplicates. Writers
+  // that stamp no incarnation pass 0.
+  Result Record(uint64_t writer_id, uint64_t seq, uint64_t latency_ns,
+                uint64_t incarnation = 0) {
+    Writer& writer = Find(writer_id);
+    WriterStats& stats = writer.stats;
+    if (stats.received == 0) {
+      writer.incarnation = incarnation;
+      Accept(&writer, seq, latency_ns);
+      return Result::kInOrder;
+    }
+    if (incarnation != writer.incarnation) {
+      if (incarnation < writer.incarnation) {
+        // Left over from the run before the restart.
+        ++stats.reordered;
+        Count(&stats, latency_ns);
+        return Result::kLate;
+      }
+      return Restart(&writer, seq, latency_ns, incarnation);
+    }
+    if (seq > stats.highest) {
+      const uint64_t distance = seq - stats.highest;
+      stats.lost += distance - 1;
+      writer.window =
+          distance >= kWindow ? 1 : (writer.window << distance) | 1;
+      stats.highest = seq;
+      Count(&stats, latency_ns);
+      return distance == 1 ? Result::kInOrder : Result::kGap;
+    }
+    const uint64_t distance = stats.highest - seq;
+    if (distance >= kWindow) {
+      if (seq < kWindow) {
+        return Restart(&writer, seq, latency_ns, incarnation);
+      }
+      ++stats.reordered;
+      stats.lost -= stats.lost > 0 ? 1 : 0;
+      Count(&stats, latency_ns);
+      return Result::kLate;
+    }
+    const uint64_t bit = uint64_t{1} << distance;
+    if ((writer.window & bit) != 0) {
+      // Sequences start at 1, a second first message is a new run.
+      if (seq == 1 && distance > 0) {
+        return Restart(&writer, seq, latency_ns, incarnation);
+      }
+      ++stats.duplicates;
+      return Result::kDuplicate;
+    }
+    writer.window |= bit;
+    ++stats.reordered;
+    // Not counted when it predates the first message.
+    stats.lost -= stats.lost > 0 ? 1 : 0;
+    Count(&stats, latency_ns);
+    return Result::kLate;
+  }
+
+  std::vector<WriterStats> Snapshot() const {
+    std::vector<WriterStats> stats;
+    for (const auto& writer : writers_) {
+      stats.push_back(writer->stats);
+    }
+    return stats;
+  }
+
+  // Sum over all writers; the latency histograms are merged.
+  WriterStats Total() const {
+    WriterStats total;
+    for (const auto& writer : writers_) {
+      const WriterStats& stats = writer->stats;
+      total.received += stats.received;
+      total.lost += stats.lost;
+      total.duplicates += stats.duplicates;
+      total.reordered += stats.reordered;
+      total.restarts += stats.restarts;
+      total.latency.Merge(stats.latency);
+    }
+    return total;
+  }
+
+  size_t writers() const { return writers_.size(); }
+
+  // One line per writer.
+  std::string Summary(double unit = 1000.0) const {
+    std::ostringstream oss;
+    for (const auto& writer : writers_) {
+      const WriterStats& stats = writer->stats;
+      oss << "writer=" << stats.writer_id << " received=" << stats.received
+          << " lost=" << stats.lost << " duplicates=" << stats.duplicates
+          << " reordered=" << stats.reordered
+          << " restarts=" << stats.restarts << " latency{"
+          << stats.latency.Summary(unit) << "}\n";
+    }
+    return oss.str();
+  }
+
+  void Reset() { writers_.clear(); }
+
+ private:
+  struct Writer {
+    WriterStats stats;
+    // Bit i: highest - i was received.
+    uint64_t window = 0;
+    uint64_t incarnation = 0;
+  };
+
+  Writer& Find(uint64_t writer_id) {
+    // Most readers have a single writer, or get runs from the same one.
+    if (last_ < writers_.size() &&
+        writers_[last_]->stats.writer_id == writer_id) {
+      return *writers_[last_];
+    }
+    for (size_t i = 0; i < writers_.size(); ++i) {
+      if (writers_[i]->stats.writer_id == writer_id) {
+        last_ = i;
+        return *writers_[i];
+      }
+    }
+    writers_.push_back(std::make_unique<Writer>());
+    writers_.back()->stats.writer_id = writer_id;
+    last_ = writers_.size() - 1;
+    return *writers_.back();
+  }
+
+  static Result Restart(Writer* writer, uint64_t seq, uint64_t latency_ns,
+                        uint64_t incarnation) {
+    ++writer->stats.restarts;
+    writer->incarnation = incarnation;
+    Accept(writer, seq, latency_ns);
+    return Result::kRestart;
+  }
+
+  static void Accept(Writer* writer, uint64_t seq, uint64_t latency_ns) {
+    writer->stats.highest = seq;
+    writer->window = 1;
+    Count(&writer->stats, latency_ns);
+  }
+
+  static void Count(WriterStats* stats, uint64_t latency_ns) {
+    ++stats->received;
+    stats->latency.Record(latency_ns);
+  }
+
+  std::vector<std::unique_ptr<Writer>> writers_;
+  size_t last_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace example {
+namespace common {
+
+// Counts message sizes in power-of-two size classes, the same bucketing a
+// slab allocator would use. Class i holds sizes in (2^(i-1), 2^i]; class 0
+// also takes empty messages and the last class takes everything larger.
+class SizeClassHistogram {
+ public:
+  static constexpr size_t kNumClasses = 32;
+
+  static size_t ClassOf(uint64_t size) {
+    size_t cls = 0;
+    while (cls + 1 < kNumClasses && (uint64_t{1} << cls) < size) {
+      ++cls;
+    }
+    return cls;
+  }
+
+  static uint64_t ClassSize(size_t cls) { return uint64_t{1} << cls; }
+
+  void Add(uint64_t size) {
+    ++counts_[ClassOf(size)];
+    ++total_;
+    if (size > max_) {
+      max_ = size;
+    }
+  }
+
+  void Reset() { *this = SizeClassHistogram(); }
+
+  uint64_t total() const { return total_; }
+  uint64_t max() const { return max_; }
+  uint64_t count(size_t cls) const { return counts_[cls]; }
+
+  // Upper bound of the size class containing the given percentile.
+  uint64_t Percentile(double pct) const {
+    if (total_ == 0) {
+      return 0;
+    }
+    const auto target = static_cast<uint64_t>(pct / 100.0 * total_ + 0.5);
+    uint64_t seen = 0;
+    for (size_t cls = 0; cls < kNumClasses; ++cls) {
+      seen += counts_[cls];
+      if (seen >= target && counts_[cls] > 0) {
+        return ClassSize(cls);
+      }
+    }
+    return ClassSize(kNumClasses - 1);
+  }
+
+  // Non-empty classes as "4K:120 8K:37 ...".
+  std::string ToString() const {
+    std::ostringstream oss;
+    for (size_t cls = 0; cls < kNumClasses; ++cls) {
+      if (counts_[cls] == 0) {
+        continue;
+      }
+      if (oss.tellp() > 0) {
+        oss << ' ';
+      }
+      oss << HumanSize(ClassSize(cls)) << ':' << counts_[cls];
+    }
+    return oss.str();
+  }
+
+  static std::string HumanSize(uint64_t size) {
+    std::ostringstream oss;
+    if (size >= (uint64_t{1} << 20) && size % (uint64_t{1} << 20) == 0) {
+      oss << (size >> 20) << 'M';
+    } else if (size >= (uint64_t{1} << 10) && size % (uint64_t{1} << 10) == 0) {
+      oss << (size >> 10) << 'K';
+    } else {
+      oss << size << 'B';
+    }
+    return oss.str();
+  }
+
+ private:
+  std::array<uint64_t, kNumClasses> counts_{};
+  uint64_t total_ = 0;
+  uint64_t max_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
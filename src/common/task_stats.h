@@ -0,0 +1,459 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+namespace example {
+namespace common {
+
+// Totals of one named routine since the process started.
+struct RoutineStats {
+  uint64_t runs = 0;          // completed tasks
+  uint64_t running = 0;       // tasks started but not finished
+  uint64_t run_ns = 0;        // time on a processor
+  uint64_t max_slice_ns = 0;  // longest stretch without a yield
+  uint64_t wait_ns = 0;       // runnable but not running: queued or yielded
+  uint64_t max_wait_ns = 0;
+  uint64_t yields = 0;
+  uint64_t migrations = 0;  // resumed on another processor thread
+  uint64_t cpu_moves = 0;   // resumed on another cpu
+};
+
+// One thread of the process as the kernel sees it, from
+// /proc/self/task/<tid>. Segar processors are ordinary threads.
+struct ThreadSample {
+  int tid = 0;
+  std::string name;
+  uint64_t cpu_ticks = 0;  // utime + stime
+  int last_cpu = -1;
+  int64_t nr_migrations = -1;  // -1 without CONFIG_SCHED_DEBUG
+  uint64_t voluntary_switches = 0;
+  uint64_t involuntary_switches = 0;
+};
+
+inline std::vector<ThreadSample> ReadThreadSamples() {
+  std::vector<ThreadSample> samples;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return samples;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+      continue;
+    }
+    const std::string base = std::string("/proc/self/task/") + entry->d_name;
+    ThreadSample sample;
+    sample.tid = std::atoi(entry->d_name);
+    std::ifstream stat(base + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) {
+      continue;
+    }
+    // The name may contain spaces and parentheses; fields follow the last
+    // ')'. utime, stime and processor are fields 14, 15 and 39.
+    const size_t open = line.find('(');
+    const size_t close = line.rfind(')');
+    if (open == std::string::npos || close == std::string::npos) {
+      continue;
+    }
+    sample.name = line.substr(open + 1, close - open - 1);
+    std::istringstream fields(line.substr(close + 2));
+    std::string field;
+    for (int index = 3; fields >> field; ++index) {
+      if (index == 14 || index == 15) {
+        sample.cpu_ticks += std::strtoull(field.c_str(), nullptr, 10);
+      } else if (index == 39) {
+        sample.last_cpu = std::atoi(field.c_str());
+        break;
+      }
+    }
+    std::ifstream status(base + "/status");
+    while (std::getline(status, line)) {
+      std::istringstream iss(line);
+      std::string key;
+      uint64_t value = 0;
+      if (!(iss >> key >> value)) {
+        continue;
+      }
+      if (key == "voluntary_ctxt_switches:") {
+        sample.voluntary_switches = value;
+      } else if (key == "nonvoluntary_ctxt_switches:") {
+        sample.involuntary_switches = value;
+      }
+    }
+    std::ifstream sched(base + "/sched");
+    while (std::getline(sched, line)) {
+      if (line.compare(0, 16, "se.nr_migrations") == 0) {
+        const size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+          sample.nr_migrations = std::atoll(line.c_str() + colon + 1);
+        }
+        break;
+      }
+    }
+    samples.push_back(std::move(sample));
+  }
+  closedir(dir);
+  std::sort(samples.begin(), samples.end(),
+            [](const ThreadSample& a, const ThreadSample& b) {
+              return a.tid < b.tid;
+            });
+  return samples;
+}
+
+// Per-routine accounting for Segar tasks: how long each named routine runs
+// on a processor, how long it is runnable without running, how often it
+// yields and whether it comes back on another processor. The Segar
+// scheduler does not report this, so the routines account for themselves:
+// start them through Execute / Async below and suspend them through
+// TaskStats::Yield and TaskStats::SleepFor. Any other suspension, e.g.
+// TaskEvent::Wait or a contended LockGuard, is counted as run time of the
+// routine.
+//
+// Coroutines interleave on a processor and may resume on another one, so
+// the running task is not tracked per thread. A body that yields takes its
+// Slice as first argument and hands it back to Yield / SleepFor.
+//
+// The accounting is a few atomic adds per start, yield and finish; the
+// registry lock is only taken when a routine name is first used and when a
+// report is made.
+class TaskStats {
+ private:
+  struct Entry;
+
+ public:
+  // The running stretch of one tracked task. Lives on the task's stack, so
+  // it moves with the coroutine.
+  class Slice {
+   private:
+    friend class TaskStats;
+    Entry* entry;
+    uint64_t start_ns;
+    long tid;
+    int cpu;
+  };
+
+  static TaskStats& Instance() {
+    static TaskStats instance;
+    return instance;
+  }
+
+  // Wraps fn so that each call is accounted to routine name. The time from
+  // wrapping to the start of the call counts as wait time, so wrap right
+  // before handing fn to the scheduler. fn is called with the Slice of the
+  // call first if it takes one.
+  template <typename Fn>
+  auto Wrap(const std::string& name, Fn fn) {
+    Entry* entry = Find(name);
+    const uint64_t submitted = MonotonicNs();
+    return [entry, submitted, fn = std::move(fn)](auto&&... args) mutable {
+      Scope scope(entry, submitted);
+      if constexpr (std::is_invocable_v<Fn&, Slice*, decltype(args)...>) {
+        return fn(scope.slice(), std::forward<decltype(args)>(args)...);
+      } else {
+        return fn(std::forward<decltype(args)>(args)...);
+      }
+    };
+  }
+
+  // rti::segar::Yield(), with the time until the task runs again counted
+  // as wait time.
+  static void Yield(Slice* slice) {
+    Suspend(slice);
+    slice->entry->yields.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t start = MonotonicNs();
+    rti::segar::Yield();
+    Resume(slice, MonotonicNs() - start);
+  }
+
+  // rti::segar::SleepFor(), the sleep counted neither as run nor as wait
+  // time.
+  template <typename Rep, typename Period>
+  static void SleepFor(Slice* slice,
+                       const std::chrono::duration<Rep, Period>& duration) {
+    Suspend(slice);
+    rti::segar::SleepFor(duration);
+    Resume(slice, 0);
+  }
+
+  std::vector<std::pair<std::string, RoutineStats>> Snapshot() const {
+    std::vector<std::pair<std::string, RoutineStats>> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& item : entries_) {
+      result.emplace_back(item.first, item.second->Load());
+    }
+    return result;
+  }
+
+  // Routine table and the utilization of every thread since the previous
+  // Report().
+  std::string Report() {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(2);
+    oss << "ROUTINE                   RUNS  ACTIVE    RUN_MS  MAX_SLICE_MS"
+           "   WAIT_MS  MAX_WAIT_MS  YIELDS  MIGR  CPU_MOVES\n";
+    auto routines = Snapshot();
+    std::sort(routines.begin(), routines.end(),
+              [](const auto& a, const auto& b) {
+                return a.second.run_ns > b.second.run_ns;
+              });
+    for (const auto& routine : routines) {
+      const RoutineStats& s = routine.second;
+      char row[192];
+      std::snprintf(row, sizeof(row),
+                    "%-24.24s %5llu %7llu %9.2f %13.2f %9.2f %12.2f %7llu "
+                    "%5llu %10llu\n",
+                    routine.first.c_str(),
+                    static_cast<unsigned long long>(s.runs),
+                    static_cast<unsigned long long>(s.running),
+                    s.run_ns / 1e6, s.max_slice_ns / 1e6, s.wait_ns / 1e6,
+                    s.max_wait_ns / 1e6,
+                    static_cast<unsigned long long>(s.yields),
+                    static_cast<unsigned long long>(s.migrations),
+                    static_cast<unsigned long long>(s.cpu_moves));
+      oss << row;
+    }
+    const uint64_t now = MonotonicNs();
+    auto threads = ReadThreadSamples();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const double interval_s = (now - last_report_ns_) / 1e9;
+    const double ticks_per_s = static_cast<double>(sysconf(_SC_CLK_TCK));
+    oss << "THREAD        TID   CPU%  LAST_CPU  MIGR  VCSW  NVCSW\n";
+    std::map<int, ThreadSample> previous;
+    for (auto& sample : last_threads_) {
+      previous[sample.tid] = sample;
+    }
+    for (const auto& sample : threads) {
+      const auto it = previous.find(sample.tid);
+      const ThreadSample before =
+          it == previous.end() ? ThreadSample() : it->second;
+      const double cpu_pct =
+          interval_s > 0
+              ? 100.0 * (sample.cpu_ticks - before.cpu_ticks) / ticks_per_s /
+                    interval_s
+              : 0.0;
+      char row[128];
+      std::snprintf(
+          row, sizeof(row), "%-12.12s %6d %6.1f %9d %5lld %5llu %6llu\n",
+          sample.name.c_str(), sample.tid, cpu_pct, sample.last_cpu,
+          static_cast<long long>(sample.nr_migrations < 0
+                                     ? -1
+                                     : sample.nr_migrations -
+                                           std::max<int64_t>(
+                                               before.nr_migrations, 0)),
+          static_cast<unsigned long long>(sample.voluntary_switches -
+                                          before.voluntary_switches),
+          static_cast<unsigned long long>(sample.involuntary_switches -
+                                          before.involuntary_switches));
+      oss << row;
+    }
+    last_threads_ = std::move(threads);
+    last_report_ns_ = now;
+    return oss.str();
+  }
+
+  // Writes Report() to path, replacing the file in one step so that a
+  // reader such as scripts/sched_top.sh never sees half a report.
+  bool Dump(const std::string& path) { return Write(path, Report()); }
+
+  // Default file scripts/sched_top.sh looks for.
+  static std::string DefaultDumpPath() {
+    return "/tmp/segar_task_stats." + std::to_string(getpid());
+  }
+
+  // Dumps every interval_s seconds to path and logs the report with AINFO
+  // if log is set. Calling it again replaces the previous schedule.
+  void StartReporting(uint32_t interval_s,
+                      const std::string& path = DefaultDumpPath(),
+                      bool log = false) {
+    auto timer = std::make_shared<rti::segar::Timer>(
+        interval_s * 1000,
+        [this, path, log]() {
+          const std::string report = Report();
+          if (!Write(path, report)) {
+            AWARN << "task_stats: cannot write " << path;
+          }
+          if (log) {
+            AINFO << "task_stats:\n" << report;
+          }
+        },
+        false);
+    timer->Start();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timer_) {
+      timer_->Stop();
+    }
+    timer_ = std::move(timer);
+  }
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> runs{0};
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> run_ns{0};
+    std::atomic<uint64_t> max_slice_ns{0};
+    std::atomic<uint64_t> wait_ns{0};
+    std::atomic<uint64_t> max_wait_ns{0};
+    std::atomic<uint64_t> yields{0};
+    std::atomic<uint64_t> migrations{0};
+    std::atomic<uint64_t> cpu_moves{0};
+
+    static void Max(std::atomic<uint64_t>* max, uint64_t value) {
+      uint64_t current = max->load(std::memory_order_relaxed);
+      while (value > current &&
+             !max->compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed)) {
+      }
+    }
+
+    void AddRun(uint64_t ns) {
+      run_ns.fetch_add(ns, std::memory_order_relaxed);
+      Max(&max_slice_ns, ns);
+    }
+
+    void AddWait(uint64_t ns) {
+      wait_ns.fetch_add(ns, std::memory_order_relaxed);
+      Max(&max_wait_ns, ns);
+    }
+
+    RoutineStats Load() const {
+      RoutineStats s;
+      s.runs = runs.load(std::memory_order_relaxed);
+      s.running = started.load(std::memory_order_relaxed) - s.runs;
+      s.run_ns = run_ns.load(std::memory_order_relaxed);
+      s.max_slice_ns = max_slice_ns.load(std::memory_order_relaxed);
+      s.wait_ns = wait_ns.load(std::memory_order_relaxed);
+      s.max_wait_ns = max_wait_ns.load(std::memory_order_relaxed);
+      s.yields = yields.load(std::memory_order_relaxed);
+      s.migrations = migrations.load(std::memory_order_relaxed);
+      s.cpu_moves = cpu_moves.load(std::memory_order_relaxed);
+      return s;
+    }
+  };
+
+  class Scope {
+   public:
+    Scope(Entry* entry, uint64_t submitted) {
+      entry->started.fetch_add(1, std::memory_order_relaxed);
+      slice_.entry = entry;
+      Begin(&slice_);
+      entry->AddWait(slice_.start_ns - std::min(submitted, slice_.start_ns));
+    }
+
+    ~Scope() {
+      slice_.entry->AddRun(MonotonicNs() - slice_.start_ns);
+      slice_.entry->runs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    Slice* slice() { return &slice_; }
+
+   private:
+    Slice slice_;
+  };
+
+  TaskStats() : last_report_ns_(MonotonicNs()) {
+    last_threads_ = ReadThreadSamples();
+  }
+
+  static void Begin(Slice* slice) {
+    slice->start_ns = MonotonicNs();
+    slice->tid = syscall(SYS_gettid);
+    slice->cpu = sched_getcpu();
+  }
+
+  static void Suspend(Slice* slice) {
+    slice->entry->AddRun(MonotonicNs() - slice->start_ns);
+  }
+
+  static void Resume(Slice* slice, uint64_t wait_ns) {
+    const long tid = slice->tid;
+    const int cpu = slice->cpu;
+    Begin(slice);
+    slice->entry->AddWait(wait_ns);
+    if (slice->tid != tid) {
+      slice->entry->migrations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (slice->cpu != cpu) {
+      slice->entry->cpu_moves.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  static bool Write(const std::string& path, const std::string& report) {
+    const std::string tmp = path + ".tmp";
+    {
+      std::ofstream file(tmp, std::ios::trunc);
+      file << "pid " << getpid() << " uptime " << MonotonicNs() / 1000000000ULL
+           << "s\n"
+           << report;
+      if (!file.good()) {
+        return false;
+      }
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+  }
+
+  Entry* Find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[name];
+    if (!entry) {
+      entry = std::make_unique<Entry>();
+    }
+    return entry.get();
+  }
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Entry>> entries_;
+  std::vector<ThreadSample> last_threads_;
+  uint64_t last_report_ns_;
+  std::shared_ptr<rti::segar::Timer> timer_;
+};
+
+// rti::segar::Execute / Async with the task accounted to routine name.
+template <typename Fn>
+void TrackedExecute(const std::string& name, Fn&& fn) {
+  rti::segar::Execute(TaskStats::Instance().Wrap(name, std::forward<Fn>(fn)));
+}
+
+template <typename Fn>
+auto TrackedAsync(const std::string& name, Fn&& fn) {
+  return rti::segar::Async(
+      TaskStats::Instance().Wrap(name, std::forward<Fn>(fn)));
+}
+
+}  // namespace common
+}  // namespace example
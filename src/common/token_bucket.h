@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "common/proc_stats.h"
+
+namespace example {
+namespace common {
+
+// Byte rate limiter: tokens refill at bytes_per_s up to burst_bytes, and
+// Acquire(n) blocks the calling thread until n tokens are available. A rate
+// of 0 disables the limit. Requests larger than the burst are let through
+// once the bucket is full and drive it into debt, so the average rate holds
+// for any request size.
+class TokenBucket {
+ public:
+  TokenBucket(uint64_t bytes_per_s, uint64_t burst_bytes)
+      : rate_(bytes_per_s),
+        burst_(std::max<uint64_t>(burst_bytes, 1)),
+        tokens_(static_cast<double>(burst_)),
+        last_ns_(MonotonicNs()) {}
+
+  bool limited() const { return rate_ != 0; }
+
+  // Returns the time spent waiting, in nanoseconds.
+  uint64_t Acquire(uint64_t bytes) {
+    if (rate_ == 0) {
+      return 0;
+    }
+    const uint64_t start = MonotonicNs();
+    const double need =
+        static_cast<double>(std::min<uint64_t>(bytes, burst_));
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      Refill(MonotonicNs());
+      if (tokens_ >= need) {
+        tokens_ -= static_cast<double>(bytes);
+        break;
+      }
+      const auto wait_ns =
+          static_cast<int64_t>((need - tokens_) * 1e9 / rate_) + 1;
+      lock.unlock();
+      std::this_thread::sleep_for(std::chrono::nanoseconds(wait_ns));
+      lock.lock();
+    }
+    const uint64_t waited = MonotonicNs() - start;
+    waited_ns_ += waited;
+    return waited;
+  }
+
+  // Takes the tokens if they are available, without waiting.
+  bool TryAcquire(uint64_t bytes) {
+    if (rate_ == 0) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill(MonotonicNs());
+    if (tokens_ < static_cast<double>(std::min<uint64_t>(bytes, burst_))) {
+      return false;
+    }
+    tokens_ -= static_cast<double>(bytes);
+    return true;
+  }
+
+  uint64_t waited_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waited_ns_;
+  }
+
+ private:
+  void Refill(uint64_t now) {
+    tokens_ = std::min(static_cast<double>(burst_),
+                       tokens_ + (now - last_ns_) * 1e-9 * rate_);
+    last_ns_ = now;
+  }
+
+  const uint64_t rate_;
+  const uint64_t burst_;
+  mutable std::mutex mutex_;
+  double tokens_;
+  uint64_t last_ns_;
+  uint64_t waited_ns_ = 0;
+};
+
+}  // namespace common
+}  // namespace example
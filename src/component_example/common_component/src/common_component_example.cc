@@ -8,13 +8,29 @@
 
 #include "common_component_example.h"
 
+#include "gflags/gflags.h"
+
+DEFINE_string(latency_stage, "timer_component->common_component",
+              "stage name used in latency logs and alerts");
+DEFINE_uint32(latency_budget_ms, 0,
+              "budget from the Image stamp to Proc, 0 only measures");
+DEFINE_uint32(latency_report_interval_s, 10,
+              "interval of the latency summary log, 0 disables it");
+
 bool CommonComponentExample::Init() {
   AINFO << "CommonComponentExample init";
+  example::common::LatencyBudget::Options options;
+  options.stage = FLAGS_latency_stage;
+  options.budget_ns = FLAGS_latency_budget_ms * 1000000ULL;
+  options.report_interval_s = FLAGS_latency_report_interval_s;
+  image_budget_ =
+      std::make_unique<example::common::LatencyBudget>(node_, options);
   return true;
 }
 
 bool CommonComponentExample::Proc(const std::shared_ptr<Image>& msg0,
                                   const std::shared_ptr<String>& msg1) {
+  image_budget_->Check(msg0->timestamp());
   AINFO << "Start common component Proc [msg0->width:" << msg0->width()
         << "] [msg1->data:" << msg1->data() << "]";
   return true;
@@ -6,6 +6,9 @@
  * for license terms and restrictions.
  *****************************************************************************/
 
+#include <memory>
+
+#include "common/latency_budget.h"
 #include "example/msg/Image.hpp"
 #include "example/msg/String.hpp"
 
@@ -18,5 +21,8 @@ class CommonComponentExample : public rti::segar::Component<Image, String> {
   bool Init() final;
   bool Proc(const std::shared_ptr<Image>& msg0,
             const std::shared_ptr<String>& msg1) final;
+
+ private:
+  std::unique_ptr<example::common::LatencyBudget> image_budget_;
 };
 SEGAR_REGISTER_COMPONENT(CommonComponentExample)
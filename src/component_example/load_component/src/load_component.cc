@@ -0,0 +1,373 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include "load_component.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/payload_integrity.h"
+#include "common/proc_stats.h"
+#include "common/sequence_tracker.h"
+#include "example/msg/Payload.hpp"
+#include "load_topology.h"
+
+DEFINE_string(load_config, "config/load_topology.json",
+              "topology, relative paths start at $SEGAR_PATH");
+DEFINE_string(load_sensors, "",
+              "comma separated sensor nodes published here, empty for all");
+DEFINE_string(load_compute, "",
+              "comma separated compute nodes run here, empty for all");
+DEFINE_uint32(load_seed, 1, "random seed of the publish jitter");
+DEFINE_uint32(load_report_interval_s, 5, "interval of the report log");
+DEFINE_string(load_output, "",
+              "markdown table of the sink, rewritten with every report");
+
+namespace {
+
+using example::msg::Payload;
+
+std::string ResolvePath(const std::string& path) {
+  const char* root = std::getenv("SEGAR_PATH");
+  if (path.empty() || path[0] == '/' || root == nullptr) {
+    return path;
+  }
+  return std::string(root) + "/" + path;
+}
+
+bool ReadSelected(LoadTopology* topology) {
+  std::string error;
+  if (!ReadLoadTopology(ResolvePath(FLAGS_load_config), topology, &error)) {
+    AERROR << "load: " << error;
+    return false;
+  }
+  const auto sensors = ParseNodeList(FLAGS_load_sensors);
+  const auto compute = ParseNodeList(FLAGS_load_compute);
+  auto& s = topology->sensors;
+  s.erase(std::remove_if(s.begin(), s.end(),
+                         [&sensors](const SensorConfig& sensor) {
+                           return !sensors.empty() &&
+                                  sensors.count(sensor.node) == 0;
+                         }),
+          s.end());
+  auto& c = topology->compute;
+  c.erase(std::remove_if(c.begin(), c.end(),
+                         [&compute](const ComputeConfig& node) {
+                           return !compute.empty() &&
+                                  compute.count(node.node) == 0;
+                         }),
+          c.end());
+  return true;
+}
+
+// Start time of this process, stamped into the first 8 data bytes of every
+// message so that the sink tells a restarted writer from a duplicate.
+uint64_t Incarnation() {
+  static const uint64_t incarnation = example::common::MonotonicNs();
+  return incarnation;
+}
+
+uint64_t StampedIncarnation(const Payload& msg) {
+  uint64_t incarnation = 0;
+  if (msg.data().size() >= sizeof(incarnation)) {
+    std::memcpy(&incarnation, msg.data().data(), sizeof(incarnation));
+  }
+  return incarnation;
+}
+
+std::shared_ptr<Payload> MakePayload(uint32_t id, uint32_t seq,
+                                     uint32_t bytes) {
+  auto msg = std::make_shared<Payload>();
+  msg->topic_id(id);
+  msg->sequence_number(seq);
+  msg->data_size(bytes);
+  msg->data().resize(bytes);
+  if (bytes >= sizeof(uint64_t)) {
+    const uint64_t incarnation = Incarnation();
+    std::memcpy(msg->data().data(), &incarnation, sizeof(incarnation));
+  }
+  msg->timestamp(example::common::MonotonicNs());
+  return msg;
+}
+
+class Sensor : public LoadNode {
+ public:
+  Sensor(const SensorConfig& config, uint32_t id, uint32_t seed, bool seal)
+      : config_(config),
+        id_(id),
+        seal_(seal),
+        period_ns_(static_cast<uint64_t>(1e9 / config.rate_hz)),
+        rng_(seed + id),
+        jitter_(-static_cast<int64_t>(config.jitter_us) * 1000,
+                static_cast<int64_t>(config.jitter_us) * 1000) {
+    node_ = rti::segar::CreateNode(config.node);
+    if (node_) {
+      writer_ = node_->CreateWriter<Payload>(config.topic);
+    }
+    const uint64_t now = example::common::MonotonicNs();
+    next_ns_ = now + period_ns_;
+    next_burst_ns_ = now + config.burst_every_s * 1000000000ULL;
+  }
+
+  bool IsValid() const { return writer_ != nullptr; }
+
+  void Tick(uint64_t now) override {
+    // A stall of more than a second is not made up for.
+    if (now > next_ns_ + 1000000000ULL) {
+      skipped_ += (now - next_ns_) / period_ns_;
+      next_ns_ = now;
+    }
+    while (now >= next_ns_) {
+      Publish();
+      const int64_t next = static_cast<int64_t>(period_ns_) + jitter_(rng_);
+      next_ns_ += static_cast<uint64_t>(std::max<int64_t>(next, 0));
+    }
+    if (config_.burst_every_s > 0 && now >= next_burst_ns_) {
+      for (uint32_t i = 0; i < config_.burst_count; ++i) {
+        Publish();
+      }
+      next_burst_ns_ = now + config_.burst_every_s * 1000000000ULL;
+    }
+  }
+
+  std::string Report() const override {
+    std::ostringstream oss;
+    oss << config_.node << " " << config_.topic << " sent=" << seq_
+        << " failed=" << failed_ << " skipped=" << skipped_;
+    return oss.str();
+  }
+
+ private:
+  void Publish() {
+    auto msg = MakePayload(id_, ++seq_, config_.bytes);
+    if (seal_) {
+      example::common::SealPayload(msg.get());
+    }
+    if (!writer_->Write(msg)) {
+      ++failed_;
+    }
+  }
+
+  const SensorConfig config_;
+  const uint32_t id_;
+  const bool seal_;
+  const uint64_t period_ns_;
+  std::mt19937 rng_;
+  std::uniform_int_distribution<int64_t> jitter_;
+  std::shared_ptr<rti::segar::Node> node_;
+  std::shared_ptr<rti::segar::Writer<Payload>> writer_;
+  uint64_t next_ns_ = 0;
+  uint64_t next_burst_ns_ = 0;
+  uint32_t seq_ = 0;
+  uint64_t failed_ = 0;
+  uint64_t skipped_ = 0;
+};
+
+class Compute : public LoadNode {
+ public:
+  Compute(const ComputeConfig& config, uint32_t id,
+          const std::set<std::string>& crc32c_topics)
+      : config_(config),
+        id_(id),
+        seal_output_(crc32c_topics.count(config.output) > 0),
+        inputs_(config.inputs.size()),
+        integrity_(config.inputs.size()) {
+    node_ = rti::segar::CreateNode(config.node);
+    if (!node_) {
+      return;
+    }
+    if (!config.output.empty()) {
+      writer_ = node_->CreateWriter<Payload>(config.output);
+      if (!writer_) {
+        return;
+      }
+    }
+    for (size_t i = 0; i < config.inputs.size(); ++i) {
+      std::function<void(const std::shared_ptr<Payload>&)> callback =
+          [this, i](const std::shared_ptr<Payload>& msg) {
+            OnMessage(i, *msg);
+          };
+      checked_.push_back(crc32c_topics.count(config.inputs[i]) > 0);
+      if (checked_[i]) {
+        callback = example::common::VerifiedCallback(std::move(callback),
+                                                     &integrity_[i]);
+      }
+      auto reader = node_->CreateReader<Payload>(config.inputs[i], callback);
+      if (!reader) {
+        return;
+      }
+      readers_.push_back(reader);
+    }
+  }
+
+  bool IsValid() const { return readers_.size() == config_.inputs.size(); }
+
+  std::string Report() const override {
+    std::ostringstream oss;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      std::istringstream writers(inputs_[i].Summary(1e6));
+      std::string line;
+      while (std::getline(writers, line)) {
+        oss << config_.node << " " << config_.inputs[i] << " " << line
+            << "\n";
+      }
+      if (checked_[i]) {
+        oss << config_.node << " " << config_.inputs[i]
+            << " crc32c checked=" << integrity_[i].checked.load()
+            << " corrupt=" << integrity_[i].corrupt.load() << "\n";
+      }
+    }
+    return oss.str();
+  }
+
+  void AppendRows(std::ostream* out) const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out->setf(std::ios::fixed);
+    out->precision(2);
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      const auto total = inputs_[i].Total();
+      *out << "| " << config_.node << " | " << config_.inputs[i] << " | "
+           << total.received << " | " << total.lost << " | "
+           << total.duplicates << " | " << total.reordered << " | "
+           << total.restarts << " | " << total.latency.Percentile(50) / 1e6
+           << " | " << total.latency.Percentile(99) / 1e6 << " | "
+           << total.latency.max() / 1e6 << " | "
+           << (checked_[i] ? std::to_string(integrity_[i].corrupt.load())
+                           : "-")
+           << " |\n";
+    }
+  }
+
+ private:
+  void OnMessage(size_t input, const Payload& msg) {
+    const uint64_t now = example::common::MonotonicNs();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      inputs_[input].Record(msg.topic_id(), msg.sequence_number(),
+                            now - msg.timestamp(), StampedIncarnation(msg));
+    }
+    const uint64_t until = now + config_.work_us * 1000ULL;
+    while (example::common::MonotonicNs() < until) {
+    }
+    if (input == 0 && writer_) {
+      auto output = MakePayload(id_, output_seq_.fetch_add(1) + 1,
+                                config_.output_bytes);
+      if (seal_output_) {
+        example::common::SealPayload(output.get());
+      }
+      writer_->Write(output);
+    }
+  }
+
+  const ComputeConfig config_;
+  const uint32_t id_;
+  const bool seal_output_;
+  mutable std::mutex mutex_;
+  // Per input, the writers told apart by topic_id.
+  std::vector<example::common::SequenceTracker> inputs_;
+  // Per input, filled only for crc32c_topics.
+  std::vector<bool> checked_;
+  std::vector<example::common::IntegrityStats> integrity_;
+  std::atomic<uint32_t> output_seq_{0};
+  std::shared_ptr<rti::segar::Node> node_;
+  std::shared_ptr<rti::segar::Writer<Payload>> writer_;
+  std::vector<std::shared_ptr<rti::segar::Reader<Payload>>> readers_;
+};
+
+void LogReport(const std::string& role,
+               const std::vector<std::shared_ptr<LoadNode>>& nodes) {
+  for (const auto& node : nodes) {
+    std::istringstream report(node->Report());
+    std::string line;
+    while (std::getline(report, line)) {
+      AINFO << "load_" << role << ": " << line;
+    }
+  }
+}
+
+}  // namespace
+
+bool LoadGeneratorComponent::Init() {
+  LoadTopology topology;
+  RETURN_VAL_IF(!ReadSelected(&topology), false);
+  for (size_t i = 0; i < topology.sensors.size(); ++i) {
+    auto sensor = std::make_shared<Sensor>(
+        topology.sensors[i], static_cast<uint32_t>(i), FLAGS_load_seed,
+        topology.crc32c_topics.count(topology.sensors[i].topic) > 0);
+    if (!sensor->IsValid()) {
+      AERROR << "load_generator: cannot publish "
+             << topology.sensors[i].topic;
+      return false;
+    }
+    sensors_.push_back(sensor);
+  }
+  AINFO << "load_generator: " << topology.name << " sensors="
+        << sensors_.size();
+  last_report_ns_ = example::common::MonotonicNs();
+  return true;
+}
+
+bool LoadGeneratorComponent::Proc() {
+  const uint64_t now = example::common::MonotonicNs();
+  for (const auto& sensor : sensors_) {
+    sensor->Tick(now);
+  }
+  if (now - last_report_ns_ >= FLAGS_load_report_interval_s * 1000000000ULL) {
+    last_report_ns_ = now;
+    LogReport("generator", sensors_);
+  }
+  return true;
+}
+
+bool LoadSinkComponent::Init() {
+  LoadTopology topology;
+  RETURN_VAL_IF(!ReadSelected(&topology), false);
+  for (size_t i = 0; i < topology.compute.size(); ++i) {
+    auto compute = std::make_shared<Compute>(
+        topology.compute[i], static_cast<uint32_t>(i), topology.crc32c_topics);
+    if (!compute->IsValid()) {
+      AERROR << "load_sink: cannot set up " << topology.compute[i].node;
+      return false;
+    }
+    compute_.push_back(compute);
+  }
+  AINFO << "load_sink: " << topology.name << " compute=" << compute_.size();
+  last_report_ns_ = example::common::MonotonicNs();
+  return true;
+}
+
+bool LoadSinkComponent::Proc() {
+  const uint64_t now = example::common::MonotonicNs();
+  if (now - last_report_ns_ < FLAGS_load_report_interval_s * 1000000000ULL) {
+    return true;
+  }
+  last_report_ns_ = now;
+  LogReport("sink", compute_);
+  if (!FLAGS_load_output.empty()) {
+    std::ofstream output(FLAGS_load_output, std::ios::trunc);
+    output << "| node | input | received | lost | duplicates | reordered "
+              "| restarts | p50 ms | p99 ms | max ms | corrupt |\n"
+           << "|---|---|---|---|---|---|---|---|---|---|---|\n";
+    for (const auto& node : compute_) {
+      node->AppendRows(&output);
+    }
+  }
+  return true;
+}
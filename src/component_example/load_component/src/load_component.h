@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "segar/class_loader/class_loader.h"
+#include "segar/component/component.h"
+#include "segar/component/timer_component.h"
+
+// Sensor or compute node of the topology, see load_component.cc.
+class LoadNode {
+ public:
+  virtual ~LoadNode() = default;
+  // Publishes what is due at `now`, for sensors.
+  virtual void Tick(uint64_t now) {}
+  virtual std::string Report() const = 0;
+  // Rows of the markdown report, for compute nodes.
+  virtual void AppendRows(std::ostream* out) const {}
+};
+
+// Publishes the sensors of the topology in --load_config, each from its own
+// node, at their rates and payload sizes with jitter and bursts. The timer
+// interval is the resolution of the publish times.
+class LoadGeneratorComponent : public rti::segar::TimerComponent {
+ public:
+  bool Init() final;
+  bool Proc() final;
+
+ private:
+  std::vector<std::shared_ptr<LoadNode>> sensors_;
+  uint64_t last_report_ns_ = 0;
+};
+SEGAR_REGISTER_COMPONENT(LoadGeneratorComponent)
+
+// Runs the compute nodes of the topology in --load_config: each subscribes
+// to its inputs, validates their sequence numbers, records their latency,
+// works for the configured time and publishes its output. The timer drives
+// the report.
+class LoadSinkComponent : public rti::segar::TimerComponent {
+ public:
+  bool Init() final;
+  bool Proc() final;
+
+ private:
+  std::vector<std::shared_ptr<LoadNode>> compute_;
+  uint64_t last_report_ns_ = 0;
+};
+SEGAR_REGISTER_COMPONENT(LoadSinkComponent)
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+// Synthetic topology of the load components, read from a JSON file:
+//
+// {
+//   "name": "...",
+//   "crc32c_topics": ["/load/camera_front"],
+//   "sensors": [{"node": "camera_front", "topic": "/load/camera_front",
+//                "rate_hz": 30, "bytes": 1048576, "jitter_us": 500,
+//                "burst_every_s": 0, "burst_count": 0}],
+//   "compute": [{"node": "fusion", "inputs": ["/load/a", "/load/b"],
+//                "work_us": 2000, "output": "/load/fusion",
+//                "output_bytes": 65536}]
+// }
+//
+// A sensor publishes `bytes` at `rate_hz`, every period moved by up to
+// `jitter_us` either way, and every `burst_every_s` adds `burst_count`
+// messages back to back. A compute node works `work_us` per message of any
+// input and publishes `output`, when it has one, per message of its first
+// input. Messages of `crc32c_topics` are sealed by their writer and checked
+// by their readers (common/payload_integrity.h).
+
+struct SensorConfig {
+  std::string node;
+  std::string topic;
+  double rate_hz = 10.0;
+  uint32_t bytes = 1024;
+  uint32_t jitter_us = 0;
+  uint32_t burst_every_s = 0;
+  uint32_t burst_count = 0;
+};
+
+struct ComputeConfig {
+  std::string node;
+  std::vector<std::string> inputs;
+  uint32_t work_us = 0;
+  std::string output;
+  uint32_t output_bytes = 1024;
+};
+
+struct LoadTopology {
+  std::string name;
+  std::vector<SensorConfig> sensors;
+  std::vector<ComputeConfig> compute;
+  std::set<std::string> crc32c_topics;
+};
+
+// Comma separated node names; empty selects every node.
+inline std::set<std::string> ParseNodeList(const std::string& list) {
+  std::set<std::string> nodes;
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (!item.empty()) {
+      nodes.insert(item);
+    }
+  }
+  return nodes;
+}
+
+// Reads item[key] into *value, leaving it unchanged when the key is absent.
+// json::value() would wrap a negative number or truncate a large one.
+inline bool ReadUint32Field(const nlohmann::json& item, const char* key,
+                            uint32_t* value, std::string* error) {
+  const auto it = item.find(key);
+  if (it == item.end()) {
+    return true;
+  }
+  if (!it->is_number_unsigned() || it->get<uint64_t>() > UINT32_MAX) {
+    *error = std::string(key) + " must be an integer from 0 to " +
+             std::to_string(UINT32_MAX) + ", got " + it->dump();
+    return false;
+  }
+  *value = it->get<uint32_t>();
+  return true;
+}
+
+inline bool ReadLoadTopology(const std::string& path, LoadTopology* topology,
+                             std::string* error) {
+  std::ifstream file(path);
+  if (!file) {
+    *error = "cannot open " + path;
+    return false;
+  }
+  try {
+    const auto root = nlohmann::json::parse(file);
+    topology->name = root.value("name", path);
+    for (const auto& topic :
+         root.value("crc32c_topics", std::vector<std::string>())) {
+      topology->crc32c_topics.insert(topic);
+    }
+    for (const auto& item : root.value("sensors", nlohmann::json::array())) {
+      SensorConfig sensor;
+      sensor.node = item.at("node").get<std::string>();
+      sensor.topic = item.at("topic").get<std::string>();
+      sensor.rate_hz = item.value("rate_hz", sensor.rate_hz);
+      std::string field_error;
+      if (!ReadUint32Field(item, "bytes", &sensor.bytes, &field_error) ||
+          !ReadUint32Field(item, "jitter_us", &sensor.jitter_us,
+                           &field_error) ||
+          !ReadUint32Field(item, "burst_every_s", &sensor.burst_every_s,
+                           &field_error) ||
+          !ReadUint32Field(item, "burst_count", &sensor.burst_count,
+                           &field_error)) {
+        *error = sensor.node + ": " + field_error;
+        return false;
+      }
+      // The sensor ticks every 1e9 / rate_hz ns, which must not round to 0.
+      if (!(sensor.rate_hz > 0.0 && sensor.rate_hz <= 1e9)) {
+        *error = sensor.node + ": rate_hz must be above 0 and at most 1e9";
+        return false;
+      }
+      topology->sensors.push_back(sensor);
+    }
+    for (const auto& item : root.value("compute", nlohmann::json::array())) {
+      ComputeConfig compute;
+      compute.node = item.at("node").get<std::string>();
+      compute.inputs = item.at("inputs").get<std::vector<std::string>>();
+      compute.output = item.value("output", std::string());
+      std::string field_error;
+      if (!ReadUint32Field(item, "work_us", &compute.work_us, &field_error) ||
+          !ReadUint32Field(item, "output_bytes", &compute.output_bytes,
+                           &field_error)) {
+        *error = compute.node + ": " + field_error;
+        return false;
+      }
+      if (compute.inputs.empty()) {
+        *error = compute.node + ": needs at least one input";
+        return false;
+      }
+      topology->compute.push_back(compute);
+    }
+  } catch (const nlohmann::json::exception& e) {
+    *error = path + ": " + e.what();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include "memory_monitor_component.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+
+#include "segar/parameter/segar_parameter_api.h"
+
+DEFINE_uint32(memory_budget_mb, 0, "memory budget of the process, 0 off");
+DEFINE_string(memory_policy, "drop_oldest",
+              "overflow policy: shrink_history, drop_oldest or "
+              "reject_charges");
+DEFINE_string(memory_estimates, "",
+              "comma separated node:name:kind:count:bytes accounts for memory "
+              "held by the runtime, e.g. a reader pending queue as "
+              "common:/topic/image:queue:5:6220800");
+DEFINE_string(memory_shm_nodes, "",
+              "comma separated pattern:node, a mapped SHM segment whose name "
+              "contains pattern is charged to node");
+DEFINE_uint32(memory_report_interval_s, 5, "interval of the report log");
+DEFINE_uint32(memory_ballast_kb, 0,
+              "test load: a block of this size is kept in a history every "
+              "tick, 0 off");
+DEFINE_uint32(memory_ballast_depth, 64, "depth of the test load history");
+
+namespace {
+
+// inner_node_name of config/memory_monitor.dag, the owner of its accounts.
+constexpr char kNodeName[] = "memory_monitor";
+// Owner of the SHM segments no --memory_shm_nodes pattern matches.
+const std::string kUnattributed = "unattributed";
+
+using example::common::MemoryBudget;
+using example::common::MemoryKind;
+
+// A decimal number filling all of text.
+bool ParseUint64(const std::string& text, uint64_t* value) {
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  *value = std::strtoull(text.c_str(), &end, 10);
+  return errno == 0 && *end == '\0';
+}
+
+// "node:name:kind:count:bytes", the name being a topic or anything else
+// without a colon.
+bool ParseEstimate(const std::string& item, MemoryBudget* budget,
+                   std::shared_ptr<MemoryBudget::Account>* account) {
+  std::vector<std::string> fields;
+  std::istringstream iss(item);
+  std::string field;
+  while (std::getline(iss, field, ':')) {
+    fields.push_back(field);
+  }
+  MemoryKind kind;
+  uint64_t count = 0;
+  uint64_t size = 0;
+  RETURN_VAL_IF(fields.size() != 5 || !ParseMemoryKind(fields[2], &kind) ||
+                    !ParseUint64(fields[3], &count) ||
+                    !ParseUint64(fields[4], &size) ||
+                    (size != 0 && count > UINT64_MAX / size),
+                false);
+  *account = budget->Register(fields[0], fields[1], kind);
+  (*account)->Set(count * size);
+  return true;
+}
+
+}  // namespace
+
+bool MemoryMonitorComponent::Init() {
+  auto& budget = MemoryBudget::Instance();
+  example::common::OverflowPolicy policy;
+  if (!example::common::ParseOverflowPolicy(FLAGS_memory_policy, &policy)) {
+    AERROR << "memory_monitor: unknown policy " << FLAGS_memory_policy;
+    return false;
+  }
+  budget.Configure(FLAGS_memory_budget_mb * 1024ULL * 1024ULL, policy);
+
+  std::istringstream iss(FLAGS_memory_estimates);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    std::shared_ptr<MemoryBudget::Account> account;
+    if (!ParseEstimate(item, &budget, &account)) {
+      AERROR << "memory_monitor: bad estimate " << item;
+      return false;
+    }
+    estimates_.push_back(account);
+  }
+  std::istringstream shm_nodes(FLAGS_memory_shm_nodes);
+  while (std::getline(shm_nodes, item, ',')) {
+    // Segment names may contain colons, node names do not.
+    const size_t colon = item.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+      AERROR << "memory_monitor: bad shm node " << item;
+      return false;
+    }
+    shm_nodes_.emplace_back(item.substr(0, colon), item.substr(colon + 1));
+  }
+  if (FLAGS_memory_ballast_kb > 0) {
+    ballast_ = std::make_unique<
+        example::common::BudgetedHistory<std::vector<char>>>(
+        kNodeName, "ballast", FLAGS_memory_ballast_depth,
+        [](const std::vector<char>& block) { return block.size(); });
+  }
+  last_report_ns_ = example::common::MonotonicNs();
+  AINFO << "memory_monitor: budget=" << FLAGS_memory_budget_mb
+        << "MB policy=" << FLAGS_memory_policy
+        << " estimates=" << estimates_.size();
+  return true;
+}
+
+bool MemoryMonitorComponent::Proc() {
+  auto& budget = MemoryBudget::Instance();
+  const auto stats = example::common::ReadProcessStats();
+  UpdateShm();
+  const uint64_t over = budget.Enforce(stats.rss_kb * 1024);
+  if (ballast_ != nullptr) {
+    // Touched, so the block counts in the RSS.
+    ballast_->Push(std::vector<char>(FLAGS_memory_ballast_kb * 1024, 1));
+  }
+  Publish(stats.rss_kb, over);
+
+  const uint64_t now = example::common::MonotonicNs();
+  if (now - last_report_ns_ >=
+      FLAGS_memory_report_interval_s * 1000000000ULL) {
+    last_report_ns_ = now;
+    AINFO << "memory_monitor: " << example::common::ToString(stats)
+          << " over=" << over / 1024 << "KB rejecting="
+          << budget.rejecting();
+    std::istringstream report(budget.Report());
+    std::string line;
+    while (std::getline(report, line)) {
+      AINFO << "memory_monitor: " << line;
+    }
+  }
+  return true;
+}
+
+// The runtime does not tell which node mapped a segment, so the owner comes
+// from the segment name, which the runtime derives from the channel.
+void MemoryMonitorComponent::UpdateShm() {
+  const auto segments = example::common::ReadShmSegments();
+  for (auto it = shm_.begin(); it != shm_.end();) {
+    // Unmapped: the account goes away with its bytes.
+    it = segments.count(it->first) > 0 ? std::next(it) : shm_.erase(it);
+  }
+  for (const auto& segment : segments) {
+    auto& account = shm_[segment.first];
+    if (!account) {
+      account = MemoryBudget::Instance().Register(
+          ShmOwner(segment.first), segment.first, MemoryKind::kShm);
+    }
+    account->Set(segment.second * 1024);
+  }
+}
+
+const std::string& MemoryMonitorComponent::ShmOwner(
+    const std::string& segment) const {
+  for (const auto& item : shm_nodes_) {
+    if (segment.find(item.first) != std::string::npos) {
+      return item.second;
+    }
+  }
+  return kUnattributed;
+}
+
+void MemoryMonitorComponent::Publish(uint64_t rss_kb, uint64_t over) {
+  const auto& budget = MemoryBudget::Instance();
+  const auto set = [this](const std::string& name, uint64_t value) {
+    Segar_Set_Local_Param(node_, "memory." + name, static_cast<int>(value));
+  };
+  set("budget_kb", budget.budget() / 1024);
+  set("rss_kb", rss_kb);
+  set("over_kb", over / 1024);
+  set("accounted_kb", budget.used() / 1024);
+  set("rejected", budget.rejected());
+  set("rejecting", budget.rejecting());
+  for (const auto& account : budget.Snapshot()) {
+    set(account.node + "." + account.name + "_kb", account.bytes / 1024);
+  }
+  Segar_Set_Local_Param(node_, "memory.report", budget.Report());
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/memory_budget.h"
+
+#include "segar/class_loader/class_loader.h"
+#include "segar/component/component.h"
+#include "segar/component/timer_component.h"
+
+// Enforces the memory budget of the process it is loaded into and reports
+// the per-node accounting, see docs/Segar_Benchmark.md section 19. Loaded
+// next to the components of a DAG it shares their MemoryBudget::Instance().
+// On every tick it measures the mapped SHM segments and the RSS, applies the
+// overflow policy when the RSS is over budget, and publishes the accounting
+// as parameters of its node, so `segar param list` shows it live.
+class MemoryMonitorComponent : public rti::segar::TimerComponent {
+ public:
+  bool Init() final;
+  bool Proc() final;
+
+ private:
+  void UpdateShm();
+  const std::string& ShmOwner(const std::string& segment) const;
+  void Publish(uint64_t rss_kb, uint64_t over);
+
+  // --memory_shm_nodes as (pattern, node).
+  std::vector<std::pair<std::string, std::string>> shm_nodes_;
+  // Per mapped segment, by name.
+  std::map<std::string,
+           std::shared_ptr<example::common::MemoryBudget::Account>>
+      shm_;
+  std::vector<std::shared_ptr<example::common::MemoryBudget::Account>>
+      estimates_;
+  std::unique_ptr<example::common::BudgetedHistory<std::vector<char>>>
+      ballast_;
+  uint64_t last_report_ns_ = 0;
+};
+SEGAR_REGISTER_COMPONENT(MemoryMonitorComponent)
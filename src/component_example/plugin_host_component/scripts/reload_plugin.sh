@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+# Install a new build of the plugin into the running plugin_host component
+# Usage: ./scripts/reload_plugin.sh <path/to/libimage_stats_plugin.so>
+# The library is copied next to the installed one and renamed over it, so
+# the host never sees a partly written file; it reloads within
+# --plugin_check_ms and logs the new generation
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+TARGET="$SCRIPT_DIR/../lib/libimage_stats_plugin.so"
+LIBRARY="${1:-}"
+
+if [ ! -f "$LIBRARY" ]; then
+  echo "Usage: $0 <path/to/libimage_stats_plugin.so>"
+  exit 1
+fi
+
+cp "$LIBRARY" "$TARGET.tmp"
+mv -f "$TARGET.tmp" "$TARGET"
+echo "Installed $LIBRARY, waiting for plugin_host to reload it"
@@ -0,0 +1,32 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "example/msg/Image.hpp"
+
+// Interface between PluginHostComponent and the library it reloads, see
+// common/hot_plugin.h. Change kInterfaceName with every change to this
+// class, a library built against another version is then refused.
+class ImagePlugin {
+ public:
+  static constexpr char kInterfaceName[] = "ImagePlugin/1";
+
+  virtual ~ImagePlugin() = default;
+
+  virtual bool Init() = 0;
+  virtual void Proc(const std::shared_ptr<example::msg::Image>& image) = 0;
+  // One line for the periodic log of the host.
+  virtual std::string Stats() const = 0;
+  // State handed from the old instance to the new one on a reload.
+  virtual std::string SaveState() const = 0;
+  virtual void RestoreState(const std::string& state) = 0;
+};
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Plugin loaded by PluginHostComponent: counts the images of
+// timer_component, the gaps in their sequence and their latency. Edit,
+// rebuild and install it while mainboard runs to see it reloaded.
+
+#include <sstream>
+
+#include "common/hot_plugin.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "image_plugin.h"
+
+namespace {
+
+// Shown in the stats, bump it to tell the versions apart in the log.
+constexpr char kVersion[] = "1";
+
+class ImageStatsPlugin : public ImagePlugin {
+ public:
+  bool Init() override { return true; }
+
+  void Proc(const std::shared_ptr<example::msg::Image>& image) override {
+    const int32_t width = image->width();
+    if (count_ > 0 && width != last_width_ + 1) {
+      ++gaps_;
+    }
+    last_width_ = width;
+    ++count_;
+    latency_.Record(example::common::MonotonicNs() - image->timestamp());
+  }
+
+  std::string Stats() const override {
+    std::ostringstream oss;
+    oss << "version=" << kVersion << " images=" << count_
+        << " gaps=" << gaps_ << " latency_ms{" << latency_.Summary(1e6)
+        << "}";
+    return oss.str();
+  }
+
+  // The latency histogram starts over with every version.
+  std::string SaveState() const override {
+    std::ostringstream oss;
+    oss << count_ << " " << gaps_ << " " << last_width_;
+    return oss.str();
+  }
+
+  void RestoreState(const std::string& state) override {
+    std::istringstream iss(state);
+    iss >> count_ >> gaps_ >> last_width_;
+  }
+
+ private:
+  uint64_t count_ = 0;
+  uint64_t gaps_ = 0;
+  int32_t last_width_ = 0;
+  example::common::LatencyHistogram latency_;
+};
+
+}  // namespace
+
+EXAMPLE_REGISTER_PLUGIN(ImagePlugin, ImageStatsPlugin)
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include "plugin_host_component.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+
+DEFINE_string(plugin_path, "lib/libimage_stats_plugin.so",
+              "plugin library, relative paths start at $SEGAR_PATH");
+DEFINE_uint32(plugin_check_ms, 500,
+              "interval of the check for a new library, 0 never reloads");
+DEFINE_uint32(plugin_report_interval_s, 5, "interval of the stats log");
+
+namespace {
+
+std::string ResolvePath(const std::string& path) {
+  const char* root = std::getenv("SEGAR_PATH");
+  if (path.empty() || path[0] == '/' || root == nullptr) {
+    return path;
+  }
+  return std::string(root) + "/" + path;
+}
+
+}  // namespace
+
+bool PluginHostComponent::Init() {
+  plugin_ = std::make_unique<example::common::HotPlugin<ImagePlugin>>(
+      ResolvePath(FLAGS_plugin_path));
+  std::string error;
+  if (!plugin_->Load(&error)) {
+    AERROR << "plugin_host: " << error;
+    return false;
+  }
+  AINFO << "plugin_host: loaded " << plugin_->path();
+  last_check_ns_ = last_report_ns_ = example::common::MonotonicNs();
+  return true;
+}
+
+bool PluginHostComponent::Proc(
+    const std::shared_ptr<example::msg::Image>& msg) {
+  const uint64_t now = example::common::MonotonicNs();
+  CheckReload(now);
+  plugin_->get()->Proc(msg);
+  if (now - last_report_ns_ >=
+      FLAGS_plugin_report_interval_s * 1000000000ULL) {
+    last_report_ns_ = now;
+    AINFO << "plugin_host: generation=" << plugin_->generation() << " "
+          << plugin_->get()->Stats();
+  }
+  return true;
+}
+
+void PluginHostComponent::CheckReload(uint64_t now) {
+  if (FLAGS_plugin_check_ms == 0 ||
+      now - last_check_ns_ < FLAGS_plugin_check_ms * 1000000ULL) {
+    return;
+  }
+  last_check_ns_ = now;
+  std::string error;
+  if (plugin_->ReloadIfChanged(&error)) {
+    AINFO << "plugin_host: reloaded " << plugin_->path() << " generation="
+          << plugin_->generation() << " in "
+          << (example::common::MonotonicNs() - now) / 1e6 << "ms";
+  } else if (!error.empty()) {
+    AERROR << "plugin_host: reload failed, keeping generation "
+           << plugin_->generation() << ": " << error;
+  }
+}
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <memory>
+
+#include "common/hot_plugin.h"
+#include "example/msg/Image.hpp"
+#include "image_plugin.h"
+
+#include "segar/class_loader/class_loader.h"
+#include "segar/component/component.h"
+
+// Component whose Proc() runs the ImagePlugin of a separate library and
+// reloads that library when it changes on disk, see docs/Segar_Benchmark.md
+// section 21. The component, its node and its readers stay as they are, so
+// changing the logic costs a library load instead of a mainboard restart.
+class PluginHostComponent
+    : public rti::segar::Component<example::msg::Image> {
+ public:
+  bool Init() final;
+  bool Proc(const std::shared_ptr<example::msg::Image>& msg) final;
+
+ private:
+  void CheckReload(uint64_t now);
+
+  std::unique_ptr<example::common::HotPlugin<ImagePlugin>> plugin_;
+  uint64_t last_check_ns_ = 0;
+  uint64_t last_report_ns_ = 0;
+};
+SEGAR_REGISTER_COMPONENT(PluginHostComponent)
@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+# Compare the cross-host traffic of N remote subscribers reading a topic
+# directly with the same subscribers behind one relay ingress
+# Usage: ./scripts/run_fanout_test.sh [bytes] [rate_hz] [seconds_per_run]
+# Two hosts are emulated on loopback: the publishing side runs with
+# SEGAR_IP=127.0.0.1, the subscribing side with SEGAR_IP=127.0.0.2, so
+# everything between them goes over RTPS and is counted by the lo interface
+# The results are collected in relay_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJ_DIR="$SCRIPT_DIR/../../../"
+BENCH_DIR="$PROJ_DIR/benchmark_example"
+REPORT="$SCRIPT_DIR/../relay_report.md"
+BYTES="${1:-256}"
+RATE_HZ="${2:-1000}"
+SECONDS_PER_RUN="${3:-20}"
+WARMUP_S=5
+
+for target in filter_talker filter_listener; do
+  if [ ! -x "$BENCH_DIR/$target/bin/$target" ]; then
+    echo "Error: $target not found: $BENCH_DIR/$target/bin/$target"
+    exit 1
+  fi
+done
+
+export LD_LIBRARY_PATH=$PROJ_DIR/third_party/lib:$PROJ_DIR/lib:$LD_LIBRARY_PATH
+export PATH=$PROJ_DIR/third_party/bin:$PATH
+export GLOG_log_dir="$PROJ_DIR/.segar/log"
+export GLOG_minloglevel=1
+export sysmo_start=0
+export SEGAR_DOMAIN_ID=0
+mkdir -p "$GLOG_log_dir"
+
+# Runs a benchmark_example program with its own config on the given host
+run_on() {
+  local ip=$1 target=$2
+  shift 2
+  SEGAR_IP=$ip SEGAR_PATH="$BENCH_DIR/$target" \
+    "$BENCH_DIR/$target/bin/$target" \
+    --flagfile="$BENCH_DIR/$target/config/$target.flag" "$@" \
+    > /dev/null 2>&1 &
+}
+
+stop_all() {
+  pkill -INT -x filter_talker 2>/dev/null || true
+  pkill -INT -x filter_listener 2>/dev/null || true
+  pkill -INT -x mainboard 2>/dev/null || true
+  while pgrep -x filter_talker > /dev/null ||
+        pgrep -x filter_listener > /dev/null ||
+        pgrep -x mainboard > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_all EXIT
+
+lo_bytes() {
+  cat /sys/class/net/lo/statistics/rx_bytes
+}
+
+if [ ! -f "$REPORT" ]; then
+  echo "| mode | listeners | bytes | rate_hz | cross-host MB/s |" > "$REPORT"
+  echo "|---|---|---|---|---|" >> "$REPORT"
+fi
+
+for listeners in 1 2 4 8; do
+  for mode in direct relay; do
+    echo "--- $mode, $listeners listeners, ${BYTES}B at ${RATE_HZ}Hz"
+    topic=/bench/camera
+    if [ "$mode" = relay ]; then
+      topic=/local/bench/camera
+      SEGAR_IP=127.0.0.1 bash "$SCRIPT_DIR/launch.sh" egress \
+        > /dev/null 2>&1 &
+      SEGAR_IP=127.0.0.2 bash "$SCRIPT_DIR/launch.sh" ingress \
+        > /dev/null 2>&1 &
+    fi
+    for ((i = 0; i < listeners; ++i)); do
+      run_on 127.0.0.2 filter_listener --topic=$topic
+    done
+    run_on 127.0.0.1 filter_talker --bytes=$BYTES --rate_hz=$RATE_HZ
+    sleep $WARMUP_S
+    before=$(lo_bytes)
+    sleep $((SECONDS_PER_RUN - WARMUP_S))
+    after=$(lo_bytes)
+    stop_all
+    awk -v m=$mode -v n=$listeners -v b=$BYTES -v r=$RATE_HZ \
+      -v d=$((after - before)) -v s=$((SECONDS_PER_RUN - WARMUP_S)) \
+      'BEGIN { printf "| %s | %d | %d | %d | %.2f |\n", m, n, b, r,
+               d / s / 1048576 }' >> "$REPORT"
+  done
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
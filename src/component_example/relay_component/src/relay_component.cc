@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include "relay_component.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#include "gflags/gflags.h"
+
+#include "common/example_pod_layouts.h"
+#include "common/message_batch.h"
+#include "common/proc_stats.h"
+#include "example/msg/Batch.hpp"
+#include "example/msg/CameraInfo.hpp"
+#include "example/msg/Image.hpp"
+#include "example/msg/Payload.hpp"
+#include "example/msg/String.hpp"
+#include "segar/task/task.h"
+
+DEFINE_string(relay_role, "egress",
+              "egress forwards local topics, ingress republishes them");
+DEFINE_string(relay_topics, "/bench/camera:Payload",
+              "comma separated topic:type, type one of Payload, String, "
+              "Image, CameraInfo");
+DEFINE_string(relay_prefix, "/relay", "prefix of the cross-host topics");
+DEFINE_string(relay_local_prefix, "/local",
+              "prefix of the topics the ingress role republishes on");
+DEFINE_uint32(relay_batch_bytes, 65536,
+              "batches are sent at this size, larger messages travel alone");
+DEFINE_uint32(relay_max_queued, 64,
+              "batches waiting to be sent, the oldest is dropped beyond");
+DEFINE_uint32(relay_report_interval_s, 5, "interval of the stats log");
+
+namespace {
+
+using example::msg::Batch;
+
+// Batches of one egress relay waiting to be sent. A single Segar task
+// publishes them in the order they were queued, so the reader callbacks
+// never block on the writer and the ingress side does not reorder.
+class Outbox {
+ public:
+  Outbox(std::shared_ptr<rti::segar::Writer<Batch>> writer, std::string topic)
+      : writer_(std::move(writer)),
+        topic_(std::move(topic)),
+        max_queued_(std::max<uint32_t>(FLAGS_relay_max_queued, 1)) {}
+
+  // The outbox is shared with the task so that it outlives the relay.
+  static void Enqueue(const std::shared_ptr<Outbox>& outbox,
+                      std::shared_ptr<Batch> batch) {
+    if (!batch) {
+      return;
+    }
+    {
+      rti::segar::LockGuard<std::mutex> lock(outbox->mutex_);
+      if (outbox->queue_.size() >= outbox->max_queued_) {
+        outbox->queue_.pop_front();
+        outbox->dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+      outbox->queue_.push_back(std::move(batch));
+      if (outbox->draining_) {
+        return;
+      }
+      outbox->draining_ = true;
+    }
+    rti::segar::Execute([outbox]() { outbox->Drain(); });
+  }
+
+  uint64_t sent() const { return sent_.load(); }
+  uint64_t sent_bytes() const { return sent_bytes_.load(); }
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  void Drain() {
+    for (;;) {
+      std::shared_ptr<Batch> batch;
+      {
+        rti::segar::LockGuard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+          draining_ = false;
+          return;
+        }
+        batch = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      sent_.fetch_add(1, std::memory_order_relaxed);
+      sent_bytes_.fetch_add(batch->data().size(), std::memory_order_relaxed);
+      AERROR_IF(!writer_->Write(batch))
+          << "relay: failed to forward " << topic_;
+    }
+  }
+
+  const std::shared_ptr<rti::segar::Writer<Batch>> writer_;
+  const std::string topic_;
+  const size_t max_queued_;
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> sent_bytes_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::mutex mutex_;
+  std::deque<std::shared_ptr<Batch>> queue_;  // guarded by mutex_
+  bool draining_ = false;                     // guarded by mutex_
+};
+
+// Local topic -> batches on the cross-host topic.
+template <typename T>
+class EgressRelay : public TopicRelay {
+ public:
+  EgressRelay(const std::shared_ptr<rti::segar::Node>& node,
+              const std::string& topic)
+      : topic_(topic), builder_(FLAGS_relay_batch_bytes) {
+    auto writer = node->CreateWriter<Batch>(FLAGS_relay_prefix + topic);
+    if (!writer) {
+      return;
+    }
+    outbox_ = std::make_shared<Outbox>(std::move(writer), topic);
+    reader_ = node->CreateReader<T>(
+        topic, [this](const std::shared_ptr<T>& msg) { OnMessage(msg); });
+  }
+
+  bool IsValid() const { return outbox_ && reader_; }
+
+  void Flush() override {
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    Send({builder_.Take()});
+  }
+
+  std::string Stats() const override {
+    std::ostringstream oss;
+    oss << topic_ << " in=" << received_.load()
+        << " batches=" << outbox_->sent() << " bytes=" << outbox_->sent_bytes()
+        << " dropped=" << outbox_->dropped();
+    return oss.str();
+  }
+
+ private:
+  void OnMessage(const std::shared_ptr<T>& msg) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t now = example::common::MonotonicNs();
+    if (builder_.IsLarge(*msg)) {
+      // Sent alone, after whatever was batched before it.
+      example::common::BatchBuilder<T> alone(FLAGS_relay_batch_bytes);
+      alone.Add(*msg, now);
+      rti::segar::LockGuard<std::mutex> lock(mutex_);
+      Send({builder_.Take(), alone.Take()});
+      return;
+    }
+    rti::segar::LockGuard<std::mutex> lock(mutex_);
+    if (builder_.Add(*msg, now)) {
+      Send({builder_.Take()});
+    }
+  }
+
+  // Queues batches just taken from builder_, with mutex_ held so that they
+  // are queued in the order they were taken.
+  void Send(std::initializer_list<std::shared_ptr<Batch>> batches) {
+    for (const auto& batch : batches) {
+      Outbox::Enqueue(outbox_, batch);
+    }
+  }
+
+  const std::string topic_;
+  std::mutex mutex_;
+  example::common::BatchBuilder<T> builder_;
+  std::atomic<uint64_t> received_{0};
+  std::shared_ptr<Outbox> outbox_;
+  std::shared_ptr<rti::segar::Reader<T>> reader_;
+};
+
+// Batches on the cross-host topic -> local topic.
+template <typename T>
+class IngressRelay : public TopicRelay {
+ public:
+  IngressRelay(const std::shared_ptr<rti::segar::Node>& node,
+               const std::string& topic)
+      : topic_(topic) {
+    writer_ = node->CreateWriter<T>(FLAGS_relay_local_prefix + topic);
+    reader_ = node->CreateReader<Batch>(
+        FLAGS_relay_prefix + topic,
+        [this](const std::shared_ptr<Batch>& batch) { OnBatch(batch); });
+  }
+
+  bool IsValid() const { return writer_ && reader_; }
+
+  void Flush() override {}
+
+  std::string Stats() const override {
+    std::ostringstream oss;
+    oss << topic_ << " batches=" << batches_.load()
+        << " out=" << delivered_.load() << " malformed=" << malformed_.load();
+    return oss.str();
+  }
+
+ private:
+  void OnBatch(const std::shared_ptr<Batch>& batch) {
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    const uint32_t delivered = example::common::ForEachInBatch<T>(
+        *batch, [this](const std::shared_ptr<T>& msg) {
+          AERROR_IF(!writer_->Write(msg))
+              << "relay: failed to republish " << topic_;
+        });
+    delivered_.fetch_add(delivered, std::memory_order_relaxed);
+    if (delivered != batch->count()) {
+      malformed_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  const std::string topic_;
+  std::atomic<uint64_t> batches_{0};
+  std::atomic<uint64_t> delivered_{0};
+  std::atomic<uint64_t> malformed_{0};
+  std::shared_ptr<rti::segar::Writer<T>> writer_;
+  std::shared_ptr<rti::segar::Reader<Batch>> reader_;
+};
+
+using RelayFactory = std::function<std::shared_ptr<TopicRelay>(
+    const std::shared_ptr<rti::segar::Node>&, const std::string&, bool)>;
+
+template <typename T>
+std::shared_ptr<TopicRelay> MakeRelay(
+    const std::shared_ptr<rti::segar::Node>& node, const std::string& topic,
+    bool egress) {
+  if (egress) {
+    auto relay = std::make_shared<EgressRelay<T>>(node, topic);
+    return relay->IsValid() ? relay : nullptr;
+  }
+  auto relay = std::make_shared<IngressRelay<T>>(node, topic);
+  return relay->IsValid() ? relay : nullptr;
+}
+
+const std::map<std::string, RelayFactory>& Factories() {
+  static const std::map<std::string, RelayFactory> factories = {
+      {"CameraInfo", MakeRelay<example::msg::CameraInfo>},
+      {"Image", MakeRelay<example::msg::Image>},
+      {"Payload", MakeRelay<example::msg::Payload>},
+      {"String", MakeRelay<example::msg::String>},
+  };
+  return factories;
+}
+
+}  // namespace
+
+bool RelayComponent::Init() {
+  RETURN_VAL_IF(FLAGS_relay_role != "egress" && FLAGS_relay_role != "ingress",
+                false);
+  const bool egress = FLAGS_relay_role == "egress";
+  std::istringstream iss(FLAGS_relay_topics);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    const size_t colon = item.rfind(':');
+    RETURN_VAL_IF(colon == std::string::npos, false);
+    const std::string topic = item.substr(0, colon);
+    const auto factory = Factories().find(item.substr(colon + 1));
+    if (factory == Factories().end()) {
+      AERROR << "relay: unsupported type in " << item;
+      return false;
+    }
+    auto relay = factory->second(node_, topic, egress);
+    RETURN_VAL_IF(!relay, false);
+    relays_.push_back(relay);
+    AINFO << "relay: " << FLAGS_relay_role << " " << topic;
+  }
+  RETURN_VAL_IF(relays_.empty(), false);
+  last_report_ns_ = example::common::MonotonicNs();
+  return true;
+}
+
+bool RelayComponent::Proc() {
+  const uint64_t now = example::common::MonotonicNs();
+  for (const auto& relay : relays_) {
+    relay->Flush();
+  }
+  if (now - last_report_ns_ >= FLAGS_relay_report_interval_s * 1000000000ULL) {
+    last_report_ns_ = now;
+    for (const auto& relay : relays_) {
+      AINFO << "relay: " << FLAGS_relay_role << " " << relay->Stats();
+    }
+  }
+  return true;
+}
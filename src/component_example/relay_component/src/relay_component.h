@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "segar/class_loader/class_loader.h"
+#include "segar/component/component.h"
+#include "segar/component/timer_component.h"
+
+// Relay of one topic, see relay_component.cc.
+class TopicRelay {
+ public:
+  virtual ~TopicRelay() = default;
+  // Publishes what is waiting for the next batch.
+  virtual void Flush() = 0;
+  virtual std::string Stats() const = 0;
+};
+
+// Bridges topics between hosts. On the sending host the egress role
+// subscribes to the topics over SHM and forwards them, small messages packed
+// into batches, on "<relay_prefix><topic>". On every receiving host one
+// ingress role subscribes to that topic, the only cross-host reader there,
+// and republishes the messages on "<relay_local_prefix><topic>" for the local
+// readers. The timer interval bounds how long a message waits in a batch.
+class RelayComponent : public rti::segar::TimerComponent {
+ public:
+  bool Init() final;
+  bool Proc() final;
+
+ private:
+  std::vector<std::shared_ptr<TopicRelay>> relays_;
+  uint64_t last_report_ns_ = 0;
+};
+SEGAR_REGISTER_COMPONENT(RelayComponent)
@@ -8,6 +8,8 @@
 
 #include "timer_component_example.h"
 
+#include "common/proc_stats.h"
+
 bool TimerComponentExample::Init() {
   image_writer_ = node_->CreateWriter<example::msg::Image>("/topic/image");
   RETURN_VAL_IF(!image_writer_, false);
@@ -17,6 +19,8 @@ bool TimerComponentExample::Init() {
 bool TimerComponentExample::Proc() {
   auto out_msg = std::make_shared<example::msg::Image>();
   out_msg->width(proc_count_++);
+  // Start of the pipeline: readers check their latency budget against it.
+  out_msg->timestamp(example::common::MonotonicNs());
   AINFO_IF(!image_writer_->Write(out_msg))
       << "Failed to write msg:" << out_msg->width();
   AINFO << "timer_component_example: Write image msg->width:"
@@ -0,0 +1,318 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Data-parallel image kernels on a 1920x1080 RGB frame: grayscale
+// conversion (ParallelTransform), a 256 bin histogram (ParallelReduce) and a
+// 5x5 box blur over rows (ParallelForRange), each run serially, on the Segar
+// task pool through src/common/parallel.h and, when built with OpenMP, with
+// "omp parallel for" at the same number of workers. The results of every
+// parallel run are compared with the serial ones.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/latency_histogram.h"
+#include "common/parallel.h"
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_uint32(width, 1920, "frame width in pixels");
+DEFINE_uint32(height, 1080, "frame height in pixels");
+DEFINE_string(workers, "8,28", "comma separated worker counts");
+DEFINE_uint32(iterations, 100, "runs per kernel, method and worker count");
+DEFINE_uint32(min_grain, 0,
+              "smallest chunk in pixels or rows, 0 lets parallel.h decide");
+DEFINE_string(methods, "serial,segar,openmp",
+              "comma separated: serial, segar, openmp");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+using Histogram = std::array<uint32_t, 256>;
+
+struct Rgb {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+struct Frame {
+  std::vector<Rgb> rgb;
+  std::vector<uint8_t> gray;
+  std::vector<uint8_t> blurred;
+  Histogram histogram;
+};
+
+constexpr int kBlurRadius = 2;
+
+uint8_t ToGray(const Rgb& p) {
+  return static_cast<uint8_t>((77 * p.r + 150 * p.g + 29 * p.b) >> 8);
+}
+
+Histogram CountRange(const uint8_t* gray, size_t first, size_t last,
+                     Histogram histogram) {
+  for (size_t i = first; i < last; ++i) {
+    ++histogram[gray[i]];
+  }
+  return histogram;
+}
+
+Histogram AddHistograms(Histogram a, const Histogram& b) {
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] += b[i];
+  }
+  return a;
+}
+
+// Box blur of rows [first, last), clamped at the borders.
+void BlurRows(const uint8_t* in, uint8_t* out, int width, int height,
+              size_t first, size_t last) {
+  constexpr int kArea = (2 * kBlurRadius + 1) * (2 * kBlurRadius + 1);
+  for (size_t y = first; y < last; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint32_t sum = 0;
+      for (int dy = -kBlurRadius; dy <= kBlurRadius; ++dy) {
+        const int sy = std::min(std::max(static_cast<int>(y) + dy, 0),
+                                height - 1);
+        for (int dx = -kBlurRadius; dx <= kBlurRadius; ++dx) {
+          const int sx = std::min(std::max(x + dx, 0), width - 1);
+          sum += in[static_cast<size_t>(sy) * width + sx];
+        }
+      }
+      out[y * width + x] = static_cast<uint8_t>(sum / kArea);
+    }
+  }
+}
+
+void RunSerial(Frame* frame, const std::string& kernel) {
+  const int width = static_cast<int>(FLAGS_width);
+  const int height = static_cast<int>(FLAGS_height);
+  if (kernel == "gray") {
+    std::transform(frame->rgb.begin(), frame->rgb.end(), frame->gray.begin(),
+                   ToGray);
+  } else if (kernel == "histogram") {
+    frame->histogram =
+        CountRange(frame->gray.data(), 0, frame->gray.size(), Histogram{});
+  } else {
+    BlurRows(frame->gray.data(), frame->blurred.data(), width, height, 0,
+             height);
+  }
+}
+
+void RunSegar(Frame* frame, const std::string& kernel, uint32_t workers) {
+  const int width = static_cast<int>(FLAGS_width);
+  const int height = static_cast<int>(FLAGS_height);
+  example::common::ParallelOptions options;
+  options.workers = workers;
+  if (kernel == "gray") {
+    options.min_grain = FLAGS_min_grain == 0 ? 4096 : FLAGS_min_grain;
+    example::common::ParallelTransform(frame->rgb.begin(), frame->rgb.end(),
+                                       frame->gray.begin(), ToGray, options);
+  } else if (kernel == "histogram") {
+    options.min_grain = FLAGS_min_grain == 0 ? 16384 : FLAGS_min_grain;
+    const uint8_t* gray = frame->gray.data();
+    frame->histogram = example::common::ParallelReduce(
+        0, frame->gray.size(), Histogram{},
+        [gray](size_t first, size_t last, Histogram acc) {
+          return CountRange(gray, first, last, acc);
+        },
+        AddHistograms, options);
+  } else {
+    options.min_grain = FLAGS_min_grain == 0 ? 4 : FLAGS_min_grain;
+    const uint8_t* in = frame->gray.data();
+    uint8_t* out = frame->blurred.data();
+    example::common::ParallelForRange(
+        0, height,
+        [=](size_t first, size_t last) {
+          BlurRows(in, out, width, height, first, last);
+        },
+        options);
+  }
+}
+
+#ifdef _OPENMP
+void RunOpenMp(Frame* frame, const std::string& kernel, uint32_t workers) {
+  const int width = static_cast<int>(FLAGS_width);
+  const int height = static_cast<int>(FLAGS_height);
+  const int64_t pixels = static_cast<int64_t>(frame->gray.size());
+  const int threads = static_cast<int>(workers);
+  if (kernel == "gray") {
+#pragma omp parallel for num_threads(threads) schedule(static)
+    for (int64_t i = 0; i < pixels; ++i) {
+      frame->gray[i] = ToGray(frame->rgb[i]);
+    }
+  } else if (kernel == "histogram") {
+    Histogram total{};
+#pragma omp parallel num_threads(threads)
+    {
+      Histogram local{};
+#pragma omp for schedule(static) nowait
+      for (int64_t i = 0; i < pixels; ++i) {
+        ++local[frame->gray[i]];
+      }
+#pragma omp critical
+      total = AddHistograms(total, local);
+    }
+    frame->histogram = total;
+  } else {
+#pragma omp parallel for num_threads(threads) schedule(static)
+    for (int y = 0; y < height; ++y) {
+      BlurRows(frame->gray.data(), frame->blurred.data(), width, height, y,
+               y + 1);
+    }
+  }
+}
+#endif
+
+bool ParseList(const std::string& list, std::vector<std::string>* items) {
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (!item.empty()) {
+      items->push_back(item);
+    }
+  }
+  return !items->empty();
+}
+
+bool SameResult(const Frame& a, const Frame& b, const std::string& kernel) {
+  if (kernel == "gray") {
+    return a.gray == b.gray;
+  }
+  if (kernel == "histogram") {
+    return a.histogram == b.histogram;
+  }
+  return a.blurred == b.blurred;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_width == 0 || FLAGS_height == 0, EXIT_FAILURE);
+  std::vector<std::string> workers_list;
+  std::vector<std::string> methods;
+  RETURN_VAL_IF(!ParseList(FLAGS_workers, &workers_list), EXIT_FAILURE);
+  RETURN_VAL_IF(!ParseList(FLAGS_methods, &methods), EXIT_FAILURE);
+
+  const size_t pixels = static_cast<size_t>(FLAGS_width) * FLAGS_height;
+  Frame reference;
+  reference.rgb.resize(pixels);
+  for (size_t i = 0; i < pixels; ++i) {
+    reference.rgb[i] = {static_cast<uint8_t>(i * 7),
+                        static_cast<uint8_t>(i * 13 + i / FLAGS_width),
+                        static_cast<uint8_t>(i / FLAGS_width * 3)};
+  }
+  reference.gray.resize(pixels);
+  reference.blurred.resize(pixels);
+  for (const char* kernel : {"gray", "histogram", "blur"}) {
+    RunSerial(&reference, kernel);
+  }
+
+  std::ofstream output;
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| kernel | method | workers | p50 ms | p99 ms | speedup "
+                "| cpu % |\n"
+             << "|---|---|---|---|---|---|---|\n";
+    }
+  }
+
+  // The loops run in a Segar task, as they would in a component's Proc.
+  auto run = rti::segar::Async([&]() {
+    std::map<std::string, double> serial_ms;
+    for (const char* kernel : {"gray", "histogram", "blur"}) {
+      for (const auto& method : methods) {
+        for (const auto& workers_item : workers_list) {
+          const uint32_t workers =
+              method == "serial"
+                  ? 1
+                  : static_cast<uint32_t>(std::stoul(workers_item));
+#ifndef _OPENMP
+          if (method == "openmp") {
+            AWARN << "parallel_bench: built without OpenMP, skipping it";
+            break;
+          }
+#endif
+          if (method != "serial" && method != "segar" &&
+              method != "openmp") {
+            AERROR << "parallel_bench: unknown method " << method;
+            return false;
+          }
+          Frame frame = reference;
+          example::common::LatencyHistogram times;
+          const auto cpu_before = example::common::ReadProcessStats();
+          const uint64_t start = example::common::MonotonicNs();
+          for (uint32_t i = 0; i < FLAGS_iterations; ++i) {
+            const uint64_t begin = example::common::MonotonicNs();
+            if (method == "serial") {
+              RunSerial(&frame, kernel);
+            } else if (method == "segar") {
+              RunSegar(&frame, kernel, workers);
+#ifdef _OPENMP
+            } else {
+              RunOpenMp(&frame, kernel, workers);
+#endif
+            }
+            times.Record(example::common::MonotonicNs() - begin);
+          }
+          const double elapsed_s =
+              (example::common::MonotonicNs() - start) / 1e9;
+          const double cpu_pct =
+              100.0 *
+              (example::common::ReadProcessStats().CpuSeconds() -
+               cpu_before.CpuSeconds()) /
+              elapsed_s;
+          if (!SameResult(frame, reference, kernel)) {
+            AERROR << "parallel_bench: " << kernel << " " << method
+                   << " differs from the serial result";
+            return false;
+          }
+          const double p50_ms = times.Percentile(50) / 1e6;
+          if (method == "serial") {
+            serial_ms[kernel] = p50_ms;
+          }
+          const double speedup =
+              serial_ms.count(kernel) != 0 && p50_ms > 0
+                  ? serial_ms[kernel] / p50_ms
+                  : 0.0;
+          AINFO << "parallel_bench: kernel=" << kernel
+                << " method=" << method << " workers=" << workers
+                << " ms{" << times.Summary(1e6) << "} speedup=" << speedup
+                << " cpu=" << cpu_pct << "%";
+          if (output.is_open()) {
+            output.setf(std::ios::fixed);
+            output.precision(2);
+            output << "| " << kernel << " | " << method << " | " << workers
+                   << " | " << p50_ms << " | "
+                   << times.Percentile(99) / 1e6 << " | " << speedup
+                   << " | " << cpu_pct << " |\n";
+          }
+          if (method == "serial") {
+            break;
+          }
+        }
+      }
+    }
+    return true;
+  });
+  return run.get() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Routines with different scheduling behaviour, accounted by TaskStats
+// (src/common/task_stats.h) while they share the processors of
+// segar.pb.conf:
+//   cooperative  busy for --slice_us, then TaskStats::Yield, in a loop
+//   hog          busy for --hog_ms without yielding, then sleeps as long;
+//                it shows up in MAX_SLICE_MS and in the waits of the others
+//   periodic     TaskStats::SleepFor(--period_ms), then a short busy step
+// The report is dumped for scripts/sched_top.sh and logged every
+// --report_interval_s, and once more at the end.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/proc_stats.h"
+#include "common/task_stats.h"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_uint32(duration_s, 30, "how long the routines run");
+DEFINE_uint32(cooperative, 8, "tasks of the cooperative routine");
+DEFINE_uint32(slice_us, 200, "busy time of the cooperative tasks per yield");
+DEFINE_uint32(hog_ms, 20, "busy time of the hog per step, 0 disables it");
+DEFINE_uint32(period_ms, 10, "sleep of the periodic routine per step");
+DEFINE_uint32(report_interval_s, 5, "interval of the report, 0 disables it");
+
+namespace {
+
+using example::common::TaskStats;
+
+void Work(uint64_t ns) {
+  const uint64_t until = example::common::MonotonicNs() + ns;
+  while (example::common::MonotonicNs() < until) {
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_slice_us == 0 || FLAGS_period_ms == 0, EXIT_FAILURE);
+
+  TaskStats& stats = TaskStats::Instance();
+  if (FLAGS_report_interval_s > 0) {
+    stats.StartReporting(FLAGS_report_interval_s,
+                         TaskStats::DefaultDumpPath(), true);
+  }
+  const uint64_t deadline =
+      example::common::MonotonicNs() + FLAGS_duration_s * 1000000000ULL;
+  auto running = [deadline]() {
+    return example::common::MonotonicNs() < deadline;
+  };
+
+  std::vector<std::future<void>> futures;
+  for (uint32_t i = 0; i < FLAGS_cooperative; ++i) {
+    futures.push_back(example::common::TrackedAsync(
+        "cooperative", [running](TaskStats::Slice* slice) {
+          while (running()) {
+            Work(FLAGS_slice_us * 1000ULL);
+            TaskStats::Yield(slice);
+          }
+        }));
+  }
+  if (FLAGS_hog_ms > 0) {
+    futures.push_back(example::common::TrackedAsync(
+        "hog", [running](TaskStats::Slice* slice) {
+          while (running()) {
+            Work(FLAGS_hog_ms * 1000000ULL);
+            TaskStats::SleepFor(slice,
+                                std::chrono::milliseconds(FLAGS_hog_ms));
+          }
+        }));
+  }
+  futures.push_back(example::common::TrackedAsync(
+      "periodic", [running](TaskStats::Slice* slice) {
+        while (running()) {
+          TaskStats::SleepFor(slice,
+                              std::chrono::milliseconds(FLAGS_period_ms));
+          Work(FLAGS_slice_us * 1000ULL);
+        }
+      }));
+  for (auto& future : futures) {
+    future.wait();
+  }
+
+  AINFO << "sched_stats: after " << FLAGS_duration_s << " s\n"
+        << stats.Report();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Many Segar tasks appending to one shared vector, as tasker does, with the
+// vector protected by LockGuard<std::mutex>, CoMutex or CoSemaphore, or fed
+// through a BoundedChannel to a single appending task. With the default
+// segar.pb.conf (routine_num 96, default_proc_num 5) 96 coroutines share
+// 5 processors. Reports throughput, the time to get access and CPU usage.
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/co_sync.h"
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_uint32(tasks, 96, "concurrent tasks");
+DEFINE_uint32(appends, 10000, "appends per task");
+DEFINE_uint32(work_ns, 200, "time spent inside the critical section");
+DEFINE_string(modes, "lockguard,comutex,semaphore,channel",
+              "comma separated: lockguard, comutex, semaphore, channel");
+DEFINE_uint32(channel_capacity, 256, "capacity of the channel mode");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+namespace {
+
+struct Entry {
+  uint32_t task;
+  uint32_t index;
+};
+
+void Work(uint32_t ns) {
+  const uint64_t until = example::common::MonotonicNs() + ns;
+  while (example::common::MonotonicNs() < until) {
+  }
+}
+
+// Runs body(task, histogram) in FLAGS_tasks Segar tasks and waits for all.
+template <typename Body>
+void RunTasks(Body body,
+              std::vector<example::common::LatencyHistogram>* histograms) {
+  std::vector<std::future<void>> futures;
+  for (uint32_t t = 0; t < FLAGS_tasks; ++t) {
+    auto* histogram = &(*histograms)[t];
+    futures.push_back(
+        rti::segar::Async([t, histogram, &body]() { body(t, histogram); }));
+  }
+  for (auto& future : futures) {
+    future.wait();
+  }
+}
+
+// Appends under a lock; the histogram gets the time to acquire it.
+template <typename Lock>
+void AppendUnder(Lock lock, uint32_t task,
+                 example::common::LatencyHistogram* histogram,
+                 std::vector<Entry>* shared) {
+  for (uint32_t i = 0; i < FLAGS_appends; ++i) {
+    const uint64_t start = example::common::MonotonicNs();
+    lock([&]() {
+      histogram->Record(example::common::MonotonicNs() - start);
+      shared->push_back({task, i});
+      Work(FLAGS_work_ns);
+    });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_tasks == 0, EXIT_FAILURE);
+
+  std::ofstream output;
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    output.open(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| mode | tasks | work ns | appends/s | p50 wait us "
+                "| p99 wait us | max wait us | suspended | cpu % |\n"
+             << "|---|---|---|---|---|---|---|---|---|\n";
+    }
+  }
+
+  std::istringstream modes(FLAGS_modes);
+  std::string mode;
+  while (std::getline(modes, mode, ',')) {
+    std::vector<Entry> shared;
+    shared.reserve(static_cast<size_t>(FLAGS_tasks) * FLAGS_appends);
+    std::vector<example::common::LatencyHistogram> histograms(FLAGS_tasks);
+    uint64_t suspended = 0;
+    const auto cpu_before = example::common::ReadProcessStats();
+    const uint64_t start = example::common::MonotonicNs();
+    if (mode == "lockguard") {
+      std::mutex mutex;
+      RunTasks(
+          [&](uint32_t task, example::common::LatencyHistogram* histogram) {
+            AppendUnder(
+                [&](const auto& critical) {
+                  rti::segar::LockGuard<std::mutex> lock(mutex);
+                  critical();
+                },
+                task, histogram, &shared);
+          },
+          &histograms);
+    } else if (mode == "comutex") {
+      example::common::CoMutex mutex;
+      RunTasks(
+          [&](uint32_t task, example::common::LatencyHistogram* histogram) {
+            AppendUnder(
+                [&](const auto& critical) {
+                  std::lock_guard<example::common::CoMutex> lock(mutex);
+                  critical();
+                },
+                task, histogram, &shared);
+          },
+          &histograms);
+      suspended = mutex.contended();
+    } else if (mode == "semaphore") {
+      example::common::CoSemaphore semaphore(1);
+      RunTasks(
+          [&](uint32_t task, example::common::LatencyHistogram* histogram) {
+            AppendUnder(
+                [&](const auto& critical) {
+                  semaphore.Acquire();
+                  critical();
+                  semaphore.Release();
+                },
+                task, histogram, &shared);
+          },
+          &histograms);
+    } else if (mode == "channel") {
+      // Only the collector touches the vector; the histogram gets the time
+      // Send takes, i.e. waiting for room in the channel.
+      example::common::BoundedChannel<Entry> channel(FLAGS_channel_capacity);
+      auto collector = rti::segar::Async([&]() {
+        Entry entry;
+        while (channel.Recv(&entry)) {
+          shared.push_back(entry);
+          Work(FLAGS_work_ns);
+        }
+      });
+      RunTasks(
+          [&](uint32_t task, example::common::LatencyHistogram* histogram) {
+            for (uint32_t i = 0; i < FLAGS_appends; ++i) {
+              const uint64_t begin = example::common::MonotonicNs();
+              channel.Send({task, i});
+              histogram->Record(example::common::MonotonicNs() - begin);
+            }
+          },
+          &histograms);
+      channel.Close();
+      collector.wait();
+    } else {
+      AERROR << "sync_bench: unknown mode " << mode;
+      return EXIT_FAILURE;
+    }
+    const double elapsed_s = (example::common::MonotonicNs() - start) / 1e9;
+    const double cpu_pct = 100.0 *
+                           (example::common::ReadProcessStats().CpuSeconds() -
+                            cpu_before.CpuSeconds()) /
+                           elapsed_s;
+    RETURN_VAL_IF(shared.size() !=
+                      static_cast<size_t>(FLAGS_tasks) * FLAGS_appends,
+                  EXIT_FAILURE);
+    example::common::LatencyHistogram wait;
+    for (const auto& histogram : histograms) {
+      wait.Merge(histogram);
+    }
+    const double appends_per_s = shared.size() / elapsed_s;
+    AINFO << "sync_bench: mode=" << mode << " tasks=" << FLAGS_tasks
+          << " appends/s=" << appends_per_s << " wait_us{" << wait.Summary()
+          << "} suspended=" << suspended << " cpu=" << cpu_pct << "%";
+    if (output.is_open()) {
+      output.setf(std::ios::fixed);
+      output.precision(2);
+      output << "| " << mode << " | " << FLAGS_tasks << " | "
+             << FLAGS_work_ns << " | " << appends_per_s << " | "
+             << wait.Percentile(50) / 1000.0 << " | "
+             << wait.Percentile(99) / 1000.0 << " | " << wait.max() / 1000.0
+             << " | " << suspended << " | " << cpu_pct << " |\n";
+    }
+  }
+  return EXIT_SUCCESS;
+}
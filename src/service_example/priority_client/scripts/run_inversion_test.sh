@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Priority inversion test: priority_server with one worker is saturated by
+# --concurrency bulk callers at priority 0 while one caller at priority 3
+# sends a request every 20 ms; once with the server admitting in arrival
+# order (fifo) and once by request priority
+# Usage: ./scripts/run_inversion_test.sh [bulk_callers] [seconds_per_run]
+# The results are collected in inversion_report.md next to the scripts directory
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SERVER_LAUNCH="$SCRIPT_DIR/../../priority_server/scripts/launch.sh"
+REPORT="$SCRIPT_DIR/../inversion_report.md"
+BULK="${1:-4}"
+SECONDS_PER_RUN="${2:-20}"
+
+if [ ! -f "$SERVER_LAUNCH" ]; then
+  echo "Error: priority_server not found: $SERVER_LAUNCH"
+  exit 1
+fi
+rm -f "$REPORT"
+
+stop_all() {
+  pkill -INT -x priority_client 2>/dev/null || true
+  pkill -INT -x priority_server 2>/dev/null || true
+  while pgrep -x priority_server > /dev/null ||
+    pgrep -x priority_client > /dev/null; do
+    sleep 0.5
+  done
+}
+trap stop_all EXIT
+
+for mode in fifo priority; do
+  echo "--- server $mode, $BULK bulk callers"
+  bash "$SERVER_LAUNCH" --mode=$mode --workers=1 > /dev/null 2>&1 &
+  sleep 2
+  # The bulk load outlasts the measured run on both ends.
+  bash "$SCRIPT_DIR/launch.sh" --priority=0 --concurrency="$BULK" \
+    --work_us=2000 --duration_s=$((SECONDS_PER_RUN + 6)) \
+    --label="$mode" --output="$REPORT" > /dev/null 2>&1 &
+  bulk_pid=$!
+  sleep 3
+  bash "$SCRIPT_DIR/launch.sh" --priority=3 --rate_hz=50 --work_us=200 \
+    --duration_s="$SECONDS_PER_RUN" --label="$mode" --output="$REPORT" ||
+    true
+  wait "$bulk_pid" || true
+  stop_all
+done
+
+echo "Report: $REPORT"
+cat "$REPORT"
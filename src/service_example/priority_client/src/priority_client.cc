@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Client of the priority inversion test: --concurrency Segar tasks, each
+// with its own client, call priority_server with SyncSendRequest, tagging
+// every request with --priority. A few tasks back to back at priority 0
+// saturate the server; one task at a high priority and a fixed rate
+// measures what a high priority caller sees.
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "common/latency_histogram.h"
+#include "common/proc_stats.h"
+#include "example/srv/PrioritizedWork.hpp"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_string(service, "prioritized_work", "service name");
+DEFINE_uint32(priority, 0, "priority of the caller, 0-255, higher first");
+DEFINE_uint32(concurrency, 1, "callers, each with its own client");
+DEFINE_uint32(rate_hz, 0, "requests per second per caller, 0 back to back");
+DEFINE_uint32(work_us, 200, "service time asked for per request");
+DEFINE_uint32(duration_s, 20, "measuring time");
+DEFINE_uint32(warmup, 10, "requests per caller before measuring");
+DEFINE_string(label, "", "run label written to the report, e.g. the mode");
+DEFINE_string(output, "", "markdown table the results are appended to");
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_priority > 255 || FLAGS_concurrency == 0,
+                EXIT_FAILURE);
+
+  auto node = rti::segar::CreateNode("priority_client_" +
+                                     std::to_string(FLAGS_priority));
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+
+  using PrioritizedWork = example::srv::PrioritizedWork;
+  std::mutex mutex;
+  example::common::LatencyHistogram rtt;
+  example::common::LatencyHistogram queued;
+  std::atomic<uint64_t> failed{0};
+  const uint64_t period_ns =
+      FLAGS_rate_hz == 0 ? 0 : 1000000000ULL / FLAGS_rate_hz;
+
+  auto caller = [&]() {
+    auto client = node->CreateClient<PrioritizedWork>(FLAGS_service);
+    if (!client) {
+      failed.fetch_add(1);
+      return;
+    }
+    auto call = [&](bool record) {
+      auto request = std::make_shared<PrioritizedWork::Request>();
+      request->priority(static_cast<uint8_t>(FLAGS_priority));
+      request->work_us(FLAGS_work_us);
+      request->timestamp(example::common::MonotonicNs());
+      auto response = client->SyncSendRequest(request);
+      if (!record) {
+        return;
+      }
+      if (response == nullptr || !response->success()) {
+        failed.fetch_add(1);
+        return;
+      }
+      const uint64_t now = example::common::MonotonicNs();
+      std::lock_guard<std::mutex> lock(mutex);
+      rtt.Record(now - request->timestamp());
+      queued.Record(response->queued_ns());
+    };
+    for (uint32_t i = 0; i < FLAGS_warmup; ++i) {
+      call(false);
+    }
+    const uint64_t start = example::common::MonotonicNs();
+    const uint64_t end = start + FLAGS_duration_s * 1000000000ULL;
+    for (uint64_t i = 0;; ++i) {
+      const uint64_t now = example::common::MonotonicNs();
+      if (now >= end) {
+        break;
+      }
+      if (period_ns != 0 && start + i * period_ns > now) {
+        rti::segar::SleepFor(
+            std::chrono::nanoseconds(start + i * period_ns - now));
+      }
+      call(true);
+    }
+  };
+  std::vector<std::future<void>> callers;
+  for (uint32_t c = 0; c < FLAGS_concurrency; ++c) {
+    callers.push_back(rti::segar::Async(caller));
+  }
+  for (auto& future : callers) {
+    future.wait();
+  }
+
+  AINFO << "priority_client: " << FLAGS_label
+        << " priority=" << FLAGS_priority
+        << " concurrency=" << FLAGS_concurrency
+        << " rate_hz=" << FLAGS_rate_hz << " rtt_ms{" << rtt.Summary(1e6)
+        << "} queued_ms{" << queued.Summary(1e6)
+        << "} failed=" << failed.load();
+  if (!FLAGS_output.empty()) {
+    const bool is_new = !std::ifstream(FLAGS_output).good();
+    std::ofstream output(FLAGS_output, std::ios::app);
+    if (is_new) {
+      output << "| run | priority | callers | rate_hz | requests | p50 ms "
+                "| p99 ms | max ms | p99 queued ms | failed |\n"
+             << "|---|---|---|---|---|---|---|---|---|---|\n";
+    }
+    output.setf(std::ios::fixed);
+    output.precision(2);
+    output << "| " << FLAGS_label << " | " << FLAGS_priority << " | "
+           << FLAGS_concurrency << " | " << FLAGS_rate_hz << " | "
+           << rtt.count() << " | " << rtt.Percentile(50) / 1e6 << " | "
+           << rtt.Percentile(99) / 1e6 << " | " << rtt.max() / 1e6 << " | "
+           << queued.Percentile(99) / 1e6 << " | " << failed.load()
+           << " |\n";
+  }
+  return EXIT_SUCCESS;
+}
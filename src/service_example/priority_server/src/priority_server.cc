@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (c) 2022-2026 SEGAR. All Rights Reserved.
+ * SPDX-License-Identifier: LicenseRef-Segar-Proprietary
+ *
+ * PROPRIETARY AND CONFIDENTIAL. See ./LICENSE
+ * for license terms and restrictions.
+ *****************************************************************************/
+
+// Server of the priority inversion test: serves PrioritizedWork requests by
+// spinning for the requested time with at most --workers requests at once.
+// With --mode=priority waiting requests are admitted by the priority their
+// caller put in the request, with --mode=fifo in arrival order.
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "common/latency_histogram.h"
+#include "common/priority_gate.h"
+#include "common/proc_stats.h"
+#include "example/srv/PrioritizedWork.hpp"
+
+#include "segar/segar.h"
+#include "segar/task/task.h"
+
+DEFINE_string(service, "prioritized_work", "service name");
+DEFINE_string(mode, "priority", "admission order: priority or fifo");
+DEFINE_uint32(workers, 1, "requests served at the same time");
+DEFINE_uint32(report_interval_s, 5, "interval of the queueing summary");
+
+namespace {
+
+void Work(uint32_t us) {
+  const uint64_t until = example::common::MonotonicNs() + us * 1000ULL;
+  while (example::common::MonotonicNs() < until) {
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RETURN_VAL_IF(!rti::segar::Init(argv[0]), EXIT_FAILURE);
+  RETURN_VAL_IF(FLAGS_mode != "priority" && FLAGS_mode != "fifo",
+                EXIT_FAILURE);
+  const bool by_priority = FLAGS_mode == "priority";
+
+  auto node = rti::segar::CreateNode("priority_server");
+  RETURN_VAL_IF(!node, EXIT_FAILURE);
+
+  example::common::PriorityGate gate(FLAGS_workers);
+  std::mutex stats_mutex;
+  std::map<uint8_t, example::common::LatencyHistogram> queued;
+
+  using PrioritizedWork = example::srv::PrioritizedWork;
+  auto callback =
+      [&](const std::shared_ptr<PrioritizedWork::Request>& request,
+          std::shared_ptr<PrioritizedWork::Response>& response) {
+        // In fifo mode every request enters at the same priority, which
+        // leaves the arrival order.
+        auto ticket = gate.Enter(by_priority ? request->priority() : 0);
+        Work(request->work_us());
+        response->success(true);
+        response->queued_ns(ticket.queued_ns());
+        rti::segar::LockGuard<std::mutex> lock(stats_mutex);
+        queued[request->priority()].Record(ticket.queued_ns());
+      };
+  auto service =
+      node->CreateService<PrioritizedWork>(FLAGS_service, callback);
+  RETURN_VAL_IF(!service, EXIT_FAILURE);
+
+  auto report = [&]() {
+    rti::segar::LockGuard<std::mutex> lock(stats_mutex);
+    for (auto& item : queued) {
+      AINFO << "priority_server: mode=" << FLAGS_mode
+            << " priority=" << static_cast<int>(item.first) << " queued_ms{"
+            << item.second.Summary(1e6) << "}";
+      item.second.Reset();
+    }
+  };
+  auto timer = std::make_shared<rti::segar::Timer>(
+      FLAGS_report_interval_s * 1000, report, false);
+  if (FLAGS_report_interval_s > 0) {
+    timer->Start();
+  }
+
+  AINFO << "priority_server: mode=" << FLAGS_mode
+        << " workers=" << FLAGS_workers << ", waiting for requests...";
+  rti::segar::WaitForShutdown();
+  AINFO << "priority_server: requests that waited for a worker="
+        << gate.queued();
+  return EXIT_SUCCESS;
+}